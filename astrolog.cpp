@@ -87,7 +87,10 @@ void InitColors(void)
     kObjA[i] = k;
   }
 
-  // Determine and assign the color of each star.
+  // Determine and assign the color of each star. Getting star magnitudes
+  // may mean reading the star catalog, so skip it if stars can't appear.
+  if (!us.fStar && !us.fGraphics)
+    return;
   EnsureStarBright();
   k = kObjU[starLo];
   for (i = starLo; i <= starHi; i++)
@@ -114,14 +117,15 @@ void Action(void)
       sprintf(sz, "File %s can not be created.", is.szFileScreen);
       PrintError(sz);
       is.S = stdout;
-    }
+    } else
+      setvbuf(is.S, NULL, _IOFBF, cbPrintBuf);
   } else
     is.S = stdout;
   is.cchRow = is.cchCol = is.cchColMax = 0;
 
   // If the -kh switch is in effect, start outputting a new HTML file.
 
-  fHTML = us.fTextHTML && !us.fGraphics && is.S != stdout;
+  fHTML = us.fTextHTML && !us.fTextJSON && !us.fGraphics && is.S != stdout;
   if (fHTML) {
     fHTMLClip = is.nHTML < 0;
     is.nHTML = 2;
@@ -140,7 +144,7 @@ void Action(void)
   } else
     is.nHTML = 0;
 
-  if (us.nCharsetOut == ccUTF8 && is.S != stdout)
+  if (us.nCharsetOut == ccUTF8 && is.S != stdout && !us.fTextJSON)
     fprintf(is.S, "%c%c%c", 0xef, 0xbb, 0xbf);
 
   // If the -5e switch is in effect, loop over all charts in chart list.
@@ -167,6 +171,12 @@ LNextLine:
     FProcessCommandLine(is.rgszLine[iLine]);
   is.fMult = fFalse;
   is.fNoEphFile = fFalse;
+#ifdef GRAPH
+  // Don't mix any color codes into animation frames streamed to stdout.
+  if (gs.nAnimFrame > 0 && gs.fAnimRaw && gi.szFileOut != NULL &&
+    FEqSz(gi.szFileOut, "-"))
+    us.fAnsiColor = fFalse;
+#endif
   InitColors();
   AnsiColor(kDefault);
 
@@ -207,7 +217,9 @@ LNextLine:
     if (!is.fHaveInfo && !FInputData(szTtyCore))
       return;
     ciMain = ciCore;
+    TraceBegin("Cast chart");
     CastChart(1);
+    TraceEnd();
 #else
     ciMain = ciCore;
     if (wi.fCast || cSequenceLine > 0 || fDoList) {
@@ -217,7 +229,9 @@ LNextLine:
 #endif
   } else {
     ciMain = ciCore;
+    TraceBegin("Cast relationship chart");
     CastRelation();
+    TraceEnd();
   }
 #ifndef WIN
   ciSave = ciMain;
@@ -226,7 +240,9 @@ LNextLine:
 #ifdef GRAPH
   if (us.fGraphics) {
     // If in -X graphics mode, go make a graphics chart.
+    TraceBegin("Draw graphics chart");
     FActionX();
+    TraceEnd();
     iLine = cSequenceLine;    // Once any graphics drawn, stop looping!
   } else
 #endif
@@ -244,7 +260,9 @@ LNextLine:
   if (!us.fExpOff && FSzSet(us.szExpDisp1))
     ParseExpression(us.szExpDisp1);
 #endif
+    TraceBegin("Print chart");
     PrintChart(is.fProgress);
+    TraceEnd();
 #ifdef EXPRESS
   // Notify AstroExpression a chart has just been drawn.
   if (!us.fExpOff && FSzSet(us.szExpDisp2))
@@ -506,6 +524,13 @@ int NProcessSwitchesRare(int argc, char **argv, int pos,
     break;
 
   case 'u':
+    if (ch1 == 'c') {
+      if (FErrorArgc("Yuc", argc, 1))
+        return tcError;
+      FCloneSz(argv[1], &us.szEclipseFile);
+      darg++;
+      break;
+    }
     if (ch1 == '0')
       SwitchF(us.fEclipseAny);
     SwitchF(us.fEclipse);
@@ -1216,6 +1241,49 @@ int NProcessSwitchesRare(int argc, char **argv, int pos,
     SwitchF(us.fNoDisplay);
     break;
 
+#ifdef JPLWEB
+  case 'H':
+    if (FErrorArgc("YH", argc, 1))
+      return tcError;
+    FCloneSz(argv[1], ch1 == '0' ? &us.szJPLFile : &us.szJPLURL);
+    darg++;
+    break;
+#endif
+
+  case 'W':
+    if (FErrorArgc("YW", argc, 1))
+      return tcError;
+    i = NFromSz(argv[1]);
+    if (FErrorValN("YW", !FBetween(i, 0, cWorkerMax), i, 0))
+      return tcError;
+    us.nWorker = i;
+    darg++;
+    break;
+
+  case 'N':
+    if (FErrorArgc("YN", argc, 1))
+      return tcError;
+    i = NFromSz(argv[1]);
+    if (FErrorValN("YN", !FBetween(i, 0, 10000), i, 0))
+      return tcError;
+    us.nCastCache = i;
+    darg++;
+    break;
+
+  case 'L':
+    if (ch1 != '0') {
+      us.nTraceBudget = FSwitchF(us.nTraceBudget >= 0) ? 0 : -1;
+      break;
+    }
+    if (FErrorArgc("YL0", argc, 1))
+      return tcError;
+    i = NFromSz(argv[1]);
+    if (FErrorValN("YL0", i < 0, i, 0))
+      return tcError;
+    us.nTraceBudget = i;
+    darg++;
+    break;
+
   case '5':
     if (ch1 == 'i') {
       if (FErrorArgc("Y5i", argc, 1))
@@ -1360,6 +1428,25 @@ flag FProcessSwitches(int argc, char **argv)
       break;
 
     case 'Q':
+      if (ch1 == 's') {
+        if (ch2 == '0')
+          FCloneSz("", &is.szServer);
+        else {
+          if (FErrorArgc("Qs", argc, 1))
+            return fFalse;
+          FCloneSz(argv[1], &is.szServer);
+          argc--; argv++;
+        }
+        break;
+      } else if (ch1 == 'b') {
+        i = 1 + (ch2 == '0');
+        if (FErrorArgc("Qb", argc, i))
+          return fFalse;
+        FCloneSz(argv[1], &is.szBatch);
+        FCloneSz(i > 1 ? argv[2] : NULL, &is.szBatchLog);
+        argc -= i; argv += i;
+        break;
+      }
       if (ch1 == '0')
         SwitchF(us.fLoopInit);
       SwitchF(us.fLoop);
@@ -1631,6 +1718,17 @@ flag FProcessSwitches(int argc, char **argv)
           i = 2-(i&1);
           argc -= i; argv += i;
         }
+      } else if (ch1 == 'E') {
+        if (FErrorArgc("dE", argc, 1))
+          return fFalse;
+        i = NFromSz(argv[1]);
+        if (FErrorValN("dE", i < 1, i, 1))
+          return fFalse;
+        us.nEphemYears = i;
+        us.fEclipseCSV = (ch2 == '0');
+        SwitchF(us.fEclipseList);
+        argc--; argv++;
+        break;
       } else if (ch1 == 'm' || ch1 == 'y' || ch1 == 'Y') {
         is.fProgress = fFalse;
         if (ch1 == 'y')
@@ -2286,8 +2384,8 @@ flag FProcessSwitches(int argc, char **argv)
         FCloneSz(argv[1], &is.szFileScreen);
         argc--; argv++;
         break;
-      } else if (ch1 == '0' || ch1 == 'd' || ch1 == 'l' ||
-        ch1 == 'a' || ch1 == 'q' || ch1 == 'x')
+      } else if (ch1 == '0' || ch1 == 'd' || ch1 == 'l' || ch1 == 'b' ||
+        ch1 == 'c' || ch1 == 'a' || ch1 == 'q' || ch1 == 'x')
         us.nWriteFormat = FSwitchF2(us.nWriteFormat == ch1) * ch1;
       SwitchF(us.fWriteFile);
       FCloneSz(argv[1], &is.szFileOut);
@@ -2865,11 +2963,18 @@ flag FProcessSwitches(int argc, char **argv)
     case '5':
       if (ch1 == 'e' || ch1 == 'Y') {
         i = 1 + (ch2 == '2') + (ch2 == '3')*2 + (ch2 == '4')*3;
-        if (ch1 == 'e')
+        if (ch1 == 'e') {
           us.nListAll = FSwitchF(us.nListAll == i) * i;
-        else
+          if (us.nListAll > 0)   // -5e and -5t are exclusive.
+            us.fListTransit = fFalse;
+        } else
           FEnumerateCIList(i);   // -5Y does the same as -Y5
-      } else if (ch1 == 'd')
+      } else if (ch1 == 't') {
+        SwitchF(us.fListTransit);
+        if (us.fListTransit)
+          us.nListAll = 0;
+      }
+      else if (ch1 == 'd')
         FSortCIList(0);
       else if (ch1 == 'x')
         FSortCIList(1);
@@ -2904,6 +3009,10 @@ flag FProcessSwitches(int argc, char **argv)
         SwitchF(us.fTextHTML);
         break;
       }
+      if (ch1 == 'j') {
+        SwitchF(us.fTextJSON);
+        break;
+      }
       if (ch1 == '1') {     // Undocumented subswitch.
         us.fAnsiColor = 2;
         us.fAnsiChar  = 1;
@@ -3254,7 +3363,16 @@ void FinalizeProgram(flag fSkip)
   DeallocatePIf(us.szAstColor);
   DeallocatePIf(us.szStarsList);
   DeallocatePIf(us.szExoList);
+  DeallocatePIf(us.szEclipseFile);
+  DeallocatePIf(is.rgei);
+  DeallocatePIf(is.rgjb);
+  DeallocatePIf(us.szJPLURL);
+  DeallocatePIf(us.szJPLFile);
+  DeallocatePIf(is.szServer);
+  DeallocatePIf(is.szBatch);
+  DeallocatePIf(is.szBatchLog);
   DeallocatePIf(is.rgci);
+  ClearCastCache();
   if (is.rgexod != NULL) {
     for (i = 0; i < is.cexod; i++)
       DeallocatePIf(is.rgexod[i].sz);
@@ -3378,6 +3496,9 @@ void FinalizeProgram(flag fSkip)
   DeallocatePIf(gi.bmpRising.rgb);
   DeallocatePIf(gi.rgspace);
   DeallocatePIf(gi.rgConstel);
+  ClearTurtleCache();
+  DeallocatePIf(gi.lsWorld.pb);
+  DeallocatePIf(gi.lsConstel.pb);
   DeallocatePIf(gi.szFileOut);
   DeallocatePIf(gs.szSidebar);
   for (i = 0; i <= cRing; i++)
@@ -3387,6 +3508,7 @@ void FinalizeProgram(flag fSkip)
       DeallocateP((char *)szDrawObject[i]);
     if (szDrawObject2[i] != szDrawObjectDef2[i])
       DeallocateP((char *)szDrawObject2[i]);
+    DeallocatePIf(gi.rgagl[i].rgad);
   }
   for (i = 1; i <= cAspect2; i++) {
     if (szDrawAspect[i] != szDrawAspectDef[i])
@@ -3428,6 +3550,348 @@ void FinalizeProgram(flag fSkip)
 }
 
 
+#ifndef PC
+// Split a request line for the -Qs chart server or a -Qb batch job into its
+// switches, in the same way as a line in a switch file. Return 0 if the line
+// isn't a request, i.e. it's blank, a comment, or a file type identifier.
+
+int NParseRequest(char *szLine, char **argv)
+{
+  char *pch;
+  int argc;
+
+  for (pch = szLine; (uchar)*pch >= ' ' || *pch == chTab; pch++)
+    ;
+  *pch = chNull;
+  argc = NParseCommandLine(szLine, argv);
+  if (argc <= 1 || argv[1][0] == ';' || argv[1][0] == '@')
+    return 0;
+  return argc;
+}
+
+
+// Run a request's switches in a newly forked child process, with all its
+// output sent to the given file, then exit. Since the child is a copy of its
+// parent, the request starts from the parent's settings, and an error that
+// would exit the program only ends that request.
+
+void RunRequest(int argc, char **argv, int fdOut)
+{
+  int fd;
+
+  fd = open("/dev/null", O_RDONLY);
+  if (fd >= 0) {
+    dup2(fd, 0);
+    close(fd);
+  }
+  dup2(fdOut, 1);
+  dup2(fdOut, 2);
+  close(fdOut);
+  // Line buffer output, so warnings sent to the same file stay between lines
+  // of the chart as they would on a terminal.
+  setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+  FDetachWorkerFiles(fTrue);
+  us.fLoop = us.fNoQuit = fFalse;
+  if (FProcessSwitches(argc, argv))
+    Action();
+  // Exit like Terminate() does, but skip freeing memory, since the child
+  // has its parent's allocations too.
+  if (us.fAnsiColor && !us.fTextJSON)
+    printf("%c[0m", chEscape);
+  EndWorker(1);
+}
+
+
+// Run one request line for the -Qs chart server, in a child process so it
+// starts from the settings the server started with. The chart output is
+// copied to the given file, followed by a line marking the end of the
+// request and giving its exit code.
+
+void ServeRequest(char *szLine, int fdOut)
+{
+  char sz[cchSzMax], *argv[MAXSWITCHES], chLast = '\n';
+  int argc, rgfd[2], nStatus = -1;
+  long cb;
+  pid_t pid;
+
+  argc = NParseRequest(szLine, argv);
+  if (argc <= 0)
+    return;
+  pid = -1;
+  if (pipe(rgfd) >= 0) {
+    fflush(NULL);
+    pid = fork();
+    if (pid == 0) {
+      // Requests should just end on signals, not remove the server's socket.
+      signal(SIGINT, SIG_DFL);
+      signal(SIGTERM, SIG_DFL);
+      signal(SIGHUP, SIG_DFL);
+      close(rgfd[0]);
+      RunRequest(argc, argv, rgfd[1]);
+    }
+    close(rgfd[1]);
+    if (pid > 0) {
+      while ((cb = read(rgfd[0], sz, cchSzMax)) > 0) {
+        FWriteWorker(fdOut, sz, cb);
+        chLast = sz[cb-1];
+      }
+      if (waitpid(pid, &nStatus, 0) < 0 || !WIFEXITED(nStatus))
+        nStatus = -1;
+      else
+        nStatus = WEXITSTATUS(nStatus);
+    }
+    close(rgfd[0]);
+  }
+  sprintf(sz, "%s@END %d\n", chLast != '\n' ? "\n" : "", nStatus);
+  FWriteWorker(fdOut, sz, CchSz(sz));
+}
+
+
+// Read a request line for the -Qs chart server into a buffer cchSzLine long.
+// Lines too long to fit are skipped, and rejected by sending an error and an
+// end of request line with a nonzero code, rather than being run in pieces.
+// Return false at the end of input.
+
+flag FReadRequest(FILE *file, char *sz, int fdOut)
+{
+  CONST char *szErr = "Request line is too long.\n@END -1\n";
+  int ch;
+
+  loop {
+    if (fgets(sz, cchSzLine, file) == NULL)
+      return fFalse;
+    if (CchSz(sz) < cchSzLine-1 || sz[cchSzLine-2] == '\n')
+      return fTrue;
+    while ((ch = getc(file)) != EOF && ch != '\n')
+      ;
+    FWriteWorker(fdOut, szErr, CchSz(szErr));
+  }
+}
+
+
+// Remove the -Qs chart server's socket when the server is stopped.
+
+void EndServer(int nSignal)
+{
+  unlink(is.szServer);
+  _exit(nSignal == 0 ? 0 : 128 + nSignal);
+}
+
+
+// Run as a persistent chart server, as done with the -Qs switch. Files and
+// tables normally loaded on demand are loaded once here, so requests don't
+// each pay for them. Then read switch lines from standard input, or from
+// each connection made to a Unix domain socket, and run each as a request.
+// The socket is removed when the server is stopped with a signal. If
+// connections keep failing to be accepted, wait longer between attempts,
+// and eventually give up.
+
+void ServeCharts(void)
+{
+  struct sockaddr_un sa;
+  struct stat st;
+  char sz[cchSzLine];
+  FILE *file;
+  int fdListen, fd, cFail = 0;
+
+  signal(SIGPIPE, SIG_IGN);    // Clients closing early shouldn't end server.
+#ifdef ATLAS
+  FEnsureAtlas();
+  FEnsureTimezoneChanges();
+#endif
+  ciMain = ciCore;
+  CastChart(1);    // Open ephemeris files by casting a chart.
+
+  if (*is.szServer == chNull) {
+    while (FReadRequest(stdin, sz, 1))
+      ServeRequest(sz, 1);
+    return;
+  }
+  ClearB((pbyte)&sa, sizeof(sa));
+  sa.sun_family = AF_UNIX;
+  sprintf(sz, "Couldn't listen for requests on socket %s.", is.szServer);
+  if (CchSz(is.szServer) >= (int)sizeof(sa.sun_path)) {
+    PrintError(sz);
+    return;
+  }
+  sprintf(sa.sun_path, "%s", is.szServer);
+
+  // Only replace a stale socket left behind, never any other kind of file.
+  if (lstat(sa.sun_path, &st) >= 0) {
+    if (!S_ISSOCK(st.st_mode)) {
+      sprintf(sz, "Socket path %s exists and isn't a socket.", is.szServer);
+      PrintError(sz);
+      return;
+    }
+    unlink(sa.sun_path);
+  }
+  fdListen = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fdListen < 0 || bind(fdListen, (struct sockaddr *)&sa,
+    sizeof(sa)) < 0 || listen(fdListen, 16) < 0) {
+    PrintError(sz);
+    return;
+  }
+  signal(SIGINT, EndServer);
+  signal(SIGTERM, EndServer);
+  signal(SIGHUP, EndServer);
+
+  loop {
+    fd = accept(fdListen, NULL, NULL);
+    if (fd < 0) {
+      if (++cFail >= 100) {
+        sprintf(sz, "Stopped accepting requests on socket %s.",
+          is.szServer);
+        PrintError(sz);
+        break;
+      }
+      usleep(10000L << Min(cFail, 7));
+      continue;
+    }
+    cFail = 0;
+    file = fdopen(fd, "r");
+    if (file == NULL) {
+      close(fd);
+      continue;
+    }
+    while (FReadRequest(file, sz, fd))
+      ServeRequest(sz, fd);
+    fclose(file);
+  }
+  close(fdListen);
+  unlink(sa.sun_path);
+}
+
+
+// Run a file of independent chart jobs, as done with the -Qb switch. Each
+// line is a job, run in its own worker process starting from the current
+// settings, with as many jobs at once as -YW allows. Each job's output goes
+// to a temporary file, which is copied to standard output in the order the
+// jobs are listed. Show progress as jobs finish, and if a log file was given,
+// write how long each job took and its exit code to it.
+
+void RunBatch(void)
+{
+  char sz[cchSzLine], *argv[MAXSWITCHES], *pch;
+  FILE *file, *fileLog = NULL;
+  BatchJob *rgbj, *pbj;
+  int cJob = 0, cw, cRun = 0, iNext = 0, iOut = 0, iDone = 0, argc, nStatus;
+  long cb;
+  pid_t pid;
+  real rTime;
+  flag fProgress;
+
+  // Load the list of jobs.
+  file = FileOpen(is.szBatch, 0, NULL);
+  if (file == NULL) {
+    sprintf(sz, "Batch file %s not found.", is.szBatch);
+    PrintError(sz);
+    return;
+  }
+  while (fgets(sz, cchSzLine, file) != NULL)
+    if (NParseRequest(sz, argv) > 0)
+      cJob++;
+  rgbj = cJob > 0 ? RgAllocate(cJob, BatchJob, "batch jobs") : NULL;
+  if (rgbj == NULL) {
+    fclose(file);
+    return;
+  }
+  ClearB((pbyte)rgbj, cJob * (int)sizeof(BatchJob));
+  rewind(file);
+  while (iNext < cJob && fgets(sz, cchSzLine, file) != NULL) {
+    for (pch = sz; (uchar)*pch >= ' ' || *pch == chTab; pch++)
+      ;
+    *pch = chNull;
+    FCloneSz(sz, &rgbj[iNext].sz);
+    if (NParseRequest(sz, argv) > 0)
+      iNext++;
+    else
+      FCloneSz(NULL, &rgbj[iNext].sz);
+  }
+  fclose(file);
+  cJob = iNext;
+  iNext = 0;
+  if (is.szBatchLog != NULL) {
+    fileLog = fopen(is.szBatchLog, "w");
+    if (fileLog == NULL) {
+      sprintf(sz, "File %s can not be created.", is.szBatchLog);
+      PrintWarning(sz);
+    }
+  }
+
+  cw = NWorkerCount(cJob);
+  fProgress = isatty(fileno(stderr));
+  rTime = RTimer();
+  while (iOut < cJob) {
+    // Start more jobs while there are idle workers, without getting too far
+    // ahead of the oldest job whose output hasn't been sent yet.
+    while (cRun < cw && iNext < cJob && iNext - iOut < cw*4) {
+      pbj = &rgbj[iNext++];
+      pbj->file = tmpfile();
+      pbj->nStatus = -1;
+      pbj->rTime = RTimer();
+      fflush(NULL);
+      pid = pbj->file != NULL ? fork() : -1;
+      if (pid == 0) {
+        argc = NParseRequest(pbj->sz, argv);
+        RunRequest(argc, argv, fileno(pbj->file));
+      }
+      if (pid > 0) {
+        pbj->pid = (int)pid;
+        cRun++;
+      } else {
+        pbj->rTime = 0.0;
+        iDone++;
+      }
+    }
+
+    // Wait for a job to finish, and note how it went.
+    if (cRun > 0) {
+      pid = wait(&nStatus);
+      if (pid < 0)
+        break;
+      for (pbj = &rgbj[iOut]; pbj < &rgbj[iNext] && pbj->pid != (int)pid;
+        pbj++)
+        ;
+      if (pbj < &rgbj[iNext]) {
+        pbj->pid = 0;
+        pbj->nStatus = WIFEXITED(nStatus) ? WEXITSTATUS(nStatus) : -1;
+        pbj->rTime = RTimer() - pbj->rTime;
+        cRun--;
+        iDone++;
+      }
+    }
+
+    // Send the output of any finished jobs that are next in order.
+    while (iOut < iNext && rgbj[iOut].pid == 0) {
+      pbj = &rgbj[iOut++];
+      if (pbj->file != NULL) {
+        rewind(pbj->file);
+        while ((cb = (long)fread(sz, 1, cchSzLine, pbj->file)) > 0)
+          fwrite(sz, 1, cb, stdout);
+        fclose(pbj->file);
+      }
+      if (fileLog != NULL)
+        fprintf(fileLog, "%d\t%.3f\t%d\t%s\n", iOut, pbj->rTime,
+          pbj->nStatus, pbj->sz);
+      DeallocateP(pbj->sz);
+    }
+    fflush(stdout);
+    if (fProgress)
+      fprintf(stderr, "\rBatch: %d of %d jobs done, %.0f sec elapsed, "
+        "%.0f sec left ", iDone, cJob, RTimer() - rTime, iDone <= 0 ? 0.0 :
+        (RTimer() - rTime) * (real)(cJob - iDone) / (real)iDone);
+  }
+  if (fProgress)
+    fprintf(stderr, "\n");
+  for (; iOut < cJob; iOut++)
+    DeallocatePIf(rgbj[iOut].sz);
+  if (fileLog != NULL)
+    fclose(fileLog);
+  DeallocateP(rgbj);
+}
+#endif
+
+
 #ifndef WIN
 // The main program, the starting point for Astrolog, follows. This routine
 // basically consists of a loop, inside which we read a command line, and go
@@ -3446,13 +3910,25 @@ int main()
 #ifdef BETA
   char szBeta[cchSzMax];
 #endif
+  flag fSwitch;
+
+#ifndef PC
+  // Text going to a file or pipe is written in large blocks. A terminal
+  // keeps its line buffering, so each line shows up as soon as printed.
+  if (!isatty(fileno(stdout)))
+    setvbuf(stdout, NULL, _IOFBF, cbPrintBuf);
+#endif
 
   // Read in info from the astrolog.as file.
+  TraceBegin("InitProgram");
   InitProgram();
+  TraceEnd();
 #ifdef SWITCHES
   is.szProgName = argv[0];
 #endif
+  TraceBegin("Default settings file");
   FProcessSwitchFile(DEFAULT_INFOFILE, NULL);
+  TraceEnd();
   ciTran = ciHexa = ciFive = ciFour = ciThre = ciTwin = ciMain = ciCore;
 #ifdef BETA
   sprintf(szBeta, "This is a beta version of %s %s! "
@@ -3469,12 +3945,33 @@ LBegin:
     argv = rgsz;
   }
   is.szProgName = argv[0];
-  if (FProcessSwitches(argc, argv)) {
+  TraceBegin("Command line switches");
+  fSwitch = FProcessSwitches(argc, argv);
+  TraceEnd();
+  if (fSwitch) {
     if (!us.fNoSwitches && us.fLoopInit) {
       us.fNoSwitches = fTrue;
       goto LBegin;
     }
+#ifndef PC
+    if (is.szServer != NULL) {
+      ServeCharts();
+      Terminate(tcOK);
+    }
+    if (is.szBatch != NULL) {
+      RunBatch();
+      Terminate(tcOK);
+    }
+#endif
+    TraceBegin("Action");
     Action();
+    TraceEnd();
+  }
+  if (us.nTraceBudget >= 0 && is.ctm < cTraceMax) {
+    is.S = stdout;
+    PrintL();
+    if (FPrintTrace() && !us.fLoop && !us.fNoQuit)
+      Terminate(tcError);
   }
   if (us.fLoop || us.fNoQuit) {  // If -Q in effect loop back and get switch
     PrintL2();                   // info for another chart to display.
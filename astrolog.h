@@ -270,6 +270,9 @@
 #define CELLSIZE     14  // Size for each cell in the aspect grid.
 #define DEFORB      7.0  // Min distance glyphs can be from each other.
 #define MAXSCALE    400  // Max scale factor as passed to -Xs swtich.
+#define BATCHX     1024  // Max X11 points or lines to batch per request.
+#define TURTLEHASH  256  // Number of buckets in decoded glyph cache.
+#define TURTLESEG   256  // Max line segments in a cached turtle glyph.
 #endif // GRAPH
 
 // Ascii and other characters used to display text charts.
@@ -336,6 +339,17 @@
 #include <unistd.h>
 #endif
 
+// Timers, worker processes for parallel operations, and the chart server
+#ifndef PC
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <signal.h>
+#endif
+
 #ifdef X11
 #define ISG
 #include <X11/Xlib.h>
@@ -504,6 +518,7 @@
 #define cchSzDef  80
 #define cchSzMax  255
 #define cchSzLine (cchSzMax*4)
+#define cbPrintBuf 65536
 #define dwCanary  0x87654321
 #define nDegMax   360
 #define nDegHalf  180
@@ -523,6 +538,11 @@
 #define iAnimDay  4
 #define iAnimNow  10
 #define iFillMax  255
+#define cWorkerMax 64
+#define nEclipseWin 10
+#define rEclipseMargin 0.1
+#define cJPLRow 157          // Epochs in a JPL block: 26 hours in 10 minutes.
+#define rJPLStep (10.0/1440.0)
 
 // Math and conversion constants
 
@@ -545,6 +565,7 @@
 #define rLYToAU    63241.07708427
 #define rPCToAU    206264.8062471
 #define rDayInYear 365.24219
+#define rDegSidDay 360.98564736629
 #define rEarthDist 149.59787
 #define rEpoch2000 -24.736467
 #define rJD2000    2451545.0
@@ -850,6 +871,30 @@ enum _progressiontype {
   ptMixed    = 2,
 };
 
+// Optional chart fields that CastChartPart() can be asked for. Longitudes,
+// latitudes, and house cusps are always computed.
+
+enum _castfield {
+  cfSpeed   = 0x1,  // Velocities of objects
+  cfDist    = 0x2,  // Distances of objects
+  cfSort    = 0x4,  // Display order of objects
+  cfInHouse = 0x8,  // House each object is in
+  cfAll     = 0xF,
+};
+
+// Ephemeris series sample channels
+
+enum _ephemseries {
+  tsObj     = 0,  // Longitude
+  tsDir     = 1,  // Longitude velocity
+  tsAlt     = 2,  // Latitude
+  tsDiralt  = 3,  // Latitude velocity
+  tsDist    = 4,  // Distance
+  tsDirlen  = 5,  // Distance velocity
+  tsDistVel = 6,  // Slope of distance samples, for interpolating them
+  cTsr      = 7,
+};
+
 // Biorhythm cycle constants
 
 #define brPhy 23.0
@@ -1509,6 +1554,31 @@ typedef struct _GridInfo {
   real v[objMax][objMax];  // Value of aspect orb, or degree within sign
 } GridInfo;
 
+#define cAspGap 360  // Number of slices of 180 degrees in aspect gap table.
+
+typedef struct _AspectGap {
+  real rOrbMax;       // Largest orb of any aspect being checked
+  real rgr[cAspGap];  // Least distance to an aspect angle from each slice
+} AG;
+
+typedef struct _RelocSweep {
+  int clon;           // Number of longitude columns in grid
+  int clat;           // Number of latitude rows in grid
+  real lon, lat;      // Location of first grid point (longitude west positive)
+  real dlon, dlat;    // Distance between adjacent grid columns and rows
+  real *rgcusp;       // House cusps for each grid point, cSign per point
+} RLS;
+
+typedef struct _RelocSweepTime {
+  flag fFast;         // Whether computing cusps directly for each location
+  char ch;            // Swiss Ephemeris house system character
+  real armc;          // ARMC at longitude zero
+  real eps;           // True obliquity of the ecliptic
+  real rSid;          // Offset to add to tropical cusps
+  real decSun;        // Declination of the Sun, for Sunshine houses
+  byte ignore[objMax];  // Restrictions to cast charts with if not fFast
+} RLST;
+
 typedef struct _CrossInfo {
   short obj1;  // First planet making crossing
   short ang1;  // Angle in question of first planet
@@ -1530,8 +1600,65 @@ typedef struct _InDayInfo {
   real pos2;     // Zodiac position of second planet
   real ret1;     // First planet's zodiac position velocity
   real ret2;     // Second planet's zodiac position velocity
+  int iSeg;      // Index of segment's start chart in SEG list, or -1
+  real rSeg;     // Fraction of the way through segment event happens
 } InDayInfo;
 
+typedef struct _HorizonInfo {
+  short source;  // Planet crossing horizon or meridian
+  short type;    // Rising, zenith, setting, or nadir (1-4)
+  int fRet;      // Sign of planet's zodiac position velocity
+  real time;     // Time of event in minutes
+  real pos;      // Zodiac position of planet
+  real azialt;   // Azimuth if horizon event, altitude if meridian event
+  int iSeg;      // Index of segment's start chart in SEG list, or -1
+  real rSeg;     // Fraction of the way through segment event happens
+} HorizonInfo;
+
+typedef struct _EclipseInfo {
+  real jd;       // Julian day (UT) of greatest eclipse
+  real jdBeg;    // Julian day (UT) event begins anywhere on Earth
+  real jdEnd;    // Julian day (UT) event ends anywhere on Earth
+  real mag;      // Magnitude at greatest eclipse
+  int obj;       // Sun if solar, Moon if lunar, else planet Moon occults
+  int et;        // Type of eclipse, e.g. partial or total
+} EclipseInfo;
+
+typedef struct _JPLBlock {
+  int id;               // JPL Horizons object index
+  char szCenter[64];    // Observer the positions are relative to
+  real jd;              // Julian day (UT) of first epoch
+  PT3R rgpt[cJPLRow];   // Longitude, latitude, and light time in minutes
+} JPLBlock;
+
+typedef struct _BatchJob {
+  char *sz;      // Switch line for the job
+  FILE *file;    // Temporary file the job's output is sent to
+  int pid;       // Worker process running the job, or 0 if finished
+  int nStatus;   // Exit code of the worker, or -1 if it couldn't run
+  real rTime;    // When the job started, then how many seconds it took
+} BatchJob;
+
+#define cTraceMax 48
+typedef struct _TraceMark {
+  CONST char *sz;  // Name of the startup phase
+  int nDepth;      // How deeply nested the phase is within other phases
+  real rStart;     // When the phase began
+  real rTime;      // How many seconds the phase took, or -1 if still going
+} TraceMark;
+
+typedef struct _PrintTable {
+  int nKey;        // Character set settings the table was built for, or 0
+  signed char rgcch[256];  // Output bytes per input byte: -1 same, 0 slow
+  char rgrgch[256][4];     // Bytes to output for each input byte
+} PrintTable;
+
+typedef struct _TextBuf {
+  char *rgch;      // Contents of the rest of the file, zero terminated
+  char *pch;       // Start of the next line to be returned
+  char *pchEnd;    // End of the contents
+} TextBuf;
+
 typedef struct _TransInfo {
   short source;  // Transiting planet
   short aspect;  // The aspect transiting planet makes to natal planet
@@ -1542,6 +1669,23 @@ typedef struct _TransInfo {
   real retT;     // Transiting planet's zodiac position velocity
 } TransInfo;
 
+typedef struct _TransTarget {
+  real pos;      // Longitude, declination, or distance of natal planet
+  int ici;       // Index of natal chart in chart list
+  int obj;       // Natal planet
+} TransTarget;
+
+typedef struct _TransEvent {
+  int ici;       // Index of natal chart in chart list
+  int iSeg;      // Time segment transit was found in
+  int nOrder;    // Order found in when searching a single chart
+  short mon;     // Month of time segment
+  short yea;     // Year of time segment
+  int icp;       // Index of segment's start chart in SEG list, or -1
+  real rSeg;     // Fraction of the way through segment transit happens
+  TransInfo ti;  // The transit itself
+} TransEvent;
+
 typedef struct _ExoplanetData {
   char *sz;      // The name of the exoplanet
   real ra;       // RA of exoplanet's location
@@ -1620,6 +1764,26 @@ typedef struct _ChartPositions {
   real lonMC;           // 0 longitude converted to equatorial coordinates
 } CP;
 
+typedef struct _EphemSeries {
+  real jd;              // Julian day of the first sample
+  real dStep;           // Days between samples
+  int cSample;          // Number of samples taken of each object
+  int cob;              // Number of objects sampled
+  int rgobj[objMax];    // Index of each object sampled
+  real *rgr;            // Sample channels, each cob*cSample values long
+} TSR;
+
+#define ITsr(ptsr, ch, i, j) \
+  (((ch) * (ptsr)->cob + (i)) * (ptsr)->cSample + (j))
+
+typedef struct _SegmentCharts {
+  CP *rgcp;             // Charts cast at the ends of search time segments
+  int ccp;              // Number of charts stored
+  int ccpMax;           // Number of charts allocated
+  long iSeg;            // Segment whose end chart was stored last
+  real dSeg;            // Days in each segment
+} SEG;
+
 // Interpretation style structures for custom .ais files
 typedef struct _InterpretationCombo {
   char *key;           // "Sun+Aries+1" format
@@ -1661,8 +1825,25 @@ typedef struct _InterpretationStyle {
   char *defaultAspect;         // Fallback for aspects
 
   flag fLoaded;                // Whether file was loaded
+  pbyte pbCache;               // Mapped compiled .aisc image, if any
+  long cbCache;                // Size of the mapped image in bytes
 } InterpretationStyle;
 
+// Compiled .aisc style cache: header, then int offsets into the string pool
+// for each fixed slot, key/value offset pairs for each combination and
+// aspect combination, two hash indexes of cHash entries, then the pool.
+#define cStyleSlot (5 + objMax + (cSign+1)*3 + (cAspect+1)*2)
+typedef struct _StyleCacheHeader {
+  char szMagic[8];             // "@AS780" identifying the format
+  uint nStamp;                 // Hash of the source files' sizes and times
+  int cbImage;                 // Size of the whole file in bytes
+  int cSlot;                   // Number of fixed string slots
+  int cCombo;                  // Number of [combinations] entries
+  int cAspCombo;               // Number of [aspect_combinations] entries
+  int cHash;                   // Entries in each hash index, a power of 2
+  int ibPool;                  // File offset of the string pool
+} StyleCacheHeader;
+
 #define cMaxStyle 10
 typedef struct _InterpretationManager {
   InterpretationStyle *style[cMaxStyle];
@@ -1720,6 +1901,49 @@ typedef struct _ExtraStar {
   KI ki;              // Color to use for star.
 } ES;
 
+typedef struct _TurtleGlyph {
+  struct _TurtleGlyph *ptgNext;  // Next glyph in same hash bucket.
+  dword lHash;        // Hash of turtle string, for quick comparison.
+  int nScale;         // Scale the glyph's lines were decoded at.
+  int cseg;           // Number of line segments in glyph, or -1 if bad.
+  int xEnd;           // Final turtle position relative to start.
+  int yEnd;
+  int *rgseg;         // Line segment endpoints relative to start.
+  char *sz;           // Copy of the turtle string decoded.
+} TG;
+
+typedef struct _LineStore {
+  pbyte pb;           // Memory block holding all the arrays below.
+  int cpl;            // Number of polylines.
+  int cpt;            // Number of vertices in all polylines.
+  int kRest;          // Index to enumerate for later segments in a polyline.
+  CONST char **rgszNam;  // Name of each polyline, if any.
+  int *rgipt;         // Index of first vertex of each polyline, plus end.
+  short *rgx;         // Horizontal coordinate of each vertex.
+  short *rgy;         // Vertical coordinate of each vertex.
+  short *rgxLo;       // Bounding box of each polyline.
+  short *rgxHi;
+  short *rgyLo;
+  short *rgyHi;
+  char *rgk;          // Color or constellation index of each polyline.
+  int xLast;          // Last vertex and index added, while building.
+  int yLast;
+  int kLast;
+} LS;
+
+typedef struct _LineEnum {
+  CONST LS *pls;      // Line store being enumerated.
+  int ipl;            // Current polyline.
+  int ipt;            // Next vertex in current polyline.
+} LE;
+
+typedef struct _AstroGraphLine {
+  real rDec;          // Declination the line was traced for.
+  real rStep;         // Latitude step the line was traced with.
+  int cpt;            // Number of latitude steps allocated.
+  real *rgad;         // Ascensional difference at each step, or rLarge.
+} AGL;
+
 typedef struct _UserSettings {
 
   // Chart types
@@ -1749,6 +1973,7 @@ typedef struct _UserSettings {
   flag fZoneChange;     // -Nz
   flag fMoonChart;      // -8
   flag fExoTransit;     // -Ux
+  flag fEclipseList;    // -dE
 
   // Chart suboptions
   flag fVelocity;       // -v0
@@ -1769,6 +1994,7 @@ typedef struct _UserSettings {
   flag fCalendarYear;   // -Ky
   flag fInDayMonth;     // -dm
   flag fInDayYear;      // -dy
+  flag fEclipseCSV;     // -dE0
   flag fGraphAll;       // -B0
   flag fArabicFlip;     // -P0
   flag fMoonChartSep;   // -80
@@ -1824,8 +2050,10 @@ typedef struct _UserSettings {
   flag fEquator2;    // -sr0
   flag fAnsiChar;    // -k0
   flag fTextHTML;    // -kh
+  flag fTextJSON;    // -kj
   flag fSolarWhole;  // -10
   flag fListAuto;    // -5
+  flag fListTransit; // -5t
 
   // Obscure flags
   flag fTruePos;       // -YT
@@ -1903,6 +2131,9 @@ typedef struct _UserSettings {
   char *szStarsColor;  // -YkU
   char *szStarsList;   // -YRU
   char *szExoList;     // -YUx
+  char *szEclipseFile; // -Yuc
+  char *szJPLURL;      // -YH
+  char *szJPLFile;     // -YH0
 
   // Value subsettings
   int   nWheelRows;        // Number of rows per house to use for -w wheel.
@@ -1933,6 +2164,9 @@ typedef struct _UserSettings {
   int   nSignDiv;          // -YRd
   int   iExpADB;           // -~5i
   int   cExpADB;           // -~5i
+  int   nWorker;           // -YW
+  int   nCastCache;        // -YN
+  int   nTraceBudget;      // -YL
 
   // AstroExpression hooks
   char *szExpConfig;   // -~g
@@ -1988,6 +2222,31 @@ typedef struct _UserSettings {
   char *szExpADB;      // -~5i
 } US;
 
+typedef struct _CastSettings {
+  US us;                   // User settings
+  byte ignore[objMax];     // Objects restricted from being computed
+  real force[objMax];      // Objects forced to particular positions
+  real JDp;                // Time progressed charts are cast for
+  flag fDst;               // Autodetected Daylight Saving Time
+#ifdef SWISS
+  int rgObjSwiss[cCust];   // Custom object definitions
+  int rgTypSwiss[cCust];
+  int rgPntSwiss[cCust];
+  int rgFlgSwiss[cCust];
+#endif
+} CCS;
+
+typedef struct _CastCacheEntry {
+  CI ci;                   // Chart information the chart was cast for
+  long lSet;               // Generation of settings chart was cast with
+  long lUse;               // When entry was last used, for LRU replacement
+  CP cp;                   // Object positions and house cusps
+  int rgobjList[objMax];   // Display order of objects
+  int rgobjList2[objMax];
+  real T, JD, Tp, MC, Asc, EP, Vtx, RA, OB, rOff, rNut, rSid;
+  int nHouseSystem;
+} CCE;
+
 typedef struct _InternalSettings {
   flag fHaveInfo;      // Do we need to prompt user for chart info?
   flag fDst;           // Has Daylight Saving Time been autodetected?
@@ -2003,6 +2262,7 @@ typedef struct _InternalSettings {
   char *szFileOut;     // The output chart filename string as passed to -o.
   char **rgszComment;  // Points to any comment strings after -o filename.
   int nContext;        // Context of current or most recent chart cast.
+  int nCastSkip;       // Chart fields the current cast can skip computing.
   int nObj;            // Index of highest unrestricted object.
   int cszComment;      // The number of strings after -o that are comments.
   int cchRow;          // The current row text charts have scrolled to.
@@ -2053,6 +2313,33 @@ typedef struct _InternalSettings {
   real rDeltaT;        // Delta-T at chart time, in days.
   real jdDeltaT;       // JD for cached Delta-T offset above.
   real rNut;           // Nutation offset.
+  CCE *rgcce;          // Cache of recently cast charts (-YN).
+  CCS *pccs;           // Settings the chart cache was last accessed with.
+  int ccce;            // Number of charts stored in chart cache.
+  int ccceMax;         // Number of charts allocated in chart cache.
+  long lCastUse;       // Count of chart cache accesses, for LRU ordering.
+  long cCastHit;       // Number of chart casts found in chart cache.
+  long cCastMiss;      // Number of chart casts not found in chart cache.
+  long lCastSet;       // Generation of settings in pccs above.
+  char *szCastSet;     // Contents of string settings in pccs above.
+  EclipseInfo *rgei;   // Catalog of eclipses and occultations (-dE).
+  int cei;             // Number of events in catalog, or -1 if unloadable.
+  real jdEclipse1;     // Julian day (UT) span covered by the catalog.
+  real jdEclipse2;
+  char *szServer;      // Socket to serve charts on for -Qs, "" for stdin.
+  char *szBatch;       // File of independent chart jobs to run for -Qb.
+  char *szBatchLog;    // File to log how long each -Qb job took to.
+  JPLBlock *rgjb;      // Cache of positions from JPL Horizons queries.
+  int cjb;             // Number of blocks of positions in cache.
+  int cjbMax;          // Number of blocks cache has room for.
+  int ctm;             // Number of startup phases timed so far for -YL.
+  int ntmDepth;        // How deeply nested the current startup phase is.
+  int ntmSkip;         // Nested phases not recorded since trace is full.
+  TraceMark rgtm[cTraceMax];  // Timings of startup phases for -YL.
+  int ipt;             // Which output table was most recently built.
+  PrintTable rgpt[2];  // Character set tables for fast text output.
+  int rgfdWorker[cWorkerMax];   // Pipes of worker processes running.
+  int rgpidWorker[cWorkerMax];  // Process IDs of those workers, 0 if unused.
 } IS;
 
 #ifdef GRAPH
@@ -2099,6 +2386,7 @@ typedef struct _GraphicsSettings {
   flag fAntialias;   // Are we drawing lines antialiased (-Xx0 set).
   flag fIndianWheel; // Are wheel charts North/South Indian (-XJ set).
   flag fMoonWheel;   // Are moons drawn around planets in wheels (-X8 set).
+  flag fReloc;       // Are we coloring map by relocated houses (-XH set).
   int xWin;          // Current hor. size of graphic chart (-Xw).
   int yWin;          // Current ver. size of graphic chart (-Xw).
   int nAnim;         // Current animation mode jump rate (-Xn).
@@ -2113,6 +2401,7 @@ typedef struct _GraphicsSettings {
   real rRot;         // Current rotation degree of globe (-XG).
   real rTilt;        // Current vertical tilt of rotating globe (-XG).
   int objTrack;      // Object being telescope tracked, if any (-XZ).
+  int objReloc;      // Object whose relocated house colors map (-XH).
   char chBmpMode;    // Current bitmap file type (-Xb).
   real rBackPct;     // Background image transparency percentage (-XI).
   int nBackOrient;   // Background image wallpaper orientation (-XI).
@@ -2143,6 +2432,10 @@ typedef struct _GraphicsSettings {
   int nTriangles;    // Triangles/cubes grid to draw on maps, if any (-YXW).
   char *szStarsLin;  // Names of extra stars for linking (-YXU).
   char *szStarsLnk;  // Indexes of star pairs to link up (-YXU).
+  flag fDrawStats;   // Print drawing statistics for each chart (-YXs).
+  int nGlyphCache;   // Max KB of decoded glyphs to cache (-YXc).
+  int nAnimFrame;    // Number of animation frames to render to files (-YXn).
+  flag fAnimRaw;     // Write animation frames as one raw RGB stream (-YXn0).
 } GS;
 
 typedef struct _GraphicsInternal {
@@ -2204,6 +2497,10 @@ typedef struct _GraphicsInternal {
   Window wind, root;
   int screen;
   int depth;          // Number of active color bits.
+  int cxpt;           // Number of points batched up to draw.
+  int cxseg;          // Number of line segments batched up to draw.
+  long cxReq;         // Number of X11 drawing requests sent this chart.
+  long cxPrim;        // Number of points, lines, etc. drawn this chart.
 #endif
 #ifdef PS             // Variables used by the PostScript generator.
   flag fEps;          // Are we doing Encapsulated PostScript.
@@ -2236,6 +2533,13 @@ typedef struct _GraphicsInternal {
   KI kiInFile;        // Actual line color currently in file.
   int zDefault;       // Default elevation for 2D drawing.
 #endif
+  TG **rgptg;         // Hash table of decoded turtle glyphs (-YXc).
+  long cbTurtle;      // Memory used by decoded turtle glyphs.
+  long cTurtleHit;    // Glyphs drawn this chart found in cache.
+  long cTurtleMiss;   // Glyphs drawn this chart decoded from scratch.
+  LS lsWorld;         // Decoded coastlines of world map.
+  LS lsConstel;       // Decoded constellation boundaries and labels.
+  AGL rgagl[objMax];  // Traced astro-graph Ascendant/Descendant lines.
 } GI;
 #endif // GRAPH
 
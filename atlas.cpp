@@ -874,11 +874,14 @@ int ILookupCN(CONST char *szAbb, CONST CN *rgcn, int ccn)
 
 flag FEnsureAtlas()
 {
+  flag fRet;
+
   if (is.rgae != NULL)
     return fTrue;
-  if (!FProcessSwitchFile(DEFAULT_ATLASFILE, NULL))
-    return fFalse;
-  return is.rgae != NULL;
+  TraceBegin("Atlas");
+  fRet = FProcessSwitchFile(DEFAULT_ATLASFILE, NULL);
+  TraceEnd();
+  return fRet && is.rgae != NULL;
 }
 
 
@@ -888,11 +891,14 @@ flag FEnsureAtlas()
 
 flag FEnsureTimezoneChanges()
 {
+  flag fRet;
+
   if (is.rgzc != NULL && is.rgrun != NULL && is.rgrue != NULL)
     return fTrue;
-  if (!FProcessSwitchFile(DEFAULT_TIMECHANGE, NULL))
-    return fFalse;
-  return is.rgzc != NULL && is.rgrun != NULL && is.rgrue != NULL;
+  TraceBegin("Time zone changes");
+  fRet = FProcessSwitchFile(DEFAULT_TIMECHANGE, NULL);
+  TraceEnd();
+  return fRet && is.rgzc != NULL && is.rgrun != NULL && is.rgrue != NULL;
 }
 
 
@@ -0,0 +1,58 @@
+#!/bin/sh
+# Astrolog (Version 7.80) File: bench.sh (Unix version)
+#
+# Time parsing of AstroExpression heavy command lines and of a large switch
+# file, e.g. to compare builds after changes to expression or switch parsing.
+# Run as "make bench", or "./bench.sh [astrolog binary] [runs]". Each time
+# printed is the average over the given number of runs, in milliseconds.
+#
+# Also check the cold start budget documented for -YL0 in astrolog.htm: The
+# default chart should be done within BUDGET milliseconds of starting. Every
+# run is checked, and the script exits with an error if any was over.
+#
+
+BIN=${1:-./astrolog}
+RUNS=${2:-5}
+BUDGET=25
+SW=${TMPDIR:-/tmp}/astrolog_bench.$$.as
+
+# A switch file of 40000 expression assignments and 40000 switch lines.
+awk 'BEGIN {
+  print "@AS780  ; Astrolog switch parsing benchmark."
+  for (i = 0; i < 40000; i++) {
+    printf "-~1 \"= %%a Add Mul %d 3 Sin Real Cos Abs Neg @a\"\n", i
+    printf "-A %d -s -s -b -b -Yo -Yo -YR0 0 1 -R0 -U -U\n", i%17+1
+  }
+}' > "$SW"
+
+# Run a command the given number of times, and print its average time.
+timeit() {
+  label=$1; shift
+  t0=$(date +%s%N)
+  i=0
+  while [ $i -lt "$RUNS" ]; do
+    "$@" > /dev/null 2>&1
+    i=$((i+1))
+  done
+  t1=$(date +%s%N)
+  echo "$label: $(( (t1-t0) / RUNS / 1000000 )) ms"
+}
+
+timeit "Expression loop" "$BIN" -n -~ \
+  "For %a 1 3000000 Add Mul @a 2 Int Sin Real Cos Abs Neg @a"
+timeit "Function names" "$BIN" -n -~ \
+  "For %a 1 1000000 ObjLon Floor Abs Sqr Min Max Mod @a 20 1 2"
+timeit "Switch file" "$BIN" -n -i "$SW"
+timeit "Chart only" "$BIN" -n
+
+rm -f "$SW"
+
+# Check the cold start budget with -YL0, which fails when it's exceeded.
+over=0
+i=0
+while [ $i -lt "$RUNS" ]; do
+  "$BIN" -YL0 $BUDGET > /dev/null 2>&1 || over=$((over+1))
+  i=$((i+1))
+done
+echo "Cold start over $BUDGET ms: $over of $RUNS runs"
+[ $over -eq 0 ]
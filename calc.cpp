@@ -198,34 +198,43 @@ real RHousePlaceIn3D(real rLon, real rLat)
 }
 
 
-// This is a subprocedure of ComputeInHouses(). Given a zodiac position,
+// Given a zodiac position and a set of house cusps indexed from 1 to 12,
 // return which of the twelve houses it falls in. Remember that a special
 // check has to be done for the house that spans 0 degrees Aries.
 
-int NHousePlaceIn(real rLon, real rLat)
+int NHousePlaceInCusp(real rLon, CONST real *rgcusp)
 {
   int i, di;
 
-  // Special processing for 3D houses.
-  if (us.fHouse3D && rLat != 0.0)
-    return SFromZ(RHousePlaceIn3D(rLon, rLat));
-
   // This loop also works when house positions decrease through the zodiac.
   rLon = Mod(rLon + rSmall);
-  di = MinDifference(chouse[1], chouse[2]) >= 0.0 ? 1 : -1;
+  di = MinDifference(rgcusp[1], rgcusp[2]) >= 0.0 ? 1 : -1;
   i = 0;
   do {
     i++;
   } while (!(i >= cSign ||
-    (rLon >= chouse[i] && rLon < chouse[Mod12(i + di)]) ||
-    (chouse[i] > chouse[Mod12(i + di)] &&
-    (rLon >= chouse[i] || rLon < chouse[Mod12(i + di)]))));
+    (rLon >= rgcusp[i] && rLon < rgcusp[Mod12(i + di)]) ||
+    (rgcusp[i] > rgcusp[Mod12(i + di)] &&
+    (rLon >= rgcusp[i] || rLon < rgcusp[Mod12(i + di)]))));
   if (di < 0)
     i = Mod12(i - 1);
   return i;
 }
 
 
+// This is a subprocedure of ComputeInHouses(). Given a zodiac position,
+// return which of the twelve houses of the current chart it falls in.
+
+int NHousePlaceIn(real rLon, real rLat)
+{
+  // Special processing for 3D houses.
+  if (us.fHouse3D && rLat != 0.0)
+    return SFromZ(RHousePlaceIn3D(rLon, rLat));
+
+  return NHousePlaceInCusp(rLon, chouse);
+}
+
+
 // For each object in the chart, determine what house it belongs in.
 
 void ComputeInHouses(void)
@@ -971,7 +980,8 @@ void ComputeEphem(real t)
         us.fTruePos = fTrue;
       j = FCust(i) ? rgObjSwiss[i - custLo] :
         (i == oSun && us.fBarycenter ? 0 : rgObjJPL[i]);
-      fRet = GetJPLHorizons(j, &r1, &r2, &r3, &r4, &r5, &r6, NULL);
+      fRet = FJPLHorizonsCache(j, JulianDayFromTime(t),
+        &r1, &r2, &r3, &r4, &r5, &r6);
       us.fTruePos = fSav;
     } else
 #endif
@@ -1154,6 +1164,199 @@ void ComputeEphem(real t)
 #endif
 
 
+// Fill out a record of all the settings which affect the positions of a cast
+// chart, so the chart cache can tell whether a stored chart still applies.
+// String settings affecting positions may be edited in place, so they're left
+// out of the record, and compared by content with GetCastStrings() instead.
+
+void GetCastSettings(CCS *pccs)
+{
+  int i;
+
+  ClearB((pbyte)pccs, sizeof(CCS));
+  CopyRgb((pbyte)&us, (pbyte)&pccs->us, sizeof(US));
+  for (i = 0; i < 10; i++)
+    pccs->us.rgszPath[i] = NULL;
+  pccs->us.szStarsList = pccs->us.szExoList = NULL;
+  pccs->us.szJPLURL = pccs->us.szJPLFile = NULL;
+  CopyRgb(ignore, pccs->ignore, sizeof(ignore));
+  CopyRgb((pbyte)force, (pbyte)pccs->force, sizeof(force));
+  pccs->JDp = is.JDp;
+  pccs->fDst = is.fDst;
+#ifdef SWISS
+  CopyRgb((pbyte)rgObjSwiss, (pbyte)pccs->rgObjSwiss, sizeof(rgObjSwiss));
+  CopyRgb((pbyte)rgTypSwiss, (pbyte)pccs->rgTypSwiss, sizeof(rgTypSwiss));
+  CopyRgb((pbyte)rgPntSwiss, (pbyte)pccs->rgPntSwiss, sizeof(rgPntSwiss));
+  CopyRgb((pbyte)rgFlgSwiss, (pbyte)pccs->rgFlgSwiss, sizeof(rgFlgSwiss));
+#endif
+}
+
+
+// Fill out an array with the string settings which affect the positions of a
+// cast chart, i.e. the ones left out by GetCastSettings(), and return how many
+// there are. Unset strings are returned as empty ones.
+
+int GetCastStrings(CONST char **rgsz)
+{
+  int csz = 0, i;
+
+  for (i = 0; i < 10; i++)
+    rgsz[csz++] = us.rgszPath[i];
+  rgsz[csz++] = us.szStarsList; rgsz[csz++] = us.szExoList;
+  rgsz[csz++] = us.szJPLURL;    rgsz[csz++] = us.szJPLFile;
+  for (i = 0; i < csz; i++)
+    if (rgsz[i] == NULL)
+      rgsz[i] = "";
+  return csz;
+}
+
+
+// Free the cache of recently cast charts.
+
+void ClearCastCache()
+{
+  DeallocatePIf(is.rgcce);
+  DeallocatePIf(is.pccs);
+  DeallocatePIf(is.szCastSet);
+  is.rgcce = NULL;
+  is.pccs = NULL;
+  is.szCastSet = NULL;
+  is.ccce = is.ccceMax = 0;
+}
+
+
+// Look up the current chart in the cache of recently cast charts. A stored
+// chart only matches if it has the same chart information, and was cast with
+// the same generation of settings. A new generation starts whenever anything
+// affecting positions differs from the settings the cache was last accessed
+// with. If found, set the current chart's positions to the stored ones.
+
+flag FCastCacheLookup()
+{
+  CCS ccs;
+  CCE *pcce;
+  CONST char *rgsz[14], *pch;
+  char *sz;
+  flag fNew = fFalse;
+  int csz, cch, i;
+
+  // Allocate the cache, or reallocate it if its size limit has changed.
+  if (is.rgcce != NULL && is.ccceMax != us.nCastCache)
+    ClearCastCache();
+  if (is.rgcce == NULL) {
+    is.rgcce = RgAllocate(us.nCastCache, CCE, "chart cache");
+    is.pccs = RgAllocate(1, CCS, "chart cache");
+    if (is.rgcce == NULL || is.pccs == NULL) {
+      ClearCastCache();
+      return fFalse;
+    }
+    is.ccceMax = us.nCastCache;
+    fNew = fTrue;
+  }
+
+  // Compare the settings by value against those last accessed with, and
+  // start a new generation of them if anything has changed.
+  GetCastSettings(&ccs);
+  csz = GetCastStrings(rgsz);
+  if (!fNew)
+    fNew = !FEqRgb((pbyte)&ccs, (pbyte)is.pccs, sizeof(CCS));
+  for (pch = is.szCastSet, i = 0; !fNew && i < csz; i++) {
+    cch = CchSz(rgsz[i]) + 1;
+    fNew = !FEqRgb((pbyte)rgsz[i], (pbyte)pch, cch);
+    pch += cch;
+  }
+  if (fNew) {
+    for (cch = 0, i = 0; i < csz; i++)
+      cch += CchSz(rgsz[i]) + 1;
+    sz = RgAllocate(cch, char, "chart cache");
+    if (sz == NULL) {
+      ClearCastCache();
+      return fFalse;
+    }
+    DeallocatePIf(is.szCastSet);
+    is.szCastSet = sz;
+    for (i = 0; i < csz; i++) {
+      cch = CchSz(rgsz[i]) + 1;
+      CopyRgb((pbyte)rgsz[i], (pbyte)sz, cch);
+      sz += cch;
+    }
+    CopyRgb((pbyte)&ccs, (pbyte)is.pccs, sizeof(CCS));
+    is.lCastSet++;
+  }
+
+  is.lCastUse++;
+  for (i = 0; i < is.ccce; i++) {
+    pcce = &is.rgcce[i];
+    if (pcce->lSet != is.lCastSet ||
+      pcce->ci.tim != TT || pcce->ci.day != DD || pcce->ci.mon != MM ||
+      pcce->ci.yea != YY || pcce->ci.dst != SS || pcce->ci.zon != ZZ ||
+      pcce->ci.lon != OO || pcce->ci.lat != AA)
+      continue;
+    pcce->lUse = is.lCastUse;
+    cp0 = pcce->cp;
+    CopyRgb((pbyte)pcce->rgobjList, (pbyte)rgobjList, sizeof(rgobjList));
+    CopyRgb((pbyte)pcce->rgobjList2, (pbyte)rgobjList2, sizeof(rgobjList2));
+    is.T = pcce->T; is.JD = pcce->JD; is.Tp = pcce->Tp;
+    is.MC = pcce->MC; is.Asc = pcce->Asc; is.EP = pcce->EP;
+    is.Vtx = pcce->Vtx; is.RA = pcce->RA; is.OB = pcce->OB;
+    is.rOff = pcce->rOff; is.rNut = pcce->rNut; is.rSid = pcce->rSid;
+    is.nHouseSystem = pcce->nHouseSystem;
+    is.cCastHit++;
+    return fTrue;
+  }
+  is.cCastMiss++;
+  return fFalse;
+}
+
+
+// Store the chart just cast in the cache of recently cast charts, replacing
+// the least recently used one if the cache is full. Should only be called
+// right after a FCastCacheLookup() for the same chart that failed.
+
+void CastCacheStore()
+{
+  CCE *pcce;
+  int i;
+
+  if (is.rgcce == NULL)
+    return;
+  if (is.ccce < is.ccceMax)
+    pcce = &is.rgcce[is.ccce++];
+  else {
+    pcce = &is.rgcce[0];
+    for (i = 1; i < is.ccce; i++)
+      if (is.rgcce[i].lUse < pcce->lUse)
+        pcce = &is.rgcce[i];
+  }
+  pcce->ci = ciCore;
+  pcce->lSet = is.lCastSet;
+  pcce->lUse = is.lCastUse;
+  pcce->cp = cp0;
+  CopyRgb((pbyte)rgobjList, (pbyte)pcce->rgobjList, sizeof(rgobjList));
+  CopyRgb((pbyte)rgobjList2, (pbyte)pcce->rgobjList2, sizeof(rgobjList2));
+  pcce->T = is.T; pcce->JD = is.JD; pcce->Tp = is.Tp;
+  pcce->MC = is.MC; pcce->Asc = is.Asc; pcce->EP = is.EP;
+  pcce->Vtx = is.Vtx; pcce->RA = is.RA; pcce->OB = is.OB;
+  pcce->rOff = is.rOff; pcce->rNut = is.rNut; pcce->rSid = is.rSid;
+  pcce->nHouseSystem = is.nHouseSystem;
+}
+
+
+// Return whether any AstroExpression hooks are set that get run while a chart
+// is being cast, which may have side effects beyond the chart itself.
+
+flag FCastHooks(void)
+{
+#ifdef EXPRESS
+  return !us.fExpOff && (FSzSet(us.szExpCast1) || FSzSet(us.szExpCast2) ||
+    FSzSet(us.szExpObj) || FSzSet(us.szExpHou) || FSzSet(us.szExpProg) ||
+    FSzSet(us.szExpProg0) || FSzSet(us.szExpSort));
+#else
+  return fFalse;
+#endif
+}
+
+
 // This is probably the main routine in all of Astrolog. It generates a chart,
 // calculating the positions of all the celestial bodies and house cusps,
 // based on the current chart information, and saves them for use by any of
@@ -1164,6 +1367,7 @@ real CastChart(int nContext)
   CI ciSav;
   real housetemp[cSign+1], r, r2;
   int i, k, k2;
+  flag fCache;
 
   is.nContext = nContext;
 #ifdef EXPRESS
@@ -1181,6 +1385,15 @@ real CastChart(int nContext)
     return 0.0;
   }
 
+  // Reuse the positions of an identical chart cast recently, if there is one.
+  // Skip the cache for partial casts, for stars which compute more than chart
+  // positions, and when AstroExpressions can adjust the chart being cast.
+
+  fCache = us.nCastCache > 0 && is.nCastSkip == 0 && !us.fStar &&
+    !FStar(us.objCenter) && !FCastHooks();
+  if (fCache && FCastCacheLookup())
+    return is.T;
+
   // Hack: Time zone 24 means to have the time of day be in Local Mean Time
   // (LMT). This is done by making the time zone value reflect the logical
   // offset from UTC as indicated by the chart's longitude value.
@@ -1465,10 +1678,12 @@ real CastChart(int nContext)
 
   // Sort planet and star positions now that all positions are finalized.
 
-  for (i = 0; i <= is.nObj; i++)
-    if (!ignore[i])
-      cp0.dist[i] = PtLen(cp0.pt[i]);
-  SortPlanets();
+  if (!(is.nCastSkip & cfDist))
+    for (i = 0; i <= is.nObj; i++)
+      if (!ignore[i])
+        cp0.dist[i] = PtLen(cp0.pt[i]);
+  if (!(is.nCastSkip & cfSort))
+    SortPlanets();
 
 #ifdef EXPRESS
   // Adjust final planet and house positions with AstroExpressions.
@@ -1503,17 +1718,414 @@ real CastChart(int nContext)
   }
 #endif
 
-  ComputeInHouses();    // Figure out what house everything falls in.
+  // Figure out what house everything falls in. Do so even for partial casts
+  // if an AstroExpression hook is about to be run that might look at them.
+  if (!(is.nCastSkip & cfInHouse) || FCastHooks())
+    ComputeInHouses();
 #ifdef EXPRESS
   // Notify AstroExpression a chart has just been cast.
   if (!us.fExpOff && FSzSet(us.szExpCast2))
     ParseExpression(us.szExpCast2);
 #endif
   ciCore = ciSav;
+  if (fCache)
+    CastCacheStore();
   return is.T;
 }
 
 
+// Cast a chart like CastChart(), but only compute what the caller needs,
+// for searches that cast many charts. rgfIgnore is an object mask like
+// ignore[] to use instead of it (or NULL to keep the current one), and
+// nField is a combination of cf flags indicating optional fields wanted.
+
+real CastChartPart(int nContext, CONST byte *rgfIgnore, int nField)
+{
+  byte ignoreSav[objMax];
+  real r;
+
+  if (rgfIgnore != NULL) {
+    CopyRgb(ignore, ignoreSav, sizeof(ignore));
+    CopyRgb(rgfIgnore, ignore, sizeof(ignore));
+  }
+  is.nCastSkip = ~nField & cfAll;
+  r = CastChart(nContext);
+  is.nCastSkip = 0;
+  if (rgfIgnore != NULL)
+    CopyRgb(ignoreSav, ignore, sizeof(ignore));
+  return r;
+}
+
+
+// Set the current chart's time to a Julian day value as returned from
+// MdytszToJulian(), i.e. with time zone and Daylight offsets already applied.
+
+void SetCoreJulian(real jd)
+{
+  int mon, day, yea;
+  real jdDay = RFloor(jd);
+
+  JulianToMdy(jdDay, &mon, &day, &yea);
+  SetCI(ciCore, mon, day, yea, (jd - jdDay) * 24.0, 0.0, 0.0, OO, AA);
+}
+
+
+// Compute the house cusps for one latitude row of a relocation sweep. When
+// possible, each location is a direct call to Swiss Ephemeris' house routine
+// given the ARMC, without redoing anything that only depends on time.
+// Otherwise fall back to casting a chart with no objects at each location.
+
+void RelocSweepRow(CONST RLS *prls, CONST RLST *prlst, int ilat,
+  real *rgcusp)
+{
+  real lat = prls->lat + prls->dlat*(real)ilat, lon;
+  int ilon, i;
+
+  for (ilon = 0; ilon < prls->clon; ilon++, rgcusp += cSign) {
+    lon = prls->lon + prls->dlon*(real)ilon;
+#ifdef SWISS
+    if (prlst->fFast) {
+      if (FSwissHouseArmc(prlst, lon, lat, rgcusp))
+        continue;
+    } else
+#endif
+    {
+      OO = lon; AA = lat;
+      CastChartPart(0, prlst->ignore, 0);
+    }
+    for (i = 1; i <= cSign; i++)
+      rgcusp[i-1] = chouse[i];
+  }
+}
+
+
+// Compute house cusps at every location in a grid of latitudes and
+// longitudes, for the current chart's moment in time, e.g. for relocation
+// maps. The time dependent parts of the house calculation, such as sidereal
+// time, obliquity, nutation, and ayanamsa, are computed just once for the
+// whole grid, unless cusps are adjusted afterward, e.g. by solar arc or -1
+// solar charts, in which case a chart is cast at each location instead. Rows
+// are divided among worker processes.
+
+flag FRelocSweep(RLS *prls)
+{
+  RLST rlst;
+  CI ciSav = ciCore;
+  real chouseSav[cSign+1], rSav[5];
+  int ilat, cw, iw = 0, i, hs = is.nHouseSystem, nContext = is.nContext;
+  long cb = (long)prls->clon * cSign * sizeof(real);
+  flag fRet = fTrue;
+#ifndef PC
+  int rgfd[cWorkerMax];
+#endif
+
+  if (prls->clon <= 0 || prls->clat <= 0)
+    return fFalse;
+  ClearB((pbyte)&rlst, sizeof(rlst));
+  for (i = 0; i < objMax; i++)
+    rlst.ignore[i] = fTrue;
+  CopyRgb((pbyte)chouse, (pbyte)chouseSav, sizeof(chouse));
+  rSav[0] = is.Asc; rSav[1] = is.MC; rSav[2] = is.Vtx; rSav[3] = is.EP;
+  rSav[4] = AA;
+
+#ifdef SWISS
+  // Compute everything that doesn't depend on location just once.
+  rlst.fFast = FCmSwissAny() && !FCastHooks() &&
+    !FNoTimeOrSpace(ciCore) && !(us.fProgress && us.nProgress != ptCast) &&
+    us.objOnAsc == 0 && !us.fFlip;
+  if (rlst.fFast)
+    SwissRelocTime(&rlst,
+      us.fProgress && us.nProgress != ptSolarArc ? is.Tp : is.T);
+#endif
+
+  cw = (long)prls->clon * prls->clat >= 10000 ? NWorkerCount(prls->clat) : 1;
+#ifndef PC
+  if (cw > 1 && (iw = IForkWorkers(&cw, rgfd)) < 0 && cw <= 0) {
+    cw = 1;
+    iw = 0;
+  }
+#else
+  cw = 1;
+#endif
+
+  // Each process computes every cw'th row, starting with its own index.
+  if (iw >= 0) {
+    for (ilat = iw; ilat < prls->clat; ilat += cw) {
+      RelocSweepRow(prls, &rlst, ilat,
+        &prls->rgcusp[(long)ilat * prls->clon * cSign]);
+#ifndef PC
+      if (cw > 1 && !FWriteWorker(rgfd[0],
+        &prls->rgcusp[(long)ilat * prls->clon * cSign], cb))
+        break;
+#endif
+    }
+#ifndef PC
+    if (cw > 1)
+      EndWorker(rgfd[0]);
+#endif
+  }
+#ifndef PC
+  else {
+    // Collect the rows from the workers in order.
+    for (ilat = 0; ilat < prls->clat; ilat++)
+      if (!FReadWorker(rgfd[ilat % cw],
+        &prls->rgcusp[(long)ilat * prls->clon * cSign], cb))
+        break;
+    WaitWorkers(cw, rgfd);
+    fRet = (ilat >= prls->clat);
+  }
+#endif
+
+  // Restore the current chart.
+  CopyRgb((pbyte)chouseSav, (pbyte)chouse, sizeof(chouse));
+  is.Asc = rSav[0]; is.MC = rSav[1]; is.Vtx = rSav[2]; is.EP = rSav[3];
+  AA = rSav[4];
+  is.nHouseSystem = hs;
+  if (!rlst.fFast) {
+    ciCore = ciSav;
+    CastChart(nContext);
+  }
+  return fRet;
+}
+
+
+// Evaluate a cubic Hermite spline between two samples, given the value and
+// derivative at each, at fraction t across an interval of length h. Also
+// return the derivative at that point.
+
+real RHermite(real p0, real m0, real p1, real m1, real h, real t, real *pm)
+{
+  real t2 = t*t, t3 = t2*t;
+
+  *pm = ((6.0*t2 - 6.0*t)*(p0 - p1) + (3.0*t2 - 4.0*t + 1.0)*h*m0 +
+    (3.0*t2 - 2.0*t)*h*m1) / h;
+  return (2.0*t3 - 3.0*t2 + 1.0)*p0 + (t3 - 2.0*t2 + t)*h*m0 +
+    (3.0*t2 - 2.0*t3)*p1 + (t3 - t2)*h*m1;
+}
+
+
+// Return whether object positions in charts cast with the current settings
+// can be interpolated between charts from their velocities. Not the case for
+// progressed charts, or harmonic charts and other settings which wrap
+// positions around discontinuously. If rgfIgnore is set, also require that
+// every object a full cast would compute is unrestricted within it, and isn't
+// a house based object, which circles the zodiac each day.
+
+flag FChartInterpolable(CONST byte *rgfIgnore)
+{
+  int obj;
+
+  if (!FCmSwissAny() || us.fVelocity || us.fProgress ||
+    us.rHarmonic != 1.0 || us.fDecan || us.nDwad > 0 || us.fNavamsa ||
+    us.fFlip || us.objRot1 != us.objRot2 || us.fObjRotWhole)
+    return fFalse;
+#ifdef EXPRESS
+  if (!us.fExpOff && (FSzSet(us.szExpObj) || FSzSet(us.szExpCast1) ||
+    FSzSet(us.szExpCast2)))
+    return fFalse;
+#endif
+  if (rgfIgnore != NULL)
+    for (obj = 0; obj <= is.nObj; obj++)
+      if (!ignore[obj] && (rgfIgnore[obj] || FBetween(obj, oFor, cuspHi)))
+        return fFalse;
+  return fTrue;
+}
+
+
+// Sample the positions and velocities of a set of objects over a range of
+// time, so that charts at any time in the range can be interpolated with
+// EphemSeriesCast() instead of being cast. rgfIgnore is an ignore[] style
+// mask of the objects wanted. The step between samples starts out based on
+// the fastest object's speed, and is halved until interpolated positions in
+// the middle of every sample interval match directly cast ones to within
+// 1/100th of a second of arc. Return false if that can't be done in fewer
+// than cCastMax chart casts, or if positions can't be interpolated at all,
+// e.g. for house cusps which circle the zodiac each day, or for harmonic
+// charts and other settings which wrap positions around discontinuously.
+
+flag FEphemSeries(TSR *ptsr, CONST byte *rgfIgnore, real jd1, real jd2,
+  int cCastMax)
+{
+  CI ciSav = ciCore;
+  CP cpSav = cp0;
+  real rgrLon[objMax], rgrLat[objMax], rSpeed = 0.0, rErr, jd, *rgr;
+  int cob = 0, cSample, cCheck, cCast = 0, obj, i, j, k;
+  flag fRet = fFalse;
+
+  ClearB((pbyte)ptsr, sizeof(TSR));
+  if (!FChartInterpolable(NULL) || jd2 <= jd1)
+    return fFalse;
+  for (obj = 0; obj <= is.nObj; obj++) if (!rgfIgnore[obj]) {
+    if (FBetween(obj, oFor, cuspHi))
+      return fFalse;
+    ptsr->rgobj[cob++] = obj;
+  }
+  if (cob <= 0)
+    return fFalse;
+  ptsr->cob = cob;
+
+  // Start with a step that has the fastest object move a few degrees.
+  SetCoreJulian(jd1);
+  CastChartPart(-1, rgfIgnore, cfSpeed | cfDist);
+  cCast++;
+  for (i = 0; i < cob; i++)
+    rSpeed = Max(rSpeed, RAbs(ret[ptsr->rgobj[i]]));
+  ptsr->jd = jd1;
+  ptsr->dStep = Min(8.0, 4.0 / Max(rSpeed, rSmall));
+
+  loop {
+    cSample = (int)((jd2 - jd1) / ptsr->dStep) + 2;
+    cCheck = cSample - 1;
+    if (cCast + cSample + cCheck > cCastMax)
+      break;
+    ptsr->cSample = cSample;
+    DeallocatePIf(ptsr->rgr);
+    ptsr->rgr = rgr = RgAllocate(cTsr * cob * cSample, real,
+      "ephemeris series");
+    if (rgr == NULL)
+      break;
+
+    // Sample each object at each step.
+    for (j = 0; j < cSample; j++) {
+      SetCoreJulian(jd1 + (real)j * ptsr->dStep);
+      CastChartPart(-1, rgfIgnore, cfSpeed | cfDist);
+      cCast++;
+      for (i = 0; i < cob; i++) {
+        obj = ptsr->rgobj[i];
+        rgr[ITsr(ptsr, tsObj,    i, j)] = planet[obj];
+        rgr[ITsr(ptsr, tsDir,    i, j)] = ret[obj];
+        rgr[ITsr(ptsr, tsAlt,    i, j)] = planetalt[obj];
+        rgr[ITsr(ptsr, tsDiralt, i, j)] = retalt[obj];
+        rgr[ITsr(ptsr, tsDist,   i, j)] = cp0.dist[obj];
+        rgr[ITsr(ptsr, tsDirlen, i, j)] = retlen[obj];
+      }
+    }
+
+    // Distances don't come with a matching velocity, so estimate slopes.
+    for (i = 0; i < cob; i++)
+      for (j = 0; j < cSample; j++) {
+        k = Max(j-1, 0);
+        rgr[ITsr(ptsr, tsDistVel, i, j)] =
+          (rgr[ITsr(ptsr, tsDist, i, Min(j+1, cSample-1))] -
+          rgr[ITsr(ptsr, tsDist, i, k)]) /
+          ((real)(Min(j+1, cSample-1) - k) * ptsr->dStep);
+      }
+
+    // Check interpolated positions against directly cast ones, in the
+    // middle of each interval, stopping at the first one that's too far off.
+    rErr = 0.0;
+    for (k = 0; k < cCheck && rErr <= 1.0/360000.0; k++) {
+      jd = jd1 + ((real)k + 0.5) * ptsr->dStep;
+      SetCoreJulian(jd);
+      CastChartPart(-1, rgfIgnore, cfSpeed | cfDist);
+      cCast++;
+      for (i = 0; i < cob; i++) {
+        obj = ptsr->rgobj[i];
+        rgrLon[obj] = planet[obj]; rgrLat[obj] = planetalt[obj];
+      }
+      EphemSeriesCast(ptsr, jd);
+      for (i = 0; i < cob; i++) {
+        obj = ptsr->rgobj[i];
+        rErr = Max(rErr, MinDistance(rgrLon[obj], planet[obj]));
+        rErr = Max(rErr, RAbs(rgrLat[obj] - planetalt[obj]));
+      }
+    }
+    if (rErr <= 1.0/360000.0) {
+      fRet = fTrue;
+      break;
+    }
+    ptsr->dStep /= 2.0;
+  }
+
+  if (!fRet) {
+    DeallocatePIf(ptsr->rgr);
+    ptsr->rgr = NULL;
+  }
+  ciCore = ciSav;
+  cp0 = cpSav;
+  return fRet;
+}
+
+
+// Set the positions and velocities of the objects in an ephemeris series
+// created with FEphemSeries() to their interpolated values at a given time.
+// Other parts of the current chart aren't changed.
+
+void EphemSeriesCast(CONST TSR *ptsr, real jd)
+{
+  CONST real *rgr = ptsr->rgr;
+  real r, t, h = ptsr->dStep, p0, p1;
+  int i, j, obj;
+
+  r = (jd - ptsr->jd) / h;
+  j = (int)RFloor(r);
+  j = Max(j, 0); j = Min(j, ptsr->cSample-2);
+  t = r - (real)j;
+  for (i = 0; i < ptsr->cob; i++) {
+    obj = ptsr->rgobj[i];
+    p0 = rgr[ITsr(ptsr, tsObj, i, j)];
+    p1 = p0 + MinDifference(p0, rgr[ITsr(ptsr, tsObj, i, j+1)]);
+    planet[obj] = Mod(RHermite(p0, rgr[ITsr(ptsr, tsDir, i, j)], p1,
+      rgr[ITsr(ptsr, tsDir, i, j+1)], h, t, &ret[obj]));
+    planetalt[obj] = RHermite(rgr[ITsr(ptsr, tsAlt, i, j)],
+      rgr[ITsr(ptsr, tsDiralt, i, j)], rgr[ITsr(ptsr, tsAlt, i, j+1)],
+      rgr[ITsr(ptsr, tsDiralt, i, j+1)], h, t, &retalt[obj]);
+    cp0.dist[obj] = RHermite(rgr[ITsr(ptsr, tsDist, i, j)],
+      rgr[ITsr(ptsr, tsDistVel, i, j)], rgr[ITsr(ptsr, tsDist, i, j+1)],
+      rgr[ITsr(ptsr, tsDistVel, i, j+1)], h, t, &r);
+    retlen[obj] = rgr[ITsr(ptsr, tsDirlen, i, j)] +
+      (rgr[ITsr(ptsr, tsDirlen, i, j+1)] -
+      rgr[ITsr(ptsr, tsDirlen, i, j)]) * t;
+  }
+}
+
+
+// Set the positions and velocities of the objects in the current chart to
+// ones interpolated between two charts cast at the start and end of a time
+// segment h days long, at fraction t through it. rgfIgnore is the object
+// mask the two charts were cast with. If fAll is set, only do so if every
+// object a full cast would compute can be interpolated. Return false if the
+// chart can't be interpolated, in which case it should be cast instead.
+
+flag FInterpolateChart(CONST CP *pcpA, CONST CP *pcpB, CONST byte *rgfIgnore,
+  real h, real t, flag fAll)
+{
+  PT3R pt;
+  real p0, p1, r;
+  int obj;
+
+  // Topocentric parallax varies daily, which velocities don't account for.
+  if (!FChartInterpolable(fAll ? rgfIgnore : NULL) || us.fTopoPos)
+    return fFalse;
+
+  for (obj = 0; obj <= is.nObj; obj++) {
+    if (rgfIgnore[obj] || FBetween(obj, oFor, cuspHi))
+      continue;
+    p0 = pcpA->obj[obj];
+    p1 = p0 + MinDifference(p0, pcpB->obj[obj]);
+    planet[obj] = Mod(RHermite(p0, pcpA->dir[obj], p1, pcpB->dir[obj], h, t,
+      &ret[obj]));
+    planetalt[obj] = RHermite(pcpA->alt[obj], pcpA->diralt[obj],
+      pcpB->alt[obj], pcpB->diralt[obj], h, t, &retalt[obj]);
+    retlen[obj] = pcpA->dirlen[obj] +
+      (pcpB->dirlen[obj] - pcpA->dirlen[obj]) * t;
+    cp0.dist[obj] = pcpA->dist[obj] + (pcpB->dist[obj] - pcpA->dist[obj]) * t;
+
+    // Coordinates in space move along the chord between the two charts, so
+    // stretch them back out to the interpolated distance.
+    PtVec(pt, pcpA->pt[obj], pcpB->pt[obj]);
+    PtMul(pt, t);
+    PtAdd2(pt, pcpA->pt[obj]);
+    r = PtLen(pt);
+    if (r > 0.0) {
+      PtMul(pt, cp0.dist[obj] / r);
+    }
+    space[obj] = pt;
+  }
+  return fTrue;
+}
+
+
 // Calculate the position of each planet with respect to the Gauquelin
 // sectors. This is used by the sector charts. Fill out the planet position
 // array where one degree means 1/10 the way across one of the 36 sectors.
@@ -1744,13 +2356,52 @@ flag FAcceptAspect(int obj1, int asp, int obj2)
 }
 
 
+// Fill out a table over the range of angles two objects can be apart, giving
+// for each slice of it the least distance from anywhere within the slice to
+// the nearest aspect angle being checked. Aspect grids can use this to skip
+// pairs of objects not within orb of any aspect, without checking each one.
+// Return false if orbs can be adjusted such that the table can't be used.
+
+flag FAspectGap(AG *pag)
+{
+  int asp, i;
+  real rLo, rHi, rAng, r;
+
+#ifdef EXPRESS
+  if (!us.fExpOff && FSzSet(us.szExpAsp))
+    return fFalse;
+#endif
+  pag->rOrbMax = 0.0;
+  for (i = 0; i < cAspGap; i++)
+    pag->rgr[i] = rLarge;
+  for (asp = 1; asp <= us.nAsp; asp++) {
+    if (FIgnoreA(asp))
+      continue;
+    pag->rOrbMax = Max(pag->rOrbMax, rAspOrb[asp]);
+    rAng = rAspAngle[asp];
+    for (i = 0; i < cAspGap; i++) {
+      rLo = (real)i * rDegHalf / (real)cAspGap;
+      rHi = (real)(i+1) * rDegHalf / (real)cAspGap;
+      r = rAng < rLo ? rLo - rAng : (rAng > rHi ? rAng - rHi : 0.0);
+      pag->rgr[i] = Min(pag->rgr[i], r);
+    }
+  }
+  // Leave some slack for rounding when angles are mapped to slices.
+  for (i = 0; i < cAspGap; i++)
+    pag->rgr[i] = Max(pag->rgr[i] - rSmall, 0.0);
+  return fTrue;
+}
+
+
 // This is a subprocedure of FCreateGrid() and FCreateGridRelation(). Given
 // two planets, determine what aspect, if any, is present between them, and
-// determine the aspect's orb too.
+// determine the aspect's orb too. pag is an optional gap table from
+// FAspectGap() for the current aspect settings.
 
 int GetAspect(CONST real *planet1, CONST real *planet2,
   CONST real *planetalt1, CONST real *planetalt2,
-  CONST real *ret1, CONST real *ret2, int i, int j, real *prOrb)
+  CONST real *ret1, CONST real *ret2, int i, int j, real *prOrb,
+  CONST AG *pag)
 {
   int asp;
   real rAngle, rAngle3D, rDiff, rOrb, ret1a;
@@ -1761,6 +2412,19 @@ int GetAspect(CONST real *planet1, CONST real *planet2,
     rAngle3D = SphDistance(planet1[i], planetalt1[i],
       planet2[j], planetalt2[j]);
 
+  // Skip the aspect checks if the angle is too far from every aspect angle
+  // for even the widest orb the two objects could have.
+  if (pag != NULL) {
+    rDiff = !us.fAspect3D ? rAngle : rAngle3D;
+    asp = (int)(rDiff * (real)cAspGap / rDegHalf);
+    asp = Max(asp, 0); asp = Min(asp, cAspGap-1);
+    rOrb = Min(pag->rOrbMax, rObjOrb[Min(i, oNorm1)]);
+    rOrb = Min(rOrb, rObjOrb[Min(j, oNorm1)]);
+    rOrb += rObjAdd[Min(i, oNorm1)] + rObjAdd[Min(j, oNorm1)];
+    if (pag->rgr[asp] >= rOrb)
+      return 0;
+  }
+
   // Check each aspect angle to see if it applies.
   for (asp = 1; asp <= us.nAsp; asp++) {
     if (!FAcceptAspect(i, asp, j))
@@ -1969,10 +2633,13 @@ flag FCreateGrid(flag fFlip)
 {
   int x, y, k, asp;
   real l, rOrb, rT;
+  AG ag;
+  CONST AG *pag;
 
   if (!FEnsureGrid())
     return fFalse;
   ClearB((pbyte)grid, sizeof(GridInfo));
+  pag = !us.fParallel && !us.fDistance && FAspectGap(&ag) ? &ag : NULL;
 
   for (y = 0; y <= is.nObj; y++) if (!FIgnore(y))
     for (x = 0; x <= is.nObj; x++) if (!FIgnore(x))
@@ -1988,7 +2655,7 @@ flag FCreateGrid(flag fFlip)
           asp = GetDistance(space, space, retlen, retlen, x, y, &rOrb);
         else
           asp = GetAspect(planet, planet, planetalt, planetalt,
-            ret, ret, x, y, &rOrb);
+            ret, ret, x, y, &rOrb, pag);
         grid->n[x][y] = asp;
         grid->v[x][y] = asp > 0 ? rOrb : 0.0;
       } else if (fFlip ? x < y : x > y) {
@@ -2019,10 +2686,14 @@ flag FCreateGridRelation(flag fMidpoint)
 {
   int x, y, k, asp;
   real l, rOrb, rT;
+  AG ag;
+  CONST AG *pag;
 
   if (!FEnsureGrid())
     return fFalse;
   ClearB((pbyte)grid, sizeof(GridInfo));
+  pag = !fMidpoint && !us.fParallel && !us.fDistance && FAspectGap(&ag) ?
+    &ag : NULL;
 
   for (y = 0; y <= is.nObj; y++) if (!FIgnore(y) || !FIgnore2(y))
     for (x = 0; x <= is.nObj; x++) if (!FIgnore(x) || !FIgnore2(x))
@@ -2037,7 +2708,7 @@ flag FCreateGridRelation(flag fMidpoint)
             y, x, &rOrb);
         else
           asp = GetAspect(cp1.obj, cp2.obj, cp1.alt, cp2.alt,
-            cp1.dir, cp2.dir, y, x, &rOrb);
+            cp1.dir, cp2.dir, y, x, &rOrb, pag);
         grid->n[x][y] = asp;
         grid->v[x][y] = asp > 0 ? rOrb : 0.0;
       } else {
@@ -2252,6 +2923,60 @@ int NCheckEclipseAny(int obj1, int asp, int obj2, real *prEclipse)
 }
 
 
+// Return whether the eclipse catalog covers the given span of Julian days
+// (UT), loading it from the -Yuc cache file the first time if need be.
+
+flag FEclipseCatalogCovers(real jd1, real jd2)
+{
+  if (is.rgei == NULL && is.cei == 0 && FSzSet(us.szEclipseFile))
+    if (!FInputEclipse(us.szEclipseFile))
+      is.cei = -1;
+  return is.rgei != NULL && is.jdEclipse1 <= jd1 && jd2 <= is.jdEclipse2;
+}
+
+
+// Return whether the eclipse catalog shows there's definitely no eclipse or
+// occultation for an aspect between two objects at a Julian day (UT). The
+// catalog only covers geocentric solar and lunar eclipses, and occultations
+// of the planets by the Moon. If it returns false, NCheckEclipseAny() or the
+// like still needs to be called with a chart cast at the time to check.
+
+flag FEclipseCatalogNone(int obj1, int asp, int obj2, real jd)
+{
+  int obj, lo, hi, i;
+
+  if (us.objCenter != oEar || !FEclipseCatalogCovers(jd - 1.0, jd + 1.0))
+    return fFalse;
+  if (asp == aOpp && obj1 == oSun && obj2 == oMoo)
+    obj = oMoo;
+  else if (asp != aCon)
+    return fFalse;
+  else {
+    if (obj1 == oMoo)
+      SwapN(obj1, obj2);
+    if (obj2 != oMoo || !FBetween(obj1, oSun, oPlu) || obj1 == oMoo)
+      return fFalse;
+    obj = obj1;
+  }
+
+  // Binary search for the first event less than a day before the time, and
+  // see if any event of the same kind around then spans it.
+  lo = 0; hi = is.cei;
+  while (lo < hi) {
+    i = (lo + hi) >> 1;
+    if (is.rgei[i].jd < jd - 1.0)
+      lo = i + 1;
+    else
+      hi = i;
+  }
+  for (i = lo; i < is.cei && is.rgei[i].jd <= jd + 1.0; i++)
+    if (is.rgei[i].obj == obj && FBetween(jd,
+      is.rgei[i].jdBeg - rEclipseMargin, is.rgei[i].jdEnd + rEclipseMargin))
+      return fFalse;
+  return fTrue;
+}
+
+
 #ifdef SWISS
 // Check whether a solar eclipse is taking place at a particular location upon
 // the Earth. Detects partial, annular, and total solar eclipses. Called from
@@ -2303,6 +3028,135 @@ LDone:
   }
   return et;
 }
+
+
+// Search a window of Julian days (UT) for all solar eclipses, lunar eclipses,
+// and lunar occultations of the planets whose greatest moment falls within
+// it, storing them in the given array sorted by time. Return the number of
+// events found.
+
+int NEclipseWindow(real jd1, real jd2, EclipseInfo *rgei, int ceiMax)
+{
+  EclipseInfo ei;
+  real jd;
+  int obj, cei = 0, i;
+
+  for (obj = oSun; obj <= oPlu; obj++) {
+    // Start a bit early, so an event right at the start isn't skipped.
+    for (jd = jd1 - 1.0; cei < ceiMax && FSwissEclipseNext(obj, jd, jd2, &ei);
+      jd = ei.jd + 1.0) {
+      if (ei.jd < jd1)
+        continue;
+      for (i = cei; i > 0 && rgei[i-1].jd > ei.jd; i--)
+        rgei[i] = rgei[i-1];
+      rgei[i] = ei;
+      cei++;
+    }
+  }
+  return cei;
+}
+
+
+// Build a catalog of all eclipses and occultations between two Julian days
+// (UT) into is.rgei, unless the catalog in memory or cache file already
+// covers them. The span is split into windows of years, which are searched
+// independently by parallel workers and merged in order. Save the result to
+// the -Yuc cache file if one is set.
+
+flag FEclipseCatalog(real jd1, real jd2)
+{
+  EclipseInfo *rgei, *rgeiWin, *peiNew;
+  real dWin = rDayInYear * (real)nEclipseWin;
+  int cWin, iWin, cw, iw = 0, cei = 0, ceiAlloc, ceiWin, ceiMax, i, j;
+  flag fRet;
+#ifndef PC
+  int rgfd[cWorkerMax];
+#endif
+
+  if (FEclipseCatalogCovers(jd1, jd2))
+    return fTrue;
+  cWin = (int)((jd2 - jd1) / dWin);
+  if (jd1 + dWin * (real)cWin < jd2)
+    cWin++;
+  ceiMax = ceiAlloc = oPlu * ((int)(dWin / 27.0) + 2);
+  rgeiWin = RgAllocate(ceiMax, EclipseInfo, "eclipse window");
+  if (rgeiWin == NULL)
+    return fFalse;
+  rgei = RgAllocate(ceiAlloc, EclipseInfo, "eclipse catalog");
+  if (rgei == NULL) {
+    DeallocateP(rgeiWin);
+    return fFalse;
+  }
+
+  cw = NWorkerCount(cWin);
+#ifndef PC
+  if (cw > 1 && (iw = IForkWorkers(&cw, rgfd)) < 0 && cw <= 0) {
+    cw = 1;
+    iw = 0;
+  }
+
+  // Each worker searches every cw'th window, starting with its own index.
+  if (iw >= 0 && cw > 1) {
+    for (iWin = iw; iWin < cWin; iWin += cw) {
+      ceiWin = NEclipseWindow(jd1 + dWin * (real)iWin,
+        Min(jd1 + dWin * (real)(iWin+1), jd2), rgeiWin, ceiMax);
+      if (!FWriteWorker(rgfd[0], &ceiWin, sizeof(int)) ||
+        !FWriteWorker(rgfd[0], rgeiWin, sizeof(EclipseInfo) * ceiWin))
+        break;
+    }
+    EndWorker(rgfd[0]);
+  }
+#else
+  cw = 1;
+#endif
+
+  // Collect each window's events in order, either searching them directly
+  // or reading them from the worker that searched them.
+  for (iWin = 0; iWin < cWin; iWin++) {
+    if (iw >= 0)
+      ceiWin = NEclipseWindow(jd1 + dWin * (real)iWin,
+        Min(jd1 + dWin * (real)(iWin+1), jd2), rgeiWin, ceiMax);
+#ifndef PC
+    else if (!FReadWorker(rgfd[iWin % cw], &ceiWin, sizeof(int)) ||
+      !FReadWorker(rgfd[iWin % cw], rgeiWin, sizeof(EclipseInfo) * ceiWin))
+      break;
+#endif
+    if (cei + ceiWin > ceiAlloc) {
+      ceiAlloc = (cei + ceiWin) << 1;
+      peiNew = RgAllocate(ceiAlloc, EclipseInfo, "eclipse catalog");
+      if (peiNew == NULL)
+        break;
+      CopyRgb((pbyte)rgei, (pbyte)peiNew, sizeof(EclipseInfo) * cei);
+      DeallocateP(rgei);
+      rgei = peiNew;
+    }
+    // Skip any event already found at the end of the previous window.
+    for (i = 0; i < ceiWin; i++) {
+      for (j = cei-1; j >= 0 && rgei[j].jd > rgeiWin[i].jd - 1.0 &&
+        rgei[j].obj != rgeiWin[i].obj; j--)
+        ;
+      if (j < 0 || rgei[j].jd <= rgeiWin[i].jd - 1.0)
+        rgei[cei++] = rgeiWin[i];
+    }
+  }
+  fRet = (iWin >= cWin);
+#ifndef PC
+  if (iw < 0)
+    WaitWorkers(cw, rgfd);
+#endif
+  DeallocateP(rgeiWin);
+  if (!fRet) {
+    DeallocateP(rgei);
+    return fFalse;
+  }
+
+  DeallocatePIf(is.rgei);
+  is.rgei = rgei; is.cei = cei;
+  is.jdEclipse1 = jd1; is.jdEclipse2 = jd2;
+  if (FSzSet(us.szEclipseFile))
+    FOutputEclipse(us.szEclipseFile);
+  return fTrue;
+}
 #endif
 
 
@@ -2372,6 +3226,7 @@ void SwissEnsurePath()
 
   if (is.fSwissPathSet)
     return;
+  TraceBegin("Swiss Ephemeris path");
 
   // Get directory containing Astrolog executable.
 #ifdef WIN
@@ -2430,6 +3285,7 @@ void SwissEnsurePath()
     EPHE_DIR);
   swe_set_ephe_path(szPath);
   is.fSwissPathSet = fTrue;
+  TraceEnd();
 }
 
 
@@ -2472,6 +3328,7 @@ flag FSwissPlanet(int ind, real jd, int indCent,
   double jde, xx[6], xnasc[6], xndsc[6], xperi[6], xaphe[6], *px;
   char serr[AS_MAXCH], szErr[AS_MAXCH + cchSzDef];
   static int nSwissEph = 0;
+  static flag fEphOpen = fFalse;
   flag fHelio = (indCent != oEar);
 
   // Reset Swiss Ephemeris if changing computation method.
@@ -2556,6 +3413,8 @@ flag FSwissPlanet(int ind, real jd, int indCent,
     if (us.fTopoPos > 1)      // Special value for faster lookup.
       iflag &= ~SEFLG_SPEED;
   }
+  if (is.nCastSkip & cfSpeed)
+    iflag &= ~SEFLG_SPEED;
 
   // Compute position of planet or node/helion.
   if (jd != is.jdDeltaT) {
@@ -2565,8 +3424,15 @@ flag FSwissPlanet(int ind, real jd, int indCent,
   jde = jd + (us.rDeltaT == rInvalid ? is.rDeltaT : us.rDeltaT/86400.0);
   if (nPnt == 0) {
     if (indCent <= oSun || indCent > oNorm || FNodal(ind) || FNodal(indCent)) {
-      // Normal geocentric or heliocentric position.
+      // Normal geocentric or heliocentric position. The first one opens
+      // the ephemeris files, so time it for the -YL startup trace.
+      if (!fEphOpen)
+        TraceBegin("First ephemeris file read");
       nRet = swe_calc(jde, iobj, iflag, xx, serr);
+      if (!fEphOpen) {
+        TraceEnd();
+        fEphOpen = fTrue;
+      }
     } else {
       // Alternate position orbiting an unusual central object.
       if (indCent <= oPlu)
@@ -2663,19 +3529,13 @@ flag FSwissPlanet(int ind, real jd, int indCent,
 }
 
 
-// Compute house cusps and related variables like the Ascendant. Given a
-// Julian Day time, location, and house system, call Swiss Ephemeris to
-// compute them. This is similar to FSwissPlanet() in that it knows about
-// and translates between Astrolog and Swiss Ephemeris defintions.
+// Translate an Astrolog house system index to the Swiss Ephemeris house
+// system character, or 'A' for systems that Astrolog computes itself.
 
-void SwissHouse(real jd, real lon, real lat, int housesystem, real *asc,
-  real *mc, real *ra, real *vtx, real *ep, real *ob, real *off, real *nut)
+char ChSwissHouse(int housesystem)
 {
-  double cusp[cSign+1], ascmc[11], cuspr[cSign+1], ascmcr[11], rSid;
-  int i;
-  char serr[AS_MAXCH], ch;
+  char ch;
 
-  // Translate Astrolog house index to Swiss Ephemeris house character.
   // Don't do hsWhole houses ('W') yet, until after is.rSid computed.
   switch (housesystem) {
   case hsPlacidus:      ch = 'P'; break;
@@ -2700,26 +3560,58 @@ void SwissHouse(real jd, real lon, real lat, int housesystem, real *asc,
   case hsSavardA:       ch = 'J'; break;
   default:              ch = 'A'; break;
   }
+  return ch;
+}
+
+
+// Compute the parts of house calculation that depend on time but not on
+// location. Given a Julian Day time, return the Julian Day in UT and in
+// Ephemeris Time, the sidereal time at Greenwich (i.e. the ARMC at longitude
+// zero), the mean obliquity, and the nutation in longitude and obliquity.
+
+void SwissHouseTime(real jd, real *pjd, real *ptjde, real *parmc, real *peps,
+  real *nutlo)
+{
+  real tjde, eps;
+  int i;
+
   jd = JulianDayFromTime(jd);
   if (jd != is.jdDeltaT) {
     is.jdDeltaT = jd;
     is.rDeltaT = swe_deltat(jd);
   }
-  lon = -lon;
 
   // The following is largely copied from swe_houses().
-  double armc, eps, nutlo[2];
-  double tjde = jd +
-    (us.rDeltaT == rInvalid ? is.rDeltaT : us.rDeltaT/86400.0);
-
+  tjde = jd + (us.rDeltaT == rInvalid ? is.rDeltaT : us.rDeltaT/86400.0);
   eps = swi_epsiln(tjde, 0) * RADTODEG;
   swi_nutation(tjde, 0, nutlo);
   for (i = 0; i < 2; i++)
     nutlo[i] *= RADTODEG;
-  armc = lon;
+  *parmc = 0.0;
   if (!us.fGeodetic)
-    armc += swe_degnorm(swe_sidtime0(jd + (us.rDeltaT == rInvalid ? 0.0 :
+    *parmc = swe_degnorm(swe_sidtime0(jd + (us.rDeltaT == rInvalid ? 0.0 :
       us.rDeltaT/86400.0 - is.rDeltaT), eps + nutlo[1], nutlo[0]) * 15.0);
+  *pjd = jd; *ptjde = tjde; *peps = eps;
+}
+
+
+// Compute house cusps and related variables like the Ascendant. Given a
+// Julian Day time, location, and house system, call Swiss Ephemeris to
+// compute them. This is similar to FSwissPlanet() in that it knows about
+// and translates between Astrolog and Swiss Ephemeris defintions.
+
+void SwissHouse(real jd, real lon, real lat, int housesystem, real *asc,
+  real *mc, real *ra, real *vtx, real *ep, real *ob, real *off, real *nut)
+{
+  double cusp[cSign+1], ascmc[11], cuspr[cSign+1], ascmcr[11], rSid;
+  double armc, eps, nutlo[2], tjde;
+  int i;
+  char serr[AS_MAXCH], ch;
+
+  // Translate Astrolog house index to Swiss Ephemeris house character.
+  ch = ChSwissHouse(housesystem);
+  SwissHouseTime(jd, &jd, &tjde, &armc, &eps, nutlo);
+  armc += -lon;
   if (ch == 'I') {  // Need Sun declination for Sunshine houses.
     int flags = SEFLG_SPEED | SEFLG_EQUATORIAL;
     double xp[6];
@@ -2769,6 +3661,55 @@ void SwissHouse(real jd, real lon, real lat, int housesystem, real *asc,
 }
 
 
+// Set up a relocation sweep, computing the values needed to calculate house
+// cusps at the given time which are the same for every location.
+
+void SwissRelocTime(RLST *prlst, real t)
+{
+  real jd, tjde, nutlo[2];
+  double xp[6];
+
+  prlst->ch = ChSwissHouse(us.nHouseSystem);
+  SwissHouseTime(t, &jd, &tjde, &prlst->armc, &prlst->eps, nutlo);
+  prlst->eps += nutlo[1];
+  prlst->rSid = (us.fSidereal ? -swe_get_ayanamsa(tjde) +
+    us.rZodiacOffset : 0.0) + us.rZodiacOffsetAll;
+  if (us.fSidereal)
+    prlst->rSid -= nutlo[0];
+  if (prlst->ch == 'I') {
+    swe_calc_ut(jd, SE_SUN, SEFLG_SPEED | SEFLG_EQUATORIAL, xp, NULL);
+    prlst->decSun = xp[1];
+  }
+}
+
+
+// Compute house cusps at a location for a relocation sweep, given the time
+// dependent values from SwissRelocTime(). Return false if Swiss Ephemeris
+// doesn't do the house system, in which case chouse[] is computed instead.
+
+flag FSwissHouseArmc(CONST RLST *prlst, real lon, real lat, real *rgcusp)
+{
+  double cusp[cSign+1], ascmc[11];
+  int i;
+
+  ascmc[9] = prlst->decSun;
+  swe_houses_armc_ex2(Mod(prlst->armc - lon), lat, prlst->eps, prlst->ch,
+    cusp, ascmc, NULL, NULL, NULL);
+  if (prlst->ch != 'A') {
+    for (i = 1; i <= cSign; i++)
+      rgcusp[i-1] = Mod(cusp[i] + prlst->rSid);
+    return fTrue;
+  }
+  is.Asc = Mod(ascmc[SE_ASC]    + prlst->rSid);
+  is.MC  = Mod(ascmc[SE_MC]     + prlst->rSid);
+  is.Vtx = Mod(ascmc[SE_VERTEX] + prlst->rSid);
+  is.EP  = Mod(ascmc[SE_EQUASC] + prlst->rSid);
+  AA = lat;
+  ComputeHouses(us.nHouseSystem);
+  return fFalse;
+}
+
+
 CONST char *szStarNameSwiss[cStar+1] = {"",
   "", "", "Rigil Kentaurus", "", "", "", "", "", "", "",
   "", "", "", "", "", "", "", "", "", ",beCru",
@@ -3373,6 +4314,73 @@ flag FSwissPlanetData(real jd, int ind, real *rPhase, real *rDiam, real *rMag)
 }
 
 
+// Find the next solar eclipse (if obj is the Sun), lunar eclipse (if obj is
+// the Moon), or lunar occultation of a planet visible anywhere on Earth,
+// whose greatest moment is after Julian day jd and before jdMax (both UT).
+// A wrapper around swe_sol_eclipse_when_glob(), swe_lun_eclipse_when(), and
+// swe_lun_occult_when_glob(), which fills out the event's times and type.
+
+flag FSwissEclipseNext(int obj, real jd, real jdMax, EclipseInfo *pei)
+{
+  double tret[10], attr[20], geopos[20];
+  char serr[AS_MAXCH];
+  int iflag, nRet;
+
+  SwissEnsurePath();
+  iflag = (us.nSwissEph <= 0 ? SEFLG_SWIEPH :
+    (us.nSwissEph == 1 ? SEFLG_MOSEPH : SEFLG_JPLEPH));
+  if (obj == oSun) {
+    nRet = swe_sol_eclipse_when_glob(jd, iflag, 0, tret, 0, serr);
+    if (nRet > 0)
+      swe_sol_eclipse_where(tret[0], iflag, geopos, attr, serr);
+  } else if (obj == oMoo) {
+    nRet = swe_lun_eclipse_when(jd, iflag, 0, tret, 0, serr);
+    if (nRet > 0)
+      swe_lun_eclipse_how(tret[0], iflag, NULL, attr, serr);
+  } else if (FBetween(obj, oMer, oPlu)) {
+    // Check each conjunction in turn, since the Moon may not occult a
+    // planet at all for many years.
+    loop {
+      nRet = swe_lun_occult_when_glob(jd, obj-1, NULL, iflag, 0, tret,
+        SE_ECL_ONE_TRY, serr);
+      if (nRet != 0 || tret[0] >= jdMax)
+        break;
+      jd = tret[0] + 1.0;
+    }
+    if (nRet > 0)
+      swe_lun_occult_where(tret[0], obj-1, NULL, iflag, geopos, attr, serr);
+  } else
+    return fFalse;
+  if (nRet <= 0 || tret[0] >= jdMax)
+    return fFalse;
+
+  pei->obj = obj;
+  pei->jd = tret[0];
+  if (obj == oMoo) {
+    pei->jdBeg = tret[6]; pei->jdEnd = tret[7];
+    if (nRet & SE_ECL_TOTAL)
+      pei->et = etTotal;
+    else if (nRet & SE_ECL_PARTIAL)
+      pei->et = etPartial;
+    else
+      pei->et = attr[1] >= 1.0 ? etPenumbra2 : etPenumbra;
+    pei->mag = attr[pei->et >= etPartial ? 0 : 1];
+  } else {
+    pei->jdBeg = tret[2]; pei->jdEnd = tret[3];
+    if (nRet & (SE_ECL_TOTAL | SE_ECL_ANNULAR_TOTAL))
+      pei->et = etTotal;
+    else if (nRet & SE_ECL_ANNULAR)
+      pei->et = etAnnular;
+    else
+      pei->et = etPartial;
+    // For occultations, the Moon's diameter can be hundreds of times the
+    // object's, so limit the magnitude to the object's diameter covered.
+    pei->mag = obj == oSun ? attr[8] : Min(attr[0], 1.0);
+  }
+  return fTrue;
+}
+
+
 // Wrapper around Swiss Ephemeris function to convert an altitude above the
 // horizon to altitude when atmospheric refraction is taken into account.
 
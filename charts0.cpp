@@ -262,6 +262,12 @@ void DisplaySwitches(void)
   PrintS(" _Q: Prompt for more command switches after display finished.");
 #ifdef SWITCHES
   PrintS(" _Q0: Like _Q but prompt for additional switches on startup.");
+#endif
+#ifndef PC
+  PrintS(" _Qs <socket>: Serve charts for switch lines sent to Unix socket.");
+  PrintS(" _Qs0: Like _Qs but read switch lines from standard input.");
+  PrintS(" _Qb <file>: Run each line in file as a job in parallel workers.");
+  PrintS(" _Qb0 <file> <log>: Like _Qb but log how long each job took.");
 #endif
   PrintS(" _M <index>: Run the specified command switch macro.");
   PrintS(" _M0 <index> <string>: Define the specified command switch macro.");
@@ -318,6 +324,8 @@ void DisplaySwitches(void)
   PrintS(" _dpy <year>: Like _dp but search for aspects within entire year.");
   PrintS(" _dpY <year> <years>: Like _dp but search within number of years.");
   PrintS(" _dp[0y]n: Search for progressed aspects in current month/year.");
+  PrintS(" _dE <years>: List eclipses and occultations within years.");
+  PrintS(" _dE0 <years>: Like _dE but list as comma separated values.");
   PrintS(" _D: Like _d but display aspects by influence instead of time.");
   PrintS(" _B: Like _d but graph all aspects occurring in a day.");
   PrintS(" _B[m,y,Y]: Like _B but for entire month, year, or five years.");
@@ -415,6 +423,8 @@ void DisplaySwitches(void)
   PrintS(" _o <file> [..]: Write parameters of current chart to file.");
   PrintS(" _o0 <file> [..]: Like _o but output planet/house positions.");
   PrintS(" _ol <file>: Write current chart list to Astrolog chart list file.");
+  PrintS(" _ob <file>: Write chart list positions to columnar binary file.");
+  PrintS(" _oc <file>: Write positions of chart list to CSV file.");
   PrintS(" _oa <file>: Write current chart or chart list to AAF format file.");
   PrintS(" _oq <file>: Write current chart list to Quick*Chart format file.");
   PrintS(" _od <file>: Output program's current settings to switch file.");
@@ -422,6 +432,7 @@ void DisplaySwitches(void)
   PrintS(" _os <file>, > <file>: Redirect output of text charts to file.");
   PrintS(" _5: Set whether transit event charts autopopulate chart list.");
   PrintS(" _5e[2-4]: Display text charts for all charts in chart list.");
+  PrintS(" _5t: Search transits (_t) to all charts in chart list at once.");
   PrintS(" _5[dxynls]: Sort chart list by date, lon, lat, name, or city.");
   PrintS(
     " _5f <name> <city>: Filter chart list to charts containing substring.");
@@ -552,6 +563,7 @@ void DisplaySwitches(void)
   PrintS(" _k: Display text charts using Ansi characters and color.");
   PrintS(" _k0: Like _k but only use special characters, not Ansi color.");
   PrintS(" _kh: Text charts saved to file use HTML instead of Ansi codes.");
+  PrintS(" _kj: Output -v, -g, -a, -d, -t charts as JSON Lines records.");
 
   // If graphics features are compiled in, call an additional procedure to
   // display the command switches offered dealing with graphics options.
@@ -589,6 +601,7 @@ void DisplaySwitchesRare(void)
   PrintS(" _Ynn: Compute location of natural Lilith instead of true or mean.");
   PrintS(" _Yu: Display eclipse and occultation information in charts.");
   PrintS(" _Yu0: Like _Yu but detect maximum eclipse anywhere on Earth.");
+  PrintS(" _Yuc <file>: Set eclipse catalog cache file for searches.");
   PrintS(" _Yd: Display dates in D/M/Y instead of M/D/Y format.");
   PrintS(" _Yt: Display times in 24 hour instead of am/pm format.");
   PrintS(" _Yv: Display distance in metric instead of imperial units.");
@@ -762,10 +775,22 @@ void DisplaySwitchesRare(void)
   PrintS(" _YXf[tshoan] <0-9>: Select specific font to use for area.");
   PrintS(" _YXp <-1,0,1>: Set paper orientation for PostScript files.");
   PrintS(" _YXp0 <hor> <ver>: Set paper size for PostScript files.");
+  PrintS(" _YXs: Print drawing statistics after each graphics chart.");
+  PrintS(" _YXc <kb>: Set memory limit for cache of decoded glyphs.");
+  PrintS(" _YXn <frames>: Render animation frames to numbered bitmap files.");
+  PrintS(" _YXn0 <frames>: Render animation frames as raw RGB to one file.");
 #endif // GRAPH
   PrintS("\nSwitches to access obscure system options:");
   PrintS(" _YB: Make a beep sound at the time this switch is processed.");
   PrintS(" _Y0: Disable all chart text output.");
+  PrintS(" _YW <num>: Set number of parallel worker processes (0 is auto).");
+  PrintS(" _YN <num>: Set number of recently cast charts to cache.");
+  PrintS(" _YL: Print timing breakdown of program startup phases.");
+  PrintS(" _YL0 <msec>: Like _YL but fail if startup exceeds time budget.");
+#ifdef JPLWEB
+  PrintS(" _YH <url>: Set site to send JPL Horizons Web queries to.");
+  PrintS(" _YH0 <file>: Set file to cache JPL Horizons query positions in.");
+#endif
   PrintS(
     " _Y5[2-4]: Enumerate all charts in chart list via ~5Y AstroExpression.");
   PrintS(" _Y5i <string>: Set filter string for ADB XML file format load.");
@@ -1763,6 +1788,7 @@ void DisplaySwitchesX(void)
   PrintS(" _XL[1-5]: Like _XL but set how to color cities (when _XA is on).");
 #endif
   PrintS(" _XC: Draw house boundaries or alternate info in certain charts.");
+  PrintS(" _XH [<object>]: Color astro-graph map by relocated house of object.");
   PrintS(" _X1 <object>: Rotate wheel charts so object is at left edge.");
   PrintS(" _X2 <object>: Rotate wheel charts so object is at top edge.");
 #ifdef X11
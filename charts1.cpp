@@ -587,15 +587,28 @@ flag FPrintAspectConfig(int ac, int i1, int i2, int i3, int i4)
 
 
 // Scan the aspect grid of a chart and print out any major configurations,
-// as specified with the -g0 switch.
+// as specified with the -g0 switch. Every configuration is a chain of aspects
+// from i to j to k (to l), so only the objects aspecting the previous one in
+// the chain need to be checked, which skips most combinations of objects.
 
 void DisplayAspectConfigs(void)
 {
-  int cac = 0, i, j, k, l;
+  byte adj[objMax][objMax];
+  int cadj[objMax], cac = 0, i, j, k, l, j0, k0, l0;
+
+  // List the objects each object has any aspect with, in index order. The
+  // diagonal of the grid isn't an aspect, but is included as before.
+  for (i = 0; i <= is.nObj; i++) {
+    cadj[i] = 0;
+    if (!FIgnore(i))
+      for (j = 0; j <= is.nObj; j++)
+        if (!FIgnore(j) && grid->n[Min(i, j)][Max(i, j)] != 0)
+          adj[i][cadj[i]++] = j;
+  }
 
   for (i = 0; i <= is.nObj; i++) if (!FIgnore(i))
-    for (j = 0; j <= is.nObj; j++) if (j != i && !FIgnore(j))
-      for (k = 0; k <= is.nObj; k++) if (k != i && k != j && !FIgnore(k)) {
+    for (j0 = 0; j0 < cadj[i]; j0++) if ((j = adj[i][j0]) != i)
+      for (k0 = 0; k0 < cadj[j]; k0++) if ((k = adj[j][k0]) != i && k != j) {
         if (!(us.objRequire >= 0 &&
           i != us.objRequire && j != us.objRequire && k != us.objRequire)) {
 
@@ -633,7 +646,8 @@ void DisplayAspectConfigs(void)
             cac += FPrintAspectConfig(acY, i, j, k, -1);
           }
         }
-        for (l = 0; l <= is.nObj; l++) if (!FIgnore(l)) {
+        for (l0 = 0; l0 < cadj[k]; l0++) {
+          l = adj[k][l0];
           if (us.objRequire >= 0 && i != us.objRequire &&
             j != us.objRequire && k != us.objRequire && l != us.objRequire)
             continue;
@@ -1075,6 +1089,16 @@ void ChartAspect(void)
     rPowSum += phi;
     ca[ahi]++;
     co[j]++; co[i]++;
+    if (us.fTextJSON) {                      // Output a record if -kj set.
+      PrintJSONBegin("aspect");
+      PrintJSONN("count", count);
+      PrintJSONN("obj1", i); PrintJSONSz("name1", szObjDisp[i]);
+      PrintJSONN("obj2", j); PrintJSONSz("name2", szObjDisp[j]);
+      PrintJSONN("n", ahi); PrintJSONSz("aspect", SzAspectAbbrev(ahi));
+      PrintJSONR("v", grid->v[j][i]); PrintJSONR("power", phi);
+      PrintJSONEnd();
+      continue;
+    }
 #ifdef INTERPRET
     if (us.fInterpret) {                     // Interpret it if -I in effect.
       InterpretAspect(j, i);
@@ -1103,7 +1127,7 @@ void ChartAspect(void)
     PrintSz(" - power: ");
     sprintf(sz, us.fSeconds ? "%7.4f" : "%5.2f", phi);
     PrintSz(sz);
-    PrintInDayEvent(j, ahi, i, -1);
+    PrintInDayEvent(j, ahi, i, -1, us.fEclipse);
   }
 
 #ifdef EXPRESS
@@ -1114,7 +1138,8 @@ void ChartAspect(void)
     ParseExpression(us.szExpAspSumm);
   }
 #endif
-  PrintAspectSummary(ca, co, count, rPowSum);
+  if (!us.fTextJSON)
+    PrintAspectSummary(ca, co, count, rPowSum);
 }
 
 
@@ -2606,7 +2631,7 @@ flag ChartMoons()
           sprintf(sz, "%02d\"", NAbs((int)(rOrb*3600.0))%60); PrintSz(sz);
         }
         us.fInterpret = fFalse;
-        PrintInDayEvent(j, asp, m, -1);
+        PrintInDayEvent(j, asp, m, -1, us.fEclipse);
         us.fInterpret = fInterpretSav;
 #ifdef INTERPRET
         if (us.fInterpret)
@@ -2685,7 +2710,7 @@ flag ChartMoons()
           sprintf(sz, "%02d\"", NAbs((int)(rOrb*3600.0))%60); PrintSz(sz);
         }
         us.fInterpret = fFalse;
-        PrintInDayEvent(i, asp, m, -1);
+        PrintInDayEvent(i, asp, m, -1, us.fEclipse);
         us.fInterpret = fInterpretSav;
 #ifdef INTERPRET
         if (us.fInterpret)
@@ -2707,6 +2732,140 @@ flag ChartMoons()
 }
 
 
+// Like PrintChart() but output JSON Lines records instead of text, one JSON
+// object per line, as done with the -kj switch. Supported are the -v object
+// listing, -g aspect grid, -a aspect list, -d events in a day, and -t
+// transit searches. Each chart starts with a "chart" record giving its time
+// and place, and the records of each chart type then follow.
+
+void PrintChartJSON(flag fProg)
+{
+  char sz[cchSzDef];
+  CONST char *szSkip = NULL;
+  int i, j, i0, j0, k;
+  flag fRel = us.nRel <= rcDual;
+
+  // Chart information record.
+  PrintJSONBegin("chart");
+  PrintJSONSz("name", FSzSet(ciMain.nam) ? ciMain.nam : "");
+  PrintJSONSz("loc", FSzSet(ciMain.loc) ? ciMain.loc : "");
+  PrintJSONN("mon", Mon); PrintJSONN("day", Day); PrintJSONN("yea", Yea);
+  PrintJSONR("tim", Tim); PrintJSONR("dst", Dst); PrintJSONR("zon", Zon);
+  PrintJSONR("lon", Lon); PrintJSONR("lat", Lat);
+  PrintJSONR("jd", JulianDayFromTime(is.T));
+  PrintJSONEnd();
+
+  // Other chart types have no JSON form. Note the first one requested, so
+  // -v is only assumed if none of them were asked for either.
+  if (us.fWheel)              szSkip = "w";
+  else if (us.fMidpoint)      szSkip = "m";
+  else if (us.fHorizon)       szSkip = "Z";
+  else if (us.fOrbit)         szSkip = "S";
+  else if (us.fSector)        szSkip = "l";
+  else if (us.fCalendar)      szSkip = "K";
+  else if (us.fInfluence)     szSkip = "j";
+  else if (us.fEsoteric)      szSkip = "7";
+  else if (us.fAstroGraph)    szSkip = "L";
+  else if (us.fEphemeris)     szSkip = "E";
+  else if (us.fArabic)        szSkip = "P";
+  else if (us.fHorizonSearch) szSkip = "Zd";
+  else if (us.fInDayInf)      szSkip = "D";
+  else if (us.fInDayGra)      szSkip = "B";
+  else if (us.fTransitInf)    szSkip = "T";
+  else if (us.fTransitGra)    szSkip = "V";
+  else if (us.fMoonChart)     szSkip = "8";
+  else if (us.fExoTransit)    szSkip = "Ux";
+  else if (us.fEclipseList)   szSkip = "dE";
+#ifdef ATLAS
+  else if (us.fAtlasLook)     szSkip = "N";
+  else if (us.fAtlasNear)     szSkip = "Nl";
+  else if (us.fZoneChange)    szSkip = "Nz";
+#endif
+
+  if (!us.fListing && !us.fGrid && !us.fAspList && !us.fInDay &&
+    !us.fTransit && szSkip == NULL)
+    us.fListing = fTrue;    // Assume -v if nothing else indicated.
+
+  // Object listing records, from the chart's CP positions.
+  if (us.fListing && !fRel) {
+    for (i0 = 0; i0 <= is.nObj; i0++) {
+      i = rgobjList[i0];
+      if (FIgnore(i))
+        continue;
+      PrintJSONBegin("object");
+      PrintJSONN("id", i); PrintJSONSz("name", szObjDisp[i]);
+      PrintJSONR("obj", planet[i]); PrintJSONR("alt", planetalt[i]);
+      PrintJSONR("dir", ret[i]); PrintJSONR("diralt", retalt[i]);
+      PrintJSONR("dist", cp0.dist[i]); PrintJSONR("dirlen", retlen[i]);
+      PrintJSONN("sign", SFromZ(planet[i])); PrintJSONN("house", inhouse[i]);
+      PrintJSONEnd();
+    }
+    for (i = 1; i <= cSign; i++) {
+      PrintJSONBegin("cusp");
+      PrintJSONN("house", i); PrintJSONR("cusp", chouse[i]);
+      PrintJSONEnd();
+    }
+  } else if (us.fListing)
+    szSkip = "v";
+
+  // Aspect grid records, from the GridInfo aspect and midpoint cells.
+  if (us.fGrid && !fRel) {
+    if (!FCreateGrid(fFalse))
+      return;
+    for (i0 = 0; i0 <= is.nObj; i0++) {
+      i = rgobjList[i0];
+      if (FIgnore(i))
+        continue;
+      for (j0 = 0; j0 <= is.nObj; j0++) {
+        j = rgobjList[j0];
+        if (FIgnore(j) || j == i || (k = grid->n[i][j]) <= 0)
+          continue;
+        PrintJSONBegin(i < j ? "grid" : "midpoint");
+        PrintJSONN("obj1", i); PrintJSONSz("name1", szObjDisp[i]);
+        PrintJSONN("obj2", j); PrintJSONSz("name2", szObjDisp[j]);
+        if (i < j) {
+          PrintJSONN("n", k); PrintJSONSz("aspect", SzAspectAbbrev(k));
+          PrintJSONR("v", grid->v[i][j]);
+        } else {
+          PrintJSONN("n", k);
+          PrintJSONR("v", grid->v[i][j]);
+          PrintJSONR("pos", ZFromS(k) + grid->v[i][j]);
+        }
+        PrintJSONEnd();
+      }
+    }
+  } else if (us.fGrid)
+    szSkip = "g";
+
+  // Aspect list records, in the same order as the -a chart.
+  if (us.fAspList && !fRel) {
+    if (!FCreateGrid(fFalse))
+      return;
+    ChartAspect();
+  } else if (us.fAspList)
+    szSkip = "a";
+
+  // Event and transit records, output by the searches as they're found.
+  if (us.fInDay)
+    ChartInDaySearch(fProg);
+  if (us.fTransit) {
+    if (us.fListTransit && !fProg && is.cci > 0)
+      szSkip = "5t";
+    else {
+      if (us.fListTransit && is.cci > 0)
+        PrintWarning("Transit searches to every chart in the chart list (-5t) "
+          "don't support progressed charts (-tp).");
+      ChartTransitSearch(fProg);
+    }
+  }
+  if (szSkip != NULL) {
+    sprintf(sz, "JSON output (-kj) isn't supported for the -%s chart "
+      "in this mode.", szSkip);
+    PrintWarning(sz);
+  }
+}
+
+
 // Another important procedure: Display any of the types of (text) charts that
 // the user specified they wanted, by calling the appropriate routines.
 
@@ -2715,6 +2874,10 @@ void PrintChart(flag fProg)
   int fCall = fFalse, nSav;
   flag fHaveGrid = fFalse;
 
+  if (us.fTextJSON) {
+    PrintChartJSON(fProg);
+    return;
+  }
   if (us.fListing) {
     if (is.fMult)
       PrintL2();
@@ -2880,8 +3043,15 @@ void PrintChart(flag fProg)
     is.fMult = fTrue;
   }
   if (us.fTransit) {
-    PrintHeader(is.fMult ? -1 : 1);
-    ChartTransitSearch(fProg);
+    if (us.fListTransit && !fProg && is.cci > 0)
+      ChartTransitSearchList(is.fMult);
+    else {
+      if (us.fListTransit && is.cci > 0)
+        PrintWarning("Transit searches to every chart in the chart list (-5t) "
+          "don't support progressed charts (-tp).");
+      PrintHeader(is.fMult ? -1 : 1);
+      ChartTransitSearch(fProg);
+    }
     is.fMult = fTrue;
   }
   if (us.fTransitInf) {
@@ -2926,6 +3096,12 @@ void PrintChart(flag fProg)
     ChartExoplanet(fFalse);
     is.fMult = fTrue;
   }
+  if (us.fEclipseList) {
+    if (!us.fEclipseCSV)
+      PrintHeader(is.fMult ? -1 : 1);
+    ChartEclipse();
+    is.fMult = fTrue;
+  }
 
   if (!is.fMult) {          // Assume the -v chart if user
     us.fListing = fTrue;    // didn't indicate anything.
@@ -426,6 +426,37 @@ void ChartMidpointRelation(void)
 }
 
 
+#ifndef PC
+// Cast the current chart in a new worker process, for one slot of a
+// relationship chart. Return the pipe to read the worker's results from, or
+// -1 if the worker couldn't be started. The worker sends the chart's time and
+// Midheaven, followed by all its positions. Anything the worker would print,
+// such as warnings the parent will print too, is thrown away.
+
+int IForkCastWorker(int nContext)
+{
+  int cw = 1, fd, fdNull;
+  real rgr[2];
+
+  if (IForkWorkers(&cw, &fd) < 0)
+    return cw > 0 ? fd : -1;
+  fdNull = open("/dev/null", O_WRONLY);
+  if (fdNull >= 0) {
+    dup2(fdNull, 1);
+    dup2(fdNull, 2);
+    close(fdNull);
+  }
+  us.fNoDisplay = fTrue;
+  rgr[0] = CastChart(nContext);
+  rgr[1] = is.MC;
+  FWriteWorker(fd, rgr, sizeof(rgr));
+  FWriteWorker(fd, &cp0, sizeof(CP));
+  EndWorker(fd);
+  return -1;
+}
+#endif
+
+
 // Calculate any of the various kinds of relationship charts. This involves
 // computing and storing the planet and house positions for the "core" and
 // "second" charts, and then combining them in the main single chart in the
@@ -437,11 +468,24 @@ void CastRelation(void)
   int i, j, cChart;
   real ratio, t1, t2, t, rSav;
   flag fSav;
+#ifndef PC
+  int rgfd[cRing+1], cw = 0, cwMax;
+  real rgr[2];
+#endif
 
   // Cast the six charts.
 
   fSav = us.fProgress;
   cChart = 2 - (FBetween(us.nRel, rcHexaWheel, rcTriWheel) ? us.nRel+1 : 0);
+#ifndef PC
+  // Each chart is independent, so all but the last may be cast by worker
+  // processes, started as soon as that chart's settings are in place. The
+  // last chart is cast here, leaving the same state as casting them in turn.
+  // A single cast usually takes less time than starting a process, so only
+  // do so if asked for with -YW, and there are at least three charts.
+  cwMax = us.nWorker > 1 && cChart >= 3 && !FCastHooks() ?
+    NWorkerCount(cChart) - 1 : 0;
+#endif
 
   for (i = 1; i <= cChart; i++) {
     ciCore = *rgpci[i];
@@ -461,9 +505,18 @@ void CastRelation(void)
       ciCore = ciMain;
     }
     FProcessCommandLine(szWheel[i]);
+#ifndef PC
+    rgfd[i] = -1;
+#endif
     if (FNoTimeOrSpace(ciCore)) {
       cp0 = *rgpcp[i];
       t = 0.0;
+#ifndef PC
+    } else if (i < cChart && cw < cwMax &&
+      (rgfd[i] = IForkCastWorker(i)) >= 0) {
+      cw++;
+      t = 0.0;    // Results are collected from the worker below.
+#endif
     } else
       t = CastChart(i);
     if (i == 1) {
@@ -476,6 +529,25 @@ void CastRelation(void)
       CopyRgb(ignoreSav, ignore, sizeof(ignore));
   }
 
+#ifndef PC
+  // Collect the charts cast by worker processes.
+  for (i = 1; i < cChart; i++) {
+    if (rgfd[i] < 0)
+      continue;
+    if (!FReadWorker(rgfd[i], rgr, sizeof(rgr)) ||
+      !FReadWorker(rgfd[i], rgpcp[i], sizeof(CP))) {
+      PrintWarning("Parallel chart worker failed to return its results.");
+      rgr[0] = rgr[1] = 0.0;
+    }
+    if (i == 1) {
+      t1 = rgr[0];
+      rSav = rgr[1];
+    } else if (i == 2)
+      t2 = rgr[0];
+    WaitWorkers(1, &rgfd[i]);
+  }
+#endif
+
   us.fProgress = fSav;
   ciCore = ciMain;
   FProcessCommandLine(szWheel[0]);
@@ -568,9 +640,11 @@ void CastRelation(void)
 // Given two objects and an aspect between them, or an object and a sign that
 // it's entering, print if this is a "major" event, such as a season change or
 // major lunar phase. This is called from the ChartInDay() searching and
-// influence routines. Do an interpretation if need be too.
+// influence routines. Do an interpretation if need be too. Only check for
+// eclipses if fEclipse is set, normally the -Yu setting.
 
-void PrintInDayEvent(int source, int aspect, int dest, int nVoid)
+void PrintInDayEvent(int source, int aspect, int dest, int nVoid,
+  flag fEclipse)
 {
   char sz[cchSzDef];
   int nEclipse, nEclipse2;
@@ -609,7 +683,7 @@ void PrintInDayEvent(int source, int aspect, int dest, int nVoid)
       else if (aspect == aOpp) {
         PrintSz(" (Full Moon)");
         // Full Moons may be a lunar eclipse.
-        if (us.fEclipse) {
+        if (fEclipse) {
           nEclipse = NCheckEclipseLunar(us.objCenter, dest, oSun, &rPct);
           if (nEclipse > etNone) {
             AnsiColor(kWhiteA);
@@ -623,7 +697,7 @@ void PrintInDayEvent(int source, int aspect, int dest, int nVoid)
         }
       } else if (aspect == aSqu)
         PrintSz(" (Half Moon)");
-    } else if (us.fEclipse && aspect == aOpp) {
+    } else if (fEclipse && aspect == aOpp) {
       // Check for generic opposition that's an eclipse.
       nEclipse = NCheckEclipseLunar(us.objCenter, dest, source, &rPct);
       if (nEclipse > etNone) {
@@ -640,7 +714,7 @@ void PrintInDayEvent(int source, int aspect, int dest, int nVoid)
     }
 
     // Conjunctions may be a solar eclipse or other occultation.
-    if (us.fEclipse && aspect == aCon) {
+    if (fEclipse && aspect == aCon) {
       nEclipse = NCheckEclipse(source, dest, &rPct);
       if (nEclipse > etNone) {
         AnsiColor(kWhiteA);
@@ -965,7 +1039,7 @@ void ChartInDayInfluence(void)
     AnsiColor(kDkGreenA);
     PrintSz(" - power:");
     sprintf(sz, us.fSeconds ? "%8.4f" : "%6.2f", power[i]); PrintSz(sz);
-    PrintInDayEvent(j, k, l, -1);
+    PrintInDayEvent(j, k, l, -1, us.fEclipse);
   }
   if (occurcount == 0)
     PrintSz("Empty transit aspect list.\n");
@@ -66,13 +66,87 @@
 #define RgzCalendar() NULL
 #endif
 
-// Display a list of transit events. Called from ChartInDaySearch().
+// Store the charts cast at the start and end of search time segment iSeg in
+// a list, so charts at the times of events found during the segment can
+// later be interpolated from them instead of cast. Consecutive segments
+// share the chart in between them. Return the index of the segment's start
+// chart in the list, or -1 if the list couldn't be grown.
 
-void PrintInDays(InDayInfo *pid, int occurcount, int counttotal, flag fProg)
+int ISegAppend(SEG *pseg, CONST CP *pcpA, CONST CP *pcpB, long iSeg)
+{
+  CP *rgcpNew;
+  int ccp, ccpAlloc;
+
+  if (pseg->ccp > 0 && iSeg == pseg->iSeg)
+    return pseg->ccp - 2;
+  ccp = pseg->ccp + (pseg->ccp > 0 && iSeg == pseg->iSeg + 1 ? 1 : 2);
+  if (ccp > pseg->ccpMax) {
+    ccpAlloc = Max(pseg->ccpMax * 2, 16);
+    rgcpNew = RgAllocate(ccpAlloc, CP, "segment charts");
+    if (rgcpNew == NULL)
+      return -1;
+    if (pseg->rgcp != NULL) {
+      CopyRgb((pbyte)pseg->rgcp, (pbyte)rgcpNew, sizeof(CP) * pseg->ccp);
+      DeallocateP(pseg->rgcp);
+    }
+    pseg->rgcp = rgcpNew;
+    pseg->ccpMax = ccpAlloc;
+  }
+  if (ccp - pseg->ccp > 1)
+    pseg->rgcp[pseg->ccp++] = *pcpA;
+  pseg->rgcp[pseg->ccp++] = *pcpB;
+  pseg->iSeg = iSeg;
+  return pseg->ccp - 2;
+}
+
+
+// Set the current chart to the time of an event found during a search time
+// segment, whose start chart is at index icp in a segment chart list, at
+// fraction rSeg through the segment. The chart is interpolated from the list
+// if possible, and only cast if not. rgfIgnore and fAll are passed along to
+// FInterpolateChart().
+
+void SegmentCast(CONST SEG *pseg, int icp, real rSeg, CONST byte *rgfIgnore,
+  flag fAll)
+{
+  if (icp < 0 || !FInterpolateChart(&pseg->rgcp[icp], &pseg->rgcp[icp+1],
+    rgfIgnore, pseg->dSeg, rSeg, fAll))
+    CastChart(-1);
+}
+
+
+// Append fields describing an event found by a search to a JSON record, as
+// done with the -kj switch: The objects involved, and the aspect or other
+// kind of event they make.
+
+void PrintEventJSON(int source, int aspect, int dest)
+{
+  CONST char *rgszEvent[] = {"sign", "direction", "degree", "house",
+    "latitude direction", "distance direction", "node", "distance equal"};
+
+  PrintJSONN("source", source); PrintJSONSz("name1", szObjDisp[source]);
+  PrintJSONN("aspect", aspect);
+  PrintJSONSz("event", aspect > 0 ? SzAspectAbbrev(aspect) :
+    rgszEvent[-aspect-1]);
+  PrintJSONN("dest", dest);
+  if (aspect > 0 || aspect == aDis)
+    PrintJSONSz("name2", szObjDisp[dest]);
+  else if (aspect == aSig)
+    PrintJSONSz("name2", szSignName[dest]);
+}
+
+
+// Display a list of transit events. Called from ChartInDaySearch(), which
+// passes the charts for the time segments events were found in, so charts
+// at the times of events can be interpolated instead of cast.
+
+void PrintInDays(InDayInfo *pid, int occurcount, int counttotal, flag fProg,
+  CONST SEG *pseg)
 {
   char sz[cchSzDef];
-  int fVoid, nVoid, nSkip = 0, i, j, k;
+  int fVoid, nVoid, nSkip = 0, nUse = 0, i, j, k;
   CI ciCast = ciSave, ciEvent;
+  flag fEclipse, fNoEclipse;
 #ifdef EXPRESS
   int nEclipse;
   real rEclipse;
@@ -81,6 +155,11 @@ void PrintInDays(InDayInfo *pid, int occurcount, int counttotal, flag fProg)
   int nEclipse2;
 #endif
 
+#ifdef EXPRESS
+  if (!us.fExpOff && FSzSet(us.szExpDay))
+    nUse = NExpressionChartUse(us.szExpDay);
+#endif
+
   i = (RgzCalendar() == NULL ? -1 : occurcount);
   loop {
     i += (RgzCalendar() == NULL ? 1 : -1);
@@ -151,10 +230,23 @@ void PrintInDays(InDayInfo *pid, int occurcount, int counttotal, flag fProg)
     // Display the current transit event.
     SetCI(ciCast, pid[i].mon, pid[i].day, pid[i].yea,
       pid[i].time / 60.0, Dst, Zon, Lon, Lat);
-    if ((!us.fExpOff && FSzSet(us.szExpDay)) || (us.fEclipse &&
-      !us.fParallel && (pid[i].aspect == aCon || pid[i].aspect == aOpp))) {
+    fEclipse = us.fEclipse && !us.fParallel &&
+      (pid[i].aspect == aCon || pid[i].aspect == aOpp);
+    // If only the event's text looks at eclipses, and the eclipse catalog
+    // shows there isn't one, don't need to cast a chart to check.
+    fNoEclipse = fEclipse && !fProg && nUse == 0 &&
+      RgzCalendar() == NULL && (us.fExpOff || !FSzSet(us.szExpDay)) &&
+      Zon != zonLMT && Zon != zonLAT &&
+      FEclipseCatalogNone(Min(pid[i].source, pid[i].dest), pid[i].aspect,
+      Max(pid[i].source, pid[i].dest), MdytszToJulian(pid[i].mon,
+      pid[i].day, pid[i].yea, pid[i].time / 60.0, Dst, Zon) - 0.5);
+    if (fNoEclipse)
+      fEclipse = fFalse;
+    if ((!us.fExpOff && FSzSet(us.szExpDay)) || fEclipse) {
       ciCore = ciCast;
-      CastChart(-1);
+      if (fEclipse || nUse > 0)
+        SegmentCast(pseg, nUse < 2 ? pid[i].iSeg : -1, pid[i].rSeg, ignore,
+          nUse > 0);
     }
 #ifdef EXPRESS
     // May want to skip current event if AstroExpression says to do so.
@@ -222,6 +314,22 @@ void PrintInDays(InDayInfo *pid, int occurcount, int counttotal, flag fProg)
       ciEvent.loc = ciDefa.loc;
       FAppendCIList(&ciEvent);
     }
+    if (us.fTextJSON) {
+      // Output a record with the fields of the event if -kj in effect.
+      PrintJSONBegin("event");
+      PrintJSONN("mon", pid[i].mon); PrintJSONN("day", pid[i].day);
+      PrintJSONN("yea", pid[i].yea); PrintJSONR("tim", pid[i].time / 60.0);
+      if (Zon != zonLMT && Zon != zonLAT)
+        PrintJSONR("jd", MdytszToJulian(pid[i].mon, pid[i].day, pid[i].yea,
+          pid[i].time / 60.0, Dst, Zon) - 0.5);
+      PrintEventJSON(pid[i].source, pid[i].aspect, pid[i].dest);
+      PrintJSONR("pos1", pid[i].pos1); PrintJSONR("ret1", pid[i].ret1);
+      PrintJSONR("pos2", pid[i].pos2); PrintJSONR("ret2", pid[i].ret2);
+      if (nVoid >= 0)
+        PrintJSONN("void", nVoid);
+      PrintJSONEnd();
+      continue;
+    }
     k = DayOfWeek(pid[i].mon, pid[i].day, pid[i].yea);
     AnsiColor(kRainbowA[k + 1]);
     sprintf(sz, "%.3s ", szDay[k]); PrintSz(sz);
@@ -231,7 +339,8 @@ void PrintInDays(InDayInfo *pid, int occurcount, int counttotal, flag fProg)
       SzTim(pid[i].time / 60.0)); PrintSz(sz);
     PrintAspect(pid[i].source, pid[i].pos1, pid[i].ret1, pid[i].aspect,
       pid[i].dest, pid[i].pos2, pid[i].ret2, fProg ? 'e' : 'd');
-    PrintInDayEvent(pid[i].source, pid[i].aspect, pid[i].dest, nVoid);
+    PrintInDayEvent(pid[i].source, pid[i].aspect, pid[i].dest, nVoid,
+      us.fEclipse && !fNoEclipse);
   }
 }
 
@@ -246,11 +355,13 @@ void ChartInDaySearch(flag fProg)
 {
   InDayInfo id[MAXINDAY], idT, *pid = id;
   int yea0, yea1, yea2, mon0, mon1, mon2, day0, day1, day2, counttotal = 0,
-    occurcount, maxinday = MAXINDAY, division, div, divSign,
-    i, j, k, l, s1, s2;
+    occurcount, occurseg, maxinday = MAXINDAY, division, div, divSign,
+    nUse = 0, i, j, k, l, s1, s2;
+  long iSeg = 0;
   real divsiz, d1, d2, e1, e2, f1, f2, g;
-  flag fYear, fVoid, fPrint = fTrue;
+  flag fYear, fVoid, fPrint = fTrue, fSeg;
   CP cpA, cpB;
+  SEG seg;
 
   // If parameter 'fProg' is set, look for changes in a progressed chart.
 
@@ -265,6 +376,18 @@ void ChartInDaySearch(flag fProg)
   if (us.fListAuto)
     is.cci = 0;
 
+  // Events which need charts cast at their times, for eclipses or for
+  // AstroExpression hooks which look at positions, keep the charts of the
+  // segment they were found in to interpolate them from.
+  ClearB((pbyte)&seg, sizeof(SEG));
+  seg.dSeg = 1.0 / (real)division;
+#ifdef EXPRESS
+  if (!us.fExpOff && FSzSet(us.szExpDay))
+    nUse = NExpressionChartUse(us.szExpDay);
+#endif
+  fSeg = !fProg && nUse < 2 && !us.fTopoPos &&
+    FChartInterpolable(nUse > 0 ? ignore : NULL);
+
   // If -dY in effect, then search through a range of years.
 
   yea1 = yea2 = !fProg ? Yea : YeaT;
@@ -306,13 +429,14 @@ void ChartInDaySearch(flag fProg)
       is.JDp = MdytszToJulian(mon0, day0, yea0, 0.0, Dst, Zon);
       ciCore = ciMain;
     }
-    CastChart(-1);
+    CastChartPart(-1, NULL, cfSpeed | cfDist);
     cpB = cp0;
+    iSeg++;
 
     // Now divide the day into segments and search each segment in turn.
     // More segments is slower, but has slightly better time accuracy.
 
-    for (div = 1; div <= division; div++) {
+    for (div = 1; div <= division; div++, iSeg++) {
 
       // Cast the chart for the ending time of the present segment. The
       // beginning time chart is copied from the previous end time chart.
@@ -323,8 +447,9 @@ void ChartInDaySearch(flag fProg)
         is.JDp = MdytszToJulian(mon0, day0, yea0, TT, Dst, Zon);
         ciCore = ciMain;
       }
-      CastChart(-1);
+      CastChartPart(-1, NULL, cfSpeed | cfDist);
       cpA = cpB; cpB = cp0;
+      occurseg = occurcount;
 
       // Now search through the present segment for anything exciting.
 
@@ -623,6 +748,17 @@ void ChartInDaySearch(flag fProg)
           }
         }
       } // i
+
+      // Note the segment each event was found in, storing its charts if
+      // the event will need a chart cast at its time.
+
+      for (l = occurseg; l < occurcount; l++) {
+        pid[l].iSeg = -1;
+        if (fSeg && (nUse > 0 || (us.fEclipse && !us.fParallel &&
+          (pid[l].aspect == aCon || pid[l].aspect == aOpp))))
+          pid[l].iSeg = ISegAppend(&seg, &cpA, &cpB, iSeg);
+        pid[l].rSeg = pid[l].time / divsiz - (real)(div-1);
+      }
     } // div
 
     // After all the aspects and evemts in the day have been located, sort
@@ -644,7 +780,8 @@ void ChartInDaySearch(flag fProg)
         occurcount += (int)(pid - id);
         pid = id;
       }
-      PrintInDays(id, occurcount, occurcount, fProg);
+      PrintInDays(id, occurcount, occurcount, fProg, &seg);
+      seg.ccp = 0;
     } else {
       // Output a chunk of events, knowing there's more to come.
       pid += occurcount;
@@ -657,20 +794,38 @@ void ChartInDaySearch(flag fProg)
             j--;
         }
 #endif
-        PrintInDays(id, j, pid - id, fProg);
+        PrintInDays(id, j, pid - id, fProg, &seg);
         for (i = 0; i < pid - id - j; i++)
           id[i] = id[i + j];
         pid -= j;
+
+        // Drop segment charts no remaining event refers to.
+        k = seg.ccp;
+        for (i = 0; i < pid - id; i++)
+          if (id[i].iSeg >= 0)
+            k = Min(k, id[i].iSeg);
+        if (k > 0) {
+          seg.ccp -= k;
+          CopyRgb((pbyte)&seg.rgcp[k], (pbyte)seg.rgcp, sizeof(CP) * seg.ccp);
+          for (i = 0; i < pid - id; i++)
+            if (id[i].iSeg >= 0)
+              id[i].iSeg -= k;
+        }
       }
     }
-    if (occurcount >= maxinday && fPrint)
-      PrintSz("Too many transit events found.\n");
+    if (occurcount >= maxinday && fPrint) {
+      if (!us.fTextJSON)
+        PrintSz("Too many transit events found.\n");
+      else
+        PrintWarning("Too many transit events found.");
+    }
     counttotal += occurcount;
   } // day0
   } // mon0
   } // yea0
-  if (counttotal == 0 && fPrint)
+  if (counttotal == 0 && fPrint && !us.fTextJSON)
     PrintSz("No transit events found.\n");
+  DeallocatePIf(seg.rgcp);
 
   // Recompute original chart placements as have overwritten them.
 
@@ -679,6 +834,164 @@ void ChartInDaySearch(flag fProg)
 }
 
 
+// Given a natal chart (along with its MC and obliquity), and transiting
+// charts cast for the start and end of a time segment, check whether
+// transiting object i changes which 3D house of the natal chart it's in
+// during the segment. If so, fill out pti with the event, with its time in
+// minutes relative to t0, given the segment length dt.
+
+flag FTransitHouse3D(CONST CP *pcpN, real mc, real ob, CONST CP *pcpA,
+  CONST CP *pcpB, int i, real t0, real dt, TransInfo *pti)
+{
+  real cuspSav[cSign+1], e1, e2, f1, f2, lonSav;
+  int s1, s2, k;
+
+  is.MC = mc; is.OB = ob;
+  lonSav = cp0.lonMC; cp0.lonMC = pcpN->lonMC;
+  CopyRgb((pbyte)cp0.cusp3, (pbyte)cuspSav, sizeof(cuspSav));
+  CopyRgb((pbyte)pcpN->cusp3, (pbyte)cp0.cusp3, sizeof(cuspSav));
+  e1 = pcpA->obj[i]; f1 = RHousePlaceIn3D(e1, pcpA->alt[i]);
+  e2 = pcpB->obj[i]; f2 = RHousePlaceIn3D(e2, pcpB->alt[i]);
+  CopyRgb((pbyte)cuspSav, (pbyte)cp0.cusp3, sizeof(cuspSav));
+  cp0.lonMC = lonSav;
+  s1 = SFromZ(f1)-1; s2 = SFromZ(f2)-1;
+  k = NAbs(s1-s2);
+  if (s1 == s2 || (k != 1 && k != cSign-1) || FIgnore(cuspLo+s2))
+    return fFalse;
+  pti->source = i;
+  pti->aspect = aHou;
+  pti->dest = s2+1;
+  pti->time = MinDistance(f1, (real)(pcpA->dir[i] >= 0.0 ? s2 : s1) * 30.0) /
+    MinDistance(f1, f2)*dt + t0;
+  pti->posT = pcpA->obj[i];
+  pti->posN = pcpN->obj[i];
+  pti->retT = (pcpA->dir[i] + pcpB->dir[i]) / 2.0;
+  return fTrue;
+}
+
+
+// Given a natal chart, and transiting charts cast for the start and end of
+// a time segment, check whether transiting object j makes an exact aspect k
+// to natal object i during the segment. If so, fill out pti with the event,
+// with its time in minutes relative to t0, given the segment length dt.
+
+flag FTransitAspect(CONST CP *pcpN, CONST CP *pcpA, CONST CP *pcpB,
+  int i, int k, int j, real t0, real dt, TransInfo *pti)
+{
+  real d, e1, e2, f1, f2;
+
+  if (!us.fParallel) {
+    d = pcpN->obj[i]; e1 = pcpA->obj[j]; e2 = pcpB->obj[j];
+    if (MinDistance(e1, Mod(d-rAspAngle[k])) <
+        MinDistance(e2, Mod(d+rAspAngle[k]))) {
+      e1 = Mod(e1+rAspAngle[k]);
+      e2 = Mod(e2+rAspAngle[k]);
+    } else {
+      e1 = Mod(e1-rAspAngle[k]);
+      e2 = Mod(e2-rAspAngle[k]);
+    }
+
+    // Check to see if the present aspect actually occurs during the
+    // segment, making sure we check any Aries point crossings.
+
+    f1 = e1-d;
+    if (RAbs(f1) > rDegHalf)
+      f1 -= RSgn(f1)*rDegMax;
+    f2 = e2-d;
+    if (RAbs(f2) > rDegHalf)
+      f2 -= RSgn(f2)*rDegMax;
+    if (MinDistance(d, Midpoint(e1, e2)) >= rDegQuad || RSgn(f1) == RSgn(f2))
+      return fFalse;
+
+    // Ok, have found a transit! Now determine the time and save this
+    // transit in our list to be printed.
+
+    pti->source = j;
+    pti->aspect = k;
+    pti->dest = i;
+    pti->time = RAbs(f1)/(RAbs(f1)+RAbs(f2))*dt + t0;
+    pti->posT = Mod(MinDistance(pcpA->obj[j], Mod(d-rAspAngle[k])) <
+                    MinDistance(pcpB->obj[j], Mod(d+rAspAngle[k])) ?
+      d-rAspAngle[k] : d+rAspAngle[k]);
+    pti->posN = pcpN->obj[i];
+    pti->retT = (pcpA->dir[j] + pcpB->dir[j]) / 2.0;
+    return fTrue;
+  }
+
+  d = RTransitDecl(pcpN, i); e1 = RTransitDecl(pcpA, j);
+  e2 = RTransitDecl(pcpB, j);
+  if (k == aOpp) {
+    neg(e1);
+    neg(e2);
+  }
+
+  // Check if parallel aspect occurs during time segment.
+
+  f1 = e1-d;
+  f2 = e2-d;
+  if (RSgn(f1) == RSgn(f2))
+    return fFalse;
+
+  // Ok, found a parallel transit. Now determine the time and save this
+  // transit in the list to be printed.
+
+  if (k == aOpp) {
+    neg(e1);
+    neg(e2);
+  }
+  pti->source = j;
+  pti->aspect = k;
+  pti->dest = i;
+  pti->time = RAbs(f1)/(RAbs(f1)+RAbs(f2))*dt + t0;
+  pti->posT = e1 + (e2 - e1)*RAbs(f1)/(RAbs(f1)+RAbs(f2));
+  pti->posN = d;
+  pti->retT = (pcpA->diralt[j] + pcpB->diralt[j]) / 2.0;
+  return fTrue;
+}
+
+
+// Like FTransitAspect() but check whether transiting object j becomes the
+// same distance away as natal object i during the time segment.
+
+flag FTransitDisequ(CONST CP *pcpN, CONST CP *pcpA, CONST CP *pcpB,
+  int i, int j, real t0, real dt, TransInfo *pti)
+{
+  real d, e1, e2, f1, f2;
+
+  d = pcpN->dist[i]; e1 = pcpA->dist[j]; e2 = pcpB->dist[j];
+  if (!((d > e1 && d < e2) || (d > e2 && d < e1)))
+    return fFalse;
+  f1 = d-e1; f2 = e2-d;
+  pti->source = j;
+  pti->aspect = aDis;
+  pti->dest = i;
+  pti->time = RAbs(f1)/(RAbs(f1)+RAbs(f2))*dt + t0;
+  pti->posT = Mod(pcpA->obj[j] + RAbs(f1)/(RAbs(f1)+RAbs(f2)) *
+    MinDifference(pcpA->obj[j], pcpB->obj[j]));
+  pti->posN = pcpN->obj[i];
+  pti->retT = (pcpA->dir[j] + pcpB->dir[j]) / 2.0;
+  return fTrue;
+}
+
+
+// Return the declination or latitude of an object in a chart, whichever one
+// parallel aspects are being compared with, as done for transit searches.
+
+real RTransitDecl(CONST CP *pcp, int obj)
+{
+  real lon, lat = pcp->alt[obj];
+
+  if (!us.fEquator2 && !us.fParallel2) {
+    // If have ecliptic latitude and want declination, convert.
+    lon = pcp->obj[obj]; EclToEqu(&lon, &lat);
+  } else if (us.fEquator2 && us.fParallel2) {
+    // If have equatorial declination and want latitude, convert.
+    lon = pcp->obj[obj]; EquToEcl(&lon, &lat);
+  }
+  return lat;
+}
+
+
 // Search through a month, year, or years, and print out the times of exact
 // transits where planets in the time frame make aspect to the planets in
 // some other chart, as specified with the -t switch. To do this, cast charts
@@ -690,9 +1003,9 @@ void ChartTransitSearch(flag fProg)
   TransInfo ti[MAXINDAY], tiT, *pti;
   char sz[cchSzDef];
   int M1, M2, Y1, Y2, counttotal = 0, occurcount, division, div, nAsp, fNoCusp,
-    nSkip = 0, i, j, k, s1, s2, s1prev = 0;
-  real cuspSav[cSign+1], divsiz, daysiz, d, e1, e2, f1, f2,
-    mc = is.MC, ob = is.OB, lonSav;
+    nSkip = 0, nUse = 0, i, j, k, s1, s1prev = 0;
+  real divsiz, daysiz, d, mc = is.MC, ob = is.OB;
+  byte ignoreT[objMax];
   flag fPrint = fTrue;
   CP cpA, cpB, cpN = cp0;
   CI ciSav, ciCast = ciSave, ciEvent;
@@ -719,6 +1032,17 @@ void ChartTransitSearch(flag fProg)
     nAsp = Min(nAsp, aOpp);
   if (us.fListAuto)
     is.cci = 0;
+#ifdef EXPRESS
+  if (!us.fExpOff && FSzSet(us.szExpTra))
+    nUse = NExpressionChartUse(us.szExpTra);
+#endif
+
+  // Transiting charts are cast with the transit object restrictions. Stars
+  // can't make transits, so they're only needed for 3D house changes.
+  CopyRgb(ignore2, ignoreT, sizeof(ignoreT));
+  if (!us.fHouse3D || us.fIgnoreSign)
+    for (i = starLo; i <= starHi; i++)
+      ignoreT[i] = fTrue;
 
   Y1 = Y2 = YeaT;
   M1 = M2 = MonT;
@@ -751,11 +1075,7 @@ void ChartTransitSearch(flag fProg)
       is.JDp = MdytszToJulian(MM, DD, YY, TT, SS, ZZ);
       ciCore = ciMain;
     }
-    for (i = 0; i <= is.nObj; i++)
-      SwapN(ignore[i], ignore2[i]);
-    CastChart(-1);
-    for (i = 0; i <= is.nObj; i++)
-      SwapN(ignore[i], ignore2[i]);
+    CastChartPart(-1, ignoreT, cfSpeed | cfDist);
     cpB = cp0;
 
     // Divide month into segments and then search each segment in turn.
@@ -776,11 +1096,7 @@ void ChartTransitSearch(flag fProg)
         is.JDp = MdytszToJulian(MM, DD, YY, TT, SS, ZZ);
         ciCore = ciMain;
       }
-      for (i = 0; i <= oNorm; i++)
-        SwapN(ignore[i], ignore2[i]);
-      CastChart(-1);
-      for (i = 0; i <= oNorm; i++)
-        SwapN(ignore[i], ignore2[i]);
+      CastChartPart(-1, ignoreT, cfSpeed | cfDist);
       cpA = cpB; cpB = cp0;
 
       // Now search through the present segment for any transits. Note that
@@ -790,31 +1106,10 @@ void ChartTransitSearch(flag fProg)
 
         // Check if 3D house change occurs during time segment.
 
-        if (us.fHouse3D && !us.fIgnoreSign && !FIgnore2(i)) {
-          is.MC = mc; is.OB = ob;
-          lonSav = cp0.lonMC; cp0.lonMC = cpN.lonMC;
-          CopyRgb((pbyte)cp0.cusp3, (pbyte)cuspSav, sizeof(cuspSav));
-          CopyRgb((pbyte)cpN.cusp3, (pbyte)cp0.cusp3, sizeof(cuspSav));
-          e1 = cpA.obj[i]; f1 = RHousePlaceIn3D(e1, cpA.alt[i]);
-          e2 = cpB.obj[i]; f2 = RHousePlaceIn3D(e2, cpB.alt[i]);
-          CopyRgb((pbyte)cuspSav, (pbyte)cp0.cusp3, sizeof(cuspSav));
-          cp0.lonMC = lonSav;
-          s1 = SFromZ(f1)-1; s2 = SFromZ(f2)-1;
-          k = NAbs(s1-s2);
-          if (s1 != s2 && (k == 1 || k == cSign-1) && !FIgnore(cuspLo+s2) &&
-            occurcount < MAXINDAY) {
-            pti->source = i;
-            pti->aspect = aHou;
-            pti->dest = s2+1;
-            pti->time = MinDistance(f1,
-              (real)(cpA.dir[i] >= 0.0 ? s2 : s1) * 30.0) /
-              MinDistance(f1, f2)*divsiz + (real)(div-1)*divsiz;
-            pti->posT = cpA.obj[i];
-            pti->posN = cpN.obj[i];
-            pti->retT = (cpA.dir[i] + cpB.dir[i]) / 2.0;
-            occurcount++, pti++;
-          }
-        }
+        if (us.fHouse3D && !us.fIgnoreSign && !FIgnore2(i) &&
+          occurcount < MAXINDAY && FTransitHouse3D(&cpN, mc, ob, &cpA, &cpB,
+          i, (real)(div-1)*divsiz, divsiz, pti))
+          occurcount++, pti++;
 
         if (FIgnore(i))
           continue;
@@ -824,114 +1119,18 @@ void ChartTransitSearch(flag fProg)
 
           // Between each pair of planets, check if they make any aspects.
 
-          if (!us.fParallel) {
-
-          for (k = 1; k <= nAsp; k++) if (FAcceptAspect(i, k, j)) {
-            d = cpN.obj[i]; e1 = cpA.obj[j]; e2 = cpB.obj[j];
-            if (MinDistance(e1, Mod(d-rAspAngle[k])) <
-                MinDistance(e2, Mod(d+rAspAngle[k]))) {
-              e1 = Mod(e1+rAspAngle[k]);
-              e2 = Mod(e2+rAspAngle[k]);
-            } else {
-              e1 = Mod(e1-rAspAngle[k]);
-              e2 = Mod(e2-rAspAngle[k]);
-            }
-
-            // Check to see if the present aspect actually occurs during the
-            // segment, making sure we check any Aries point crossings.
-
-            f1 = e1-d;
-            if (RAbs(f1) > rDegHalf)
-              f1 -= RSgn(f1)*rDegMax;
-            f2 = e2-d;
-            if (RAbs(f2) > rDegHalf)
-              f2 -= RSgn(f2)*rDegMax;
-            if (MinDistance(d, Midpoint(e1, e2)) < rDegQuad &&
-              RSgn(f1) != RSgn(f2) && occurcount < MAXINDAY) {
-
-              // Ok, have found a transit! Now determine the time and save
-              // this transit in our list to be printed.
-
-              pti->source = j;
-              pti->aspect = k;
-              pti->dest = i;
-              pti->time = RAbs(f1)/(RAbs(f1)+RAbs(f2))*divsiz +
-                (real)(div-1)*divsiz;
-              pti->posT = Mod(MinDistance(cpA.obj[j], Mod(d-rAspAngle[k])) <
-                              MinDistance(cpB.obj[j], Mod(d+rAspAngle[k])) ?
-                d-rAspAngle[k] : d+rAspAngle[k]);
-              pti->posN = cpN.obj[i];
-              pti->retT = (cpA.dir[j] + cpB.dir[j]) / 2.0;
+          for (k = 1; k <= nAsp; k++)
+            if (FAcceptAspect(i, k, j) && occurcount < MAXINDAY &&
+              FTransitAspect(&cpN, &cpA, &cpB, i, k, j,
+              (real)(div-1)*divsiz, divsiz, pti))
               occurcount++, pti++;
-            }
-          }
-
-          } else {
-
-          for (k = 1; k <= nAsp; k++) if (FAcceptAspect(i, k, j)) {
-            d = cpN.alt[i]; e1 = cpA.alt[j]; e2 = cpB.alt[j];
-            if (!us.fEquator2 && !us.fParallel2) {
-              // If have ecliptic latitude and want declination, convert.
-              f1 = cpN.obj[i]; EclToEqu(&f1, &d);
-              f1 = cpA.obj[j]; EclToEqu(&f1, &e1);
-              f2 = cpB.obj[j]; EclToEqu(&f2, &e2);
-            } else if (us.fEquator2 && us.fParallel2) {
-              // If have equatorial declination and want latitude, convert.
-              f1 = cpN.obj[i]; EquToEcl(&f1, &d);
-              f1 = cpA.obj[j]; EquToEcl(&f1, &e1);
-              f2 = cpB.obj[j]; EquToEcl(&f2, &e2);
-            }
-
-            if (k == aOpp) {
-              neg(e1);
-              neg(e2);
-            }
-
-            // Check if parallel aspect occurs during time segment.
-
-            f1 = e1-d;
-            f2 = e2-d;
-            if (RSgn(f1) != RSgn(f2) && occurcount < MAXINDAY) {
-
-              // Ok, found a parallel transit. Now determine the time and save
-              // this transit in the list to be printed.
-
-              if (k == aOpp) {
-                neg(e1);
-                neg(e2);
-              }
-              pti->source = j;
-              pti->aspect = k;
-              pti->dest = i;
-              pti->time = RAbs(f1)/(RAbs(f1)+RAbs(f2))*divsiz +
-                (real)(div-1)*divsiz;
-              pti->posT = e1 + (e2 - e1)*RAbs(f1)/(RAbs(f1)+RAbs(f2));
-              pti->posN = d;
-              pti->retT = (cpA.diralt[j] + cpB.diralt[j]) / 2.0;
-              occurcount++, pti++;
-            }
-          }
-          } // us.fParallel
 
           // Check for planet pairs equidistant from each other.
 
-          if (!us.fIgnoreDisequ) {
-            d = cpN.dist[i]; e1 = cpA.dist[j]; e2 = cpB.dist[j];
-            if (((d > e1 && d < e2) || (d > e2 && d < e1)) &&
-              occurcount < MAXINDAY) {
-              f1 = d-e1; f2 = e2-d;
-              pti->source = j;
-              pti->aspect = aDis;
-              pti->dest = i;
-              pti->time = RAbs(f1)/(RAbs(f1)+RAbs(f2))*divsiz +
-                (real)(div-1)*divsiz;
-              pti->posT = Mod(cpA.obj[j] + RAbs(f1)/(RAbs(f1)+RAbs(f2)) *
-                MinDifference(cpA.obj[j], cpB.obj[j]));
-              pti->posN = cpN.obj[i];
-              pti->retT = (cpA.dir[j] + cpB.dir[j]) / 2.0;
-              occurcount++, pti++;
-            }
-          }
+          if (!us.fIgnoreDisequ && occurcount < MAXINDAY &&
+            FTransitDisequ(&cpN, &cpA, &cpB, i, j, (real)(div-1)*divsiz,
+            divsiz, pti))
+            occurcount++, pti++;
         } // j
       } // i
 
@@ -973,9 +1172,14 @@ void ChartTransitSearch(flag fProg)
           nSkip = 0;
         s1prev = s1;
         // May want to skip this transit if AstroExpression says to do so.
+        // When transits are printed per segment, a chart at the time of the
+        // transit can be interpolated from the segment's charts.
         if (!us.fExpOff && FSzSet(us.szExpTra)) {
           ciCore = ciCast;
-          CastChart(-1);
+          if (nUse > 0 && (nUse > 1 || !fPrint || !FInterpolateChart(&cpA,
+            &cpB, ignoreT, divsiz / (24.0*60.0),
+            pti->time / divsiz - (real)(div-1), fTrue)))
+            CastChart(-1);
           ExpSetN(iLetterX, pti->source);
           ExpSetN(iLetterY, pti->aspect);
           ExpSetN(iLetterZ, pti->dest);
@@ -1021,6 +1225,20 @@ void ChartTransitSearch(flag fProg)
           ciEvent.loc = ciDefa.loc;
           FAppendCIList(&ciEvent);
         }
+        if (us.fTextJSON) {
+          // Output a record with the fields of the transit if -kj in effect.
+          PrintJSONBegin(fProg ? "progression" : "transit");
+          PrintJSONN("mon", MonT); PrintJSONN("day", s1+1);
+          PrintJSONN("yea", YeaT); PrintJSONR("tim", (real)j / (60.0*60.0));
+          if (ZonT != zonLMT && ZonT != zonLAT)
+            PrintJSONR("jd", MdytszToJulian(MonT, s1+1, YeaT,
+              (real)j / (60.0*60.0), DstT, ZonT) - 0.5);
+          PrintEventJSON(pti->source, pti->aspect, pti->dest);
+          PrintJSONR("posT", pti->posT); PrintJSONR("retT", pti->retT);
+          PrintJSONR("posN", pti->posN);
+          PrintJSONEnd();
+          continue;
+        }
         if (us.fSeconds) {
           k = DayOfWeek(MonT, s1+1, YeaT);
           AnsiColor(kRainbowA[k + 1]);
@@ -1047,12 +1265,16 @@ void ChartTransitSearch(flag fProg)
 #endif
         AnsiColor(kDefault);
       } // i
-      if (occurcount >= MAXINDAY && fPrint)
-        PrintSz("Too many transits found.\n");
+      if (occurcount >= MAXINDAY && fPrint) {
+        if (!us.fTextJSON)
+          PrintSz("Too many transits found.\n");
+        else
+          PrintWarning("Too many transits found.");
+      }
       counttotal += occurcount;
     } // div
   } // MonT
-  if (counttotal == 0 && fPrint)
+  if (counttotal == 0 && fPrint && !us.fTextJSON)
     PrintSz("No transits found.\n");
 
   // Recompute original chart placements as have overwritten them.
@@ -1064,6 +1286,415 @@ void ChartTransitSearch(flag fProg)
 }
 
 
+// Return a new entry at the end of a list of transit events, growing the
+// list if needed. Return NULL if the list couldn't be grown.
+
+TransEvent *PteAppendTransEvent(TransEvent **prgte, int *pcte,
+  int *pcteAlloc)
+{
+  TransEvent *rgteNew;
+  int cteAlloc;
+
+  if (*pcte >= *pcteAlloc) {
+    cteAlloc = Max(*pcteAlloc * 2, 1000);
+    rgteNew = RgAllocate(cteAlloc, TransEvent, "transit events");
+    if (rgteNew == NULL)
+      return NULL;
+    if (*prgte != NULL) {
+      CopyRgb((pbyte)*prgte, (pbyte)rgteNew, sizeof(TransEvent) * *pcte);
+      DeallocateP(*prgte);
+    }
+    *prgte = rgteNew;
+    *pcteAlloc = cteAlloc;
+  }
+  return &(*prgte)[(*pcte)++];
+}
+
+
+// Like ChartTransitSearch(), but search for transits to every chart in the
+// chart list at once, as specified with the -5t switch. The transiting
+// charts for each time segment are cast just once, and the natal planets of
+// all charts are kept sorted by position, so that each transiting planet
+// only needs to be checked against those natal planets it passes over
+// during the segment. Results are printed grouped by chart, the same as if
+// each chart were searched individually.
+
+void ChartTransitSearchList(flag fMult)
+{
+  TransTarget *rgtt = NULL, *rgttDis = NULL, *ptt;
+  TransEvent *rgte = NULL, *rgte2, *pte, teT;
+  TransInfo ti, *pti;
+  CP *rgcp = NULL, *pcpN, cpA, cpB;
+  CI ciMainSav = ciMain, ciSav = ciTran, ciCast = ciSave;
+  char sz[cchSzDef];
+  int *rgcte = NULL, rgiLo[4], rgiHi[4], M1, M2, Y1, Y2, cci = is.cci, ctt,
+    cte = 0, cteAlloc = 0, cRange, cRange0, iSeg = 0, division, div, nAsp,
+    fNoCusp, ici, iRange, iMin, nUse = 0, i, j, k, s, s1, iteLo, iteHi,
+    cteSeg, ite;
+  real *rgrMC = NULL, divsiz, daysiz, d, e1, e2, rLo, rHi, rOBLo = rDegMax,
+    rOBHi = -rDegMax, rCos = 1.0;
+  byte ignoreT[objMax];
+  flag fHouse3D = us.fHouse3D && !us.fIgnoreSign, fSeg;
+  SEG seg;
+
+  // Cast each natal chart, and note the position of every natal planet.
+
+  if (cci <= 0)
+    return;
+  ClearB((pbyte)&seg, sizeof(SEG));
+  for (ctt = 0, i = 0; i <= is.nObj; i++)
+    ctt += !FIgnore(i);
+  ctt *= cci;
+  rgcp = RgAllocate(cci, CP, "transit charts");
+  rgrMC = RgAllocate(cci*2, real, "transit charts");
+  rgtt = RgAllocate(ctt*2, TransTarget, "transit targets");
+  rgcte = RgAllocate(cci+1, int, "transit events");
+  if (rgcp == NULL || rgrMC == NULL || rgtt == NULL || rgcte == NULL)
+    goto LDone;
+  rgttDis = rgtt + ctt;
+  ptt = rgtt;
+  for (ici = 0; ici < cci; ici++) {
+    ciCore = ciMain = is.rgci[ici];
+    CastChart(1);
+    rgcp[ici] = cp0;
+    rgrMC[ici*2] = is.MC; rgrMC[ici*2 + 1] = is.OB;
+    rOBLo = Min(rOBLo, is.OB); rOBHi = Max(rOBHi, is.OB);
+    for (i = 0; i <= is.nObj; i++) {
+      if (FIgnore(i))
+        continue;
+      ptt->ici = ici; ptt->obj = i;
+      if (!us.fParallel)
+        ptt->pos = cp0.obj[i];
+      else {
+        ptt->pos = RTransitDecl(&cp0, i);
+        rCos = Min(rCos, RCosD(ptt->pos));
+      }
+      ptt[ctt] = *ptt;
+      ptt[ctt].pos = cp0.dist[i];
+      ptt++;
+    }
+  }
+  SortTransTarget(rgtt, ctt);
+  SortTransTarget(rgttDis, ctt);
+
+  fNoCusp = fTrue;
+  for (i = cuspLo; i <= cuspHi; i++)
+    fNoCusp &= ignore2[i];
+  division = us.nDivision;
+  if (!fNoCusp)
+    division = Max(division, 96);
+  nAsp = is.fReturn ? aCon : us.nAsp;
+  if (us.fParallel)
+    nAsp = Min(nAsp, aOpp);
+  CopyRgb(ignore2, ignoreT, sizeof(ignoreT));
+  if (!fHouse3D)
+    for (i = starLo; i <= starHi; i++)
+      ignoreT[i] = fTrue;
+
+  Y1 = Y2 = YeaT;
+  M1 = M2 = MonT;
+  if (us.fInDayYear) {
+    M1 = 1; M2 = 12;
+    if (us.nEphemYears != 0) {
+      if (us.nEphemYears < 0)
+        Y1 += (us.nEphemYears + 1);
+      else
+        Y2 += (us.nEphemYears - 1);
+    }
+  }
+
+  // Transits whose AstroExpression hook looks at positions keep the charts
+  // of the segment they were found in, to interpolate their charts from.
+#ifdef EXPRESS
+  if (!us.fExpOff && FSzSet(us.szExpTra))
+    nUse = NExpressionChartUse(us.szExpTra);
+#endif
+
+  // Search each time segment of the months in question for any transits.
+
+  us.fProgress = fFalse;
+  fSeg = nUse == 1 && !us.fTopoPos && FChartInterpolable(ignoreT);
+  for (YeaT = Y1; YeaT <= Y2; YeaT++)
+  for (MonT = M1; MonT <= M2; MonT++) {
+    daysiz = (real)(us.fInDayMonth ? DayInMonth(MonT, YeaT) : 1)*24.0*60.0;
+    divsiz = daysiz / (real)division;
+    SetCI(ciCore, MonT, us.fInDayMonth ? 1 : DayT, YeaT, 0.0, DstT, ZonT,
+      LonT, LatT);
+    CastChartPart(-1, ignoreT, cfSpeed | cfDist);
+    cpB = cp0;
+
+    for (div = 1; div <= division; div++, iSeg++) {
+      d = (us.fInDayMonth ? 1.0 : (real)DayT) +
+        (daysiz/24.0/60.0)*(real)div/(real)division;
+      SetCI(ciCore, MonT, (int)d, YeaT, RFract(d)*24.0,
+        DstT, ZonT, LonT, LatT);
+      CastChartPart(-1, ignoreT, cfSpeed | cfDist);
+      cpA = cpB; cpB = cp0;
+
+      for (j = 0; j <= oNorm; j++) {
+        if ((!is.fReturn && FIgnore2(j)) || (fNoCusp && !FThing(j)))
+          continue;
+
+        // Determine the ranges of natal positions the transiting planet's
+        // aspects pass over, and check just the natal planets within them.
+
+        for (k = 1; k <= nAsp + !us.fIgnoreDisequ; k++) {
+          cRange = 0; cRange0 = 4;
+          if (k > nAsp) {
+            rLo = Min(cpA.dist[j], cpB.dist[j]);
+            rHi = Max(cpA.dist[j], cpB.dist[j]);
+            rgiLo[cRange] = ITransTargetFind(rgttDis, ctt, rLo);
+            rgiHi[cRange++] = ITransTargetFind(rgttDis, ctt, rHi + rSmall);
+          } else if (us.fParallel) {
+            e1 = RTransitDecl(&cpA, j); e2 = RTransitDecl(&cpB, j);
+            if (k == aOpp) {
+              neg(e1);
+              neg(e2);
+            }
+
+
+            // Declinations are converted using the obliquity of whichever
+            // chart is current when checked, which may not be the one the
+            // natal targets were sorted with, so allow for the difference.
+            d = Min(rCos, Min(RCosD(e1), RCosD(e2)));
+            d = (Max(RAbs(is.OB - rOBLo), RAbs(is.OB - rOBHi))*2.0 + rSmall) /
+              Max(d, 0.001);
+            rLo = Min(e1, e2) - d; rHi = Max(e1, e2) + d;
+            rgiLo[cRange] = ITransTargetFind(rgtt, ctt, rLo);
+            rgiHi[cRange++] = ITransTargetFind(rgtt, ctt, rHi);
+          } else {
+
+            // Each aspect other than conjunction and opposition occurs on
+            // either side, so check the arcs both sides pass over.
+            for (s = 0; s < 2; s++) {
+              if (s > 0) {
+                cRange0 = cRange;
+                if (rAspAngle[k] == 0.0 || rAspAngle[k] == rDegHalf)
+                  break;
+              }
+              e1 = Mod(cpA.obj[j] + (s > 0 ? -rAspAngle[k] : rAspAngle[k]));
+              e2 = Mod(cpB.obj[j] + (s > 0 ? -rAspAngle[k] : rAspAngle[k]));
+              d = MinDifference(e1, e2);
+              if (RAbs(d) >= rDegQuad) {
+                rgiLo[cRange] = 0;
+                rgiHi[cRange++] = ctt;
+                continue;
+              }
+              rLo = Mod((d >= 0.0 ? e1 : e2) - rSmall);
+              rHi = rLo + RAbs(d) + 2.0*rSmall;
+              rgiLo[cRange] = ITransTargetFind(rgtt, ctt, rLo);
+              rgiHi[cRange++] = ITransTargetFind(rgtt, ctt, rHi);
+              if (rHi >= rDegMax) {
+                rgiLo[cRange] = 0;
+                rgiHi[cRange++] = ITransTargetFind(rgtt, ctt, rHi - rDegMax);
+              }
+            }
+          }
+          for (iRange = 0; iRange < cRange; iRange++)
+            for (i = rgiLo[iRange]; i < rgiHi[iRange]; i++) {
+              ptt = (k > nAsp ? rgttDis : rgtt) + i;
+              if (is.fReturn && ptt->obj != j)
+                continue;
+              pcpN = &rgcp[ptt->ici];
+
+              // A natal planet within both arcs only needs checking once.
+              if (iRange >= cRange0) {
+                for (s = 0; s < cRange0 &&
+                  !FBetween(i, rgiLo[s], rgiHi[s]-1); s++)
+                  ;
+                if (s < cRange0)
+                  continue;
+              }
+              if (fHouse3D) {
+                is.MC = rgrMC[ptt->ici*2]; is.OB = rgrMC[ptt->ici*2 + 1];
+              }
+              if (k <= nAsp ? !FAcceptAspect(ptt->obj, k, j) ||
+                !FTransitAspect(pcpN, &cpA, &cpB, ptt->obj, k, j,
+                (real)(div-1)*divsiz, divsiz, &ti) :
+                !FTransitDisequ(pcpN, &cpA, &cpB, ptt->obj, j,
+                (real)(div-1)*divsiz, divsiz, &ti))
+                continue;
+              pte = PteAppendTransEvent(&rgte, &cte, &cteAlloc);
+              if (pte == NULL)
+                goto LDone;
+              pte->ici = ptt->ici; pte->iSeg = iSeg;
+              pte->nOrder = ((ptt->obj*2 + 1)*(oNorm+1) + j)*(cAspect+2) +
+                (k <= nAsp ? k : cAspect+1);
+              pte->mon = MonT; pte->yea = YeaT;
+              pte->icp = fSeg ? ISegAppend(&seg, &cpA, &cpB, iSeg) : -1;
+              pte->rSeg = ti.time / divsiz - (real)(div-1);
+              pte->ti = ti;
+            }
+        } // k
+      } // j
+
+      // Check for 3D house changes, which depend on each chart's houses
+      // and location, so can't be narrowed down like aspects can.
+
+      if (fHouse3D)
+        for (ici = 0; ici < cci; ici++) {
+          ciMain = is.rgci[ici];
+          for (i = 0; i <= is.nObj; i++) {
+            if (FIgnore2(i) || !FTransitHouse3D(&rgcp[ici], rgrMC[ici*2],
+              rgrMC[ici*2 + 1], &cpA, &cpB, i, (real)(div-1)*divsiz, divsiz,
+              &ti))
+              continue;
+            pte = PteAppendTransEvent(&rgte, &cte, &cteAlloc);
+            if (pte == NULL)
+              goto LDone;
+            pte->ici = ici; pte->iSeg = iSeg;
+            pte->nOrder = (i*2)*(oNorm+1)*(cAspect+2);
+            pte->mon = MonT; pte->yea = YeaT;
+            pte->icp = fSeg ? ISegAppend(&seg, &cpA, &cpB, iSeg) : -1;
+            pte->rSeg = ti.time / divsiz - (real)(div-1);
+            pte->ti = ti;
+          }
+        }
+    } // div
+  } // MonT
+
+  // Group the transits found by chart, keeping them in order within each.
+
+  rgte2 = RgAllocate(cte+1, TransEvent, "transit events");
+  if (rgte2 == NULL)
+    goto LDone;
+  ClearB((pbyte)rgcte, sizeof(int)*(cci+1));
+  for (ite = 0; ite < cte; ite++)
+    rgcte[rgte[ite].ici + 1]++;
+  for (ici = 1; ici <= cci; ici++)
+    rgcte[ici] += rgcte[ici-1];
+  for (ite = 0; ite < cte; ite++)
+    rgte2[rgcte[rgte[ite].ici]++] = rgte[ite];
+  DeallocateP(rgte);
+  rgte = rgte2;
+
+  // Print the transits for each chart in turn.
+
+  for (ici = 0, iteLo = 0; ici < cci; ici++) {
+    if (ici > 0 || fMult)
+      PrintL2();
+    ciCore = ciMain = is.rgci[ici];
+    pcpN = &rgcp[ici];
+    PrintHeader(1);
+    for (iteHi = iteLo; iteHi < cte && rgte[iteHi].ici == ici; iteHi++)
+      ;
+    if (iteHi <= iteLo)
+      PrintSz("No transits found.\n");
+
+    // Within each time segment, keep only those transits a search of just
+    // this chart would have found, then sort them by time.
+
+    while (iteLo < iteHi) {
+      for (ite = iteLo; ite < iteHi && rgte[ite].iSeg == rgte[iteLo].iSeg;
+        ite++) {
+        for (i = ite; i > iteLo && rgte[i-1].nOrder > rgte[i].nOrder; i--) {
+          teT = rgte[i-1]; rgte[i-1] = rgte[i]; rgte[i] = teT;
+        }
+      }
+      cteSeg = Min(ite - iteLo, MAXINDAY);
+      for (iMin = iteLo; iMin < iteLo + cteSeg; iMin++)
+        for (i = iMin; i > iteLo && rgte[i-1].ti.time > rgte[i].ti.time; i--) {
+          teT = rgte[i-1]; rgte[i-1] = rgte[i]; rgte[i] = teT;
+        }
+
+      for (pte = &rgte[iteLo]; pte < &rgte[iteLo + cteSeg]; pte++) {
+        pti = &pte->ti;
+        MonT = pte->mon; YeaT = pte->yea;
+        j = (int)(pti->time * 60.0);
+        if (us.fInDayMonth) {
+          s1 = j / (24*60*60);
+          j = j - s1 * (24*60*60);
+        } else
+          s1 = DayT-1;
+        SetCI(ciCast, MonT, s1+1, YeaT, (real)j / (60.0*60.0),
+          DstT, ZonT, LonT, LatT);
+#ifdef EXPRESS
+        // May want to skip this transit if AstroExpression says to do so.
+        if (!us.fExpOff && FSzSet(us.szExpTra)) {
+          ciCore = ciCast;
+          seg.dSeg = (us.fInDayMonth ? (real)DayInMonth(MonT, YeaT) : 1.0) /
+            (real)division;
+          if (nUse > 0)
+            SegmentCast(&seg, pte->icp, pte->rSeg, ignoreT, fTrue);
+          ExpSetN(iLetterX, pti->source);
+          ExpSetN(iLetterY, pti->aspect);
+          ExpSetN(iLetterZ, pti->dest);
+          if (!NParseExpression(us.szExpTra))
+            continue;
+        }
+#endif
+        ciSave = ciCast;
+        if (us.fSeconds) {
+          k = DayOfWeek(MonT, s1+1, YeaT);
+          AnsiColor(kRainbowA[k + 1]);
+          sprintf(sz, "%.3s ", szDay[k]); PrintSz(sz);
+          AnsiColor(kDefault);
+        }
+        sprintf(sz, "%s %s ", SzDate(MonT, s1+1, YeaT, fFalse),
+          SzTim(pti->time / 60.0)); PrintSz(sz);
+        PrintAspect(pti->source, pti->posT, pti->retT, pti->aspect,
+          pti->dest, pti->posN, pcpN->dir[pti->dest], 't');
+
+        // Check for a Solar, Lunar, or any other return.
+
+        if (pti->aspect == aCon && pti->source == pti->dest) {
+          AnsiColor(kWhiteA);
+          sprintf(sz, " (%s Return)", pti->source == oSun ? "Solar" :
+            (pti->source == oMoo ? "Lunar" : szObjDisp[pti->source]));
+          PrintSz(sz);
+        }
+        PrintL();
+#ifdef INTERPRET
+        if (us.fInterpret)
+          InterpretTransit(pti->source, pti->aspect, pti->dest);
+#endif
+        AnsiColor(kDefault);
+      }
+      if (cteSeg >= MAXINDAY)
+        PrintSz("Too many transits found.\n");
+      iteLo = ite;
+    }
+  }
+
+  // Free temporary data, and recompute original chart placements as have
+  // overwritten them.
+
+LDone:
+  DeallocatePIf(rgcp);
+  DeallocatePIf(rgrMC);
+  DeallocatePIf(rgtt);
+  DeallocatePIf(rgcte);
+  DeallocatePIf(rgte);
+  DeallocatePIf(seg.rgcp);
+  ciCore = ciMain = ciMainSav; ciTran = ciSav;
+  CastChart(1);
+}
+
+
+// Set the current chart's time to that of a particular time slice in a
+// transit graph, given the chart the graph is centered on.
+
+void SetTransitGraphSlice(CONST CI *pciT, int iw, int dYea)
+{
+  ciCore = *pciT;
+  if (!us.fInDayMonth) {
+    TT = (real)iw * 0.5;
+  } else if (!us.fInDayYear) {
+    DD = (iw >> 1) + 1;
+    TT = FOdd(iw) ? 12.0 : 0.0;
+  } else if (us.nEphemYears <= 1) {
+    MM = (iw / 5) + 1;
+    DD = (iw % 5) * 5 + 1;
+    TT = 0.0;
+  } else {
+    MM = (iw % 12) + 1;
+    DD = 1;
+    YY = YY - dYea + (iw / 12);
+    TT = 0.0;
+  }
+}
+
+
 // Print a chart graphing transits over time. This covers both transit
 // to transit (-B switch) and transit to natal (-V switch). Each aspect 
 // present during the period has its own row, showing its strength from 0-9
@@ -1079,9 +1710,13 @@ void ChartTransitGraph(flag fTrans, flag fProg)
   flag fMonth = us.fInDayMonth, fYear = us.fInDayYear, fMark, fEclipse =
     us.fEclipse && !fTrans && !us.fParallel;
   CI ciT;
+  TSR tsr;
+  byte rgfIgnore[objMax];
   real rT, rPct;
+  flag fSeries = fFalse;
 
   // Initialize variables.
+  tsr.rgr = NULL;
   rgEph = (TransGraInfo *)PAllocate(sizeof(TransGraInfo),
     "transit graph grid");
   if (rgEph == NULL)
@@ -1121,37 +1756,39 @@ void ChartTransitGraph(flag fTrans, flag fProg)
     CastChart(0);
     cp1 = cp0;
   }
+
+  // If the graphed objects can be interpolated from fewer samples than
+  // there are time slices, sample them up front instead of casting charts.
+  if (!fProg && !fEclipse && ciT.zon != zonLMT && ciT.zon != zonLAT) {
+    CopyRgb(fTrans ? ignore2 : ignore, rgfIgnore, sizeof(rgfIgnore));
+    for (obj = 0; obj <= is.nObj; obj++)
+      rgfIgnore[obj] |= !FProperGraph(obj);
+    SetTransitGraphSlice(&ciT, 0, dYea);
+    rT = MdytszToJulian(MM, DD, YY, TT, SS, ZZ);
+    SetTransitGraphSlice(&ciT, cSlice-1, dYea);
+    fSeries = FEphemSeries(&tsr, rgfIgnore, rT,
+      MdytszToJulian(MM, DD, YY, TT, SS, ZZ), cSlice*3/4);
+  }
+
   for (iw = 0; iw < cSlice; iw++) {
 
     // Cast chart for current time slice.
-    ciCore = ciT;
-    if (!fMonth) {
-      TT = (real)iw * 0.5;
-    } else if (!fYear) {
-      DD = (iw >> 1) + 1;
-      TT = FOdd(iw) ? 12.0 : 0.0;
-    } else if (us.nEphemYears <= 1) {
-      MM = (iw / 5) + 1;
-      DD = (iw % 5) * 5 + 1;
-      TT = 0.0;
-    } else {
-      MM = (iw % 12) + 1;
-      DD = 1;
-      YY = YY - dYea + (iw / 12);
-      TT = 0.0;
-    }
-
-    if (fTrans)
-      for (obj = 0; obj <= oNorm; obj++)
-        SwapN(ignore[obj], ignore2[obj]);
-    if (us.fProgress = fProg) {
-      is.JDp = MdytszToJulian(MM, DD, YY, TT, SS, ZZ);
-      ciCore = ciMain;
+    SetTransitGraphSlice(&ciT, iw, dYea);
+    if (fSeries)
+      EphemSeriesCast(&tsr, MdytszToJulian(MM, DD, YY, TT, SS, ZZ));
+    else {
+      if (fTrans)
+        for (obj = 0; obj <= oNorm; obj++)
+          SwapN(ignore[obj], ignore2[obj]);
+      if (us.fProgress = fProg) {
+        is.JDp = MdytszToJulian(MM, DD, YY, TT, SS, ZZ);
+        ciCore = ciMain;
+      }
+      CastChart(-1);
+      if (fTrans)
+        for (obj = 0; obj <= oNorm; obj++)
+          SwapN(ignore[obj], ignore2[obj]);
     }
-    CastChart(-1);
-    if (fTrans)
-      for (obj = 0; obj <= oNorm; obj++)
-        SwapN(ignore[obj], ignore2[obj]);
 
     // Compute aspects present for current time slice.
     if (!fTrans) {
@@ -1189,7 +1826,8 @@ void ChartTransitGraph(flag fTrans, flag fProg)
 
         // Check for and add eclipse information to array too.
         if (fEclipse) {
-          et = NCheckEclipseAny(x, asp, y, &rPct);
+          et = FEclipseCatalogNone(x, asp, y, JulianDayFromTime(is.T)) ?
+            etNone : NCheckEclipseAny(x, asp, y, &rPct);
           if (et > etNone) {
             ppw = &(*rgEph)[y][x][asp];
             if (*ppw == NULL) {
@@ -1346,6 +1984,7 @@ void ChartTransitGraph(flag fTrans, flag fProg)
   // Free temporarily allocated data, and restore original chart.
 LDone:
   AnsiColor(kDefault);
+  DeallocatePIf(tsr.rgr);
   for (y = ymin; y <= is.nObj; y++)
     for (x = 0; x < (fTrans ? is.nObj+1 : y); x++)
       for (asp = 1; asp <= cAsp; asp++) {
@@ -1365,23 +2004,182 @@ LDone:
 
 CONST char *rgszHorizon[4] = {"rises", "zeniths", "sets", "nadirs"};
 
+// Get an object's position at Julian day jd from an ephemeris series, and
+// return its azimuth and altitude given the RAMC mc at that time, along with
+// its hour angle and declination. This is a subprocedure of
+// NHorizonSolveDay().
+
+void HorizonSeriesPos(CONST TSR *ptsr, int obj, real jd, real mc,
+  real *pazi, real *palt, real *pha, real *pdec)
+{
+  real lon, lat;
+
+  EphemSeriesCast(ptsr, jd);
+  EclToHoriz(pazi, palt, planet[obj], planetalt[obj], mc, Lat);
+  lon = planet[obj]; lat = planetalt[obj];
+  EclToEqu(&lon, &lat);
+  *pha = Mod(mc - lon); *pdec = lat;
+}
+
+
+// Find the times during the given day that each object in an ephemeris
+// series rises, sets, or crosses the meridian, for ChartHorizonRising().
+// Instead of scanning through the day in segments, each crossing is
+// predicted from the object's hour angle and declination, then refined with
+// a few Newton steps on positions interpolated from the series. Only the
+// RAMC at the start and end of the day needs a chart cast. Fill out rghi
+// with the events found, and return how many there are.
+
+int NHorizonSolveDay(CONST TSR *ptsr, int mon, int day, int yea,
+  HorizonInfo *rghi)
+{
+  byte rgfNone[objMax];
+  real jd0, jd1, mc0, dmc, ha0, dec0, ha1, dec1, rate, target, jd, jdT, mc,
+    azi, alt, ha, dec, alt2, r, d;
+  int occurcount = 0, mon1, day1, yea1, iob, obj, n, k, i, iter, j;
+
+  // Get the RAMC at the start of the day and the start of the next day.
+  for (i = 0; i < objMax; i++)
+    rgfNone[i] = fTrue;
+  JulianToMdy((real)MdyToJulian(mon, day, yea) + 1.0, &mon1, &day1, &yea1);
+  SetCI(ciCore, mon1, day1, yea1, 0.0, Dst, Zon, Lon, Lat);
+  CastChartPart(-1, rgfNone, 0);
+  jd1 = MdytszToJulian(mon1, day1, yea1, 0.0, Dst, Zon);
+  mc = planet[oMC]; r = planetalt[oMC];
+  EclToEqu(&mc, &r);
+  SetCI(ciCore, mon, day, yea, 0.0, Dst, Zon, Lon, Lat);
+  CastChartPart(-1, rgfNone, 0);
+  jd0 = MdytszToJulian(mon, day, yea, 0.0, Dst, Zon);
+  mc0 = planet[oMC]; r = planetalt[oMC];
+  EclToEqu(&mc0, &r);
+  if (jd1 <= jd0)
+    return 0;
+  d = rDegSidDay*(jd1 - jd0);
+  dmc = (d + MinDifference(Mod(mc0 + d), mc)) / (jd1 - jd0);
+
+  for (iob = 0; iob < ptsr->cob; iob++) {
+    obj = ptsr->rgobj[iob];
+    HorizonSeriesPos(ptsr, obj, jd0, mc0, &azi, &alt, &ha0, &dec0);
+    HorizonSeriesPos(ptsr, obj, jd1, Mod(mc0 + dmc*(jd1 - jd0)),
+      &azi, &alt, &ha1, &dec1);
+    // Rate the object's hour angle increases in degrees per day.
+    rate = dmc + MinDifference(Mod(ha0 + dmc*(jd1 - jd0)), ha1) /
+      (jd1 - jd0);
+    if (rate <= 0.0)
+      continue;
+
+    // Check upper and lower meridian crossings, then rising and setting.
+    for (n = 0; n < 4; n++) {
+      for (k = -1; k <= 1; k++) {
+
+        // Predict when the hour angle reaches the crossing's value. For
+        // horizon crossings that depends on declination, so repeat with the
+        // declination and hour angle at the predicted time.
+        dec = dec0;
+        jd = jd0;
+        for (iter = 0; iter < 3; iter++) {
+          if (n < 2)
+            target = n == 0 ? 0.0 : rDegHalf;
+          else {
+            r = -RTanD(Lat) * RTanD(dec);
+            r = Max(r, -1.0); r = Min(r, 1.0);
+            target = DFromR(RAcos(r));
+            if (n == 2)
+              target = rDegMax - target;
+          }
+          if (iter == 0)
+            jd = jd0 + (Mod(target - ha0) + rDegMax*(real)k) / rate;
+          else
+            jd += MinDifference(ha, target) / rate;
+          if (n < 2 || jd < jd0 - 0.5 || jd > jd1 + 0.5)
+            break;
+          HorizonSeriesPos(ptsr, obj, jd, Mod(mc0 + dmc*(jd - jd0)),
+            &azi, &alt, &ha, &dec);
+        }
+        if (jd < jd0 - 0.25 || jd > jd1 + 0.25)
+          continue;
+
+        // Refine the predicted time with Newton's method.
+        d = 1.0;
+        for (iter = 0; iter < 10; iter++) {
+          mc = Mod(mc0 + dmc*(jd - jd0));
+          HorizonSeriesPos(ptsr, obj, jd, mc, &azi, &alt, &ha, &dec);
+          if (n < 2)
+            d = MinDifference(target, ha) / rate;
+          else {
+            jdT = jd + 1.0/1440.0;
+            HorizonSeriesPos(ptsr, obj, jdT, Mod(mc0 + dmc*(jdT - jd0)),
+              &r, &alt2, &r, &r);
+            r = (alt2 - alt) * 1440.0;
+            if (RAbs(r) < rSmall)
+              break;
+            d = alt / r;
+          }
+          d = Max(d, -0.1); d = Min(d, 0.1);
+          jd -= d;
+          if (RAbs(d) < 1.0/86400000.0)
+            break;
+        }
+        if (iter >= 10 || RAbs(d) >= 1.0/86400000.0 || jd < jd0 || jd >= jd1)
+          continue;
+
+        // Get the object's final position at the time of the crossing.
+        HorizonSeriesPos(ptsr, obj, jd, Mod(mc0 + dmc*(jd - jd0)),
+          &azi, &alt, &ha, &dec);
+        if (n < 2)
+          j = 2 + 2*(alt < 0.0);
+        else
+          j = 1 + 2*(MinDistance(azi, rDegHalf) < rDegQuad);
+        if (ignorez[j-1] || occurcount >= MAXINDAY)
+          continue;
+        r = (jd - jd0) * 24.0 * 60.0;
+        for (i = 0; i < occurcount; i++)
+          if (rghi[i].source == obj && rghi[i].type == j &&
+            RAbs(rghi[i].time - r) < 1.0/60.0)
+            break;
+        if (i < occurcount)
+          continue;
+        rghi[occurcount].source = obj;
+        rghi[occurcount].type = j;
+        rghi[occurcount].time = r;
+        rghi[occurcount].pos = planet[obj];
+        rghi[occurcount].fRet = (int)RSgn(ret[obj]);
+        rghi[occurcount].azialt = n < 2 ? alt : azi;
+        rghi[occurcount].iSeg = -1;
+        rghi[occurcount].rSeg = 0.0;
+        occurcount++;
+      }
+    }
+  }
+  return occurcount;
+}
+
+
 // Display a list of planetary rising times relative to the local horizon for
 // the day indicated in the chart information, as specified with the -Zd
 // switch. For the day, the time each planet rises (transits horizon in East
 // half of sky), sets (transits horizon in West), reaches its zenith point
 // (transits meridian in South half of sky), and nadirs (transits meridian in
-// North), is displayed.
+// North), is displayed. When object positions can be interpolated, the times
+// are solved for with NHorizonSolveDay(), with days split among worker
+// processes. Otherwise each day is scanned through in segments.
 
 void ChartHorizonRising(void)
 {
   char sz[cchSzDef];
-  int source[MAXINDAY], type[MAXINDAY], fRet[MAXINDAY],
-    occurcount, division, div, i, j, fT;
-  real time[MAXINDAY], rgalt1[objMax], rgalt2[objMax], azialt[MAXINDAY],
-    pos[MAXINDAY], azi1, azi2, alt1, alt2, mc1, mc2, xA, yA, xV, yV, d, k;
+  HorizonInfo rghi[MAXINDAY], hi;
+  byte rgfIgnore[objMax];
+  int occurcount, division, div, nUse = 0, cw = 0, iw, iDay, cDay, i, j, fT;
+  real rgalt1[objMax], rgalt2[objMax], azi1, azi2, alt1, alt2, mc1, mc2,
+    xA, yA, xV, yV, d, k, jd;
   int yea0, yea1, yea2, mon0, mon1, mon2, day0, day1, day2, counttotal = 0;
-  flag fSav = us.fSeconds, fYear;
+  flag fSav = us.fSeconds, fYear, fSeg, fSolve = fFalse;
   CI ciSav, ciEvent;
+  SEG seg;
+  TSR tsr;
+#ifndef PC
+  int rgfd[cWorkerMax];
+#endif
 
   fT = us.fSidereal; us.fSidereal = fFalse;
   division = us.nDivision;
@@ -1389,6 +2187,16 @@ void ChartHorizonRising(void)
   if (us.fListAuto)
     is.cci = 0;
 
+  // Events whose AstroExpression hook looks at positions keep the charts of
+  // the segment they were found in, to interpolate their charts from.
+  ClearB((pbyte)&seg, sizeof(SEG));
+  seg.dSeg = 1.0 / (real)division;
+#ifdef EXPRESS
+  if (!us.fExpOff && FSzSet(us.szExpRis))
+    nUse = NExpressionChartUse(us.szExpRis);
+#endif
+  fSeg = nUse == 1 && !us.fTopoPos && FChartInterpolable(ignore);
+
   // If -dY in effect, then search through a range of years.
 
   yea1 = yea2 = Yea;
@@ -1398,6 +2206,44 @@ void ChartHorizonRising(void)
     else
       yea2 += (us.nEphemYears - 1);
   }
+
+  // If the objects can be interpolated, sample their positions over the
+  // whole range of days up front, with fewer casts than scanning would take.
+  tsr.rgr = NULL;
+  if (!us.fTopoPos && Zon != zonLMT && Zon != zonLAT) {
+    for (i = 0; i <= is.nObj; i++)
+      rgfIgnore[i] = ignore[i] || !FThing(i);
+    jd = (real)MdyToJulian(fYear ? 1 : Mon, us.fInDayMonth ? 1 : Day, yea1);
+    cDay = (int)((real)MdyToJulian(fYear ? 12 : Mon, us.fInDayMonth ?
+      DayInMonth(fYear ? 12 : Mon, yea2) : Day, yea2) - jd) + 1;
+    fSolve = FEphemSeries(&tsr, rgfIgnore,
+      MdytszToJulian(fYear ? 1 : Mon, us.fInDayMonth ? 1 : Day, yea1,
+      0.0, Dst, Zon) - 1.0, MdytszToJulian(fYear ? 12 : Mon,
+      us.fInDayMonth ? DayInMonth(fYear ? 12 : Mon, yea2) : Day, yea2,
+      0.0, Dst, Zon) + 2.0, cDay * division / 2 + 8);
+  }
+
+  // Have worker processes solve for each day's events in parallel, each
+  // one taking every cw'th day and passing back the events it found.
+  iDay = 0;
+#ifndef PC
+  if (fSolve && cDay > 1 && (cw = NWorkerCount(cDay)) > 1) {
+    iw = IForkWorkers(&cw, rgfd);
+    if (iw >= 0) {
+      us.fNoDisplay = fTrue;
+      for (i = iw; i < cDay; i += cw) {
+        JulianToMdy(jd + (real)i, &mon0, &day0, &yea0);
+        occurcount = NHorizonSolveDay(&tsr, mon0, day0, yea0, rghi);
+        if (!FWriteWorker(rgfd[0], &occurcount, sizeof(int)) ||
+          !FWriteWorker(rgfd[0], rghi, sizeof(HorizonInfo) * occurcount))
+          break;
+      }
+      EndWorker(rgfd[0]);
+    }
+  } else
+    cw = 0;
+#endif
+
   for (yea0 = yea1; yea0 <= yea2; yea0++) {
 
   // If -dy in effect, then search through the whole year, month by month.
@@ -1418,7 +2264,21 @@ void ChartHorizonRising(void)
   for (day0 = day1; day0 <= day2; day0 = AddDay(mon0, day0, yea0, 1)) {
 
   occurcount = 0;
+  seg.ccp = 0;
   ciSav = ciTwin;
+  if (fSolve) {
+#ifndef PC
+    if (cw > 0) {
+      if (!FReadWorker(rgfd[iDay % cw], &occurcount, sizeof(int)) ||
+        occurcount < 0 || occurcount > MAXINDAY ||
+        !FReadWorker(rgfd[iDay % cw], rghi, sizeof(HorizonInfo) * occurcount))
+        occurcount = 0;
+    } else
+#endif
+    occurcount = NHorizonSolveDay(&tsr, mon0, day0, yea0, rghi);
+    iDay++;
+    goto LSort;
+  }
   SetCI(ciCore, mon0, day0, yea0, 0.0, Dst, Zon, Lon, Lat);
   CastChart(-1);
   mc2 = planet[oMC]; k = planetalt[oMC];
@@ -1465,15 +2325,17 @@ void ChartHorizonRising(void)
         k = alt1 + d*(alt2-alt1);
       }
       if (j && !ignorez[j-1] && occurcount < MAXINDAY) {
-        source[occurcount] = i;
-        type[occurcount] = j;
-        time[occurcount] = 24.0*((real)(div-1)+d)/(real)division*60.0;
-        pos[occurcount] = Mod(cp1.obj[i] +
+        rghi[occurcount].source = i;
+        rghi[occurcount].type = j;
+        rghi[occurcount].time = 24.0*((real)(div-1)+d)/(real)division*60.0;
+        rghi[occurcount].pos = Mod(cp1.obj[i] +
           d*MinDifference(cp1.obj[i], cp2.obj[i]));
-        fRet[occurcount] = (int)RSgn(cp1.dir[i]) + (int)RSgn(cp2.dir[i]);
-        azialt[occurcount] = k;
+        rghi[occurcount].fRet = (int)RSgn(cp1.dir[i]) + (int)RSgn(cp2.dir[i]);
+        rghi[occurcount].azialt = k;
+        rghi[occurcount].iSeg = fSeg ? ISegAppend(&seg, &cp1, &cp2, div) : -1;
+        rghi[occurcount].rSeg = d;
         ciSave = ciMain;
-        ciSave.tim = time[occurcount] / 60.0;
+        ciSave.tim = rghi[occurcount].time / 60.0;
         occurcount++;
       }
     }
@@ -1481,15 +2343,11 @@ void ChartHorizonRising(void)
 
   // Sort each event in order of time when it happens during the day.
 
+LSort:
   for (i = 1; i < occurcount; i++) {
     j = i-1;
-    while (j >= 0 && time[j] > time[j+1]) {
-      SwapN(source[j], source[j+1]);
-      SwapN(type[j], type[j+1]);
-      SwapR(&time[j], &time[j+1]);
-      SwapR(&pos[j], &pos[j+1]);
-      SwapN(fRet[j], fRet[j+1]);
-      SwapR(&azialt[j], &azialt[j+1]);
+    while (j >= 0 && rghi[j].time > rghi[j+1].time) {
+      hi = rghi[j]; rghi[j] = rghi[j+1]; rghi[j+1] = hi;
       j--;
     }
   }
@@ -1499,15 +2357,16 @@ void ChartHorizonRising(void)
   for (i = 0; i < occurcount; i++) {
     ciSave = ciMain;
     ciSave.mon = mon0; ciSave.day = day0; ciSave.yea = yea0;
-    ciSave.tim = time[i] / 60.0;
+    ciSave.tim = rghi[i].time / 60.0;
 #ifdef EXPRESS
     // May want to skip this event if AstroExpression says to do so.
     if (!us.fExpOff && FSzSet(us.szExpRis)) {
       ciCore = ciSave;
-      CastChart(-1);
-      ExpSetN(iLetterX, source[i]);
-      ExpSetN(iLetterY, type[i] - 1);
-      ExpSetR(iLetterZ, azialt[i]);
+      if (nUse > 0)
+        SegmentCast(&seg, rghi[i].iSeg, rghi[i].rSeg, ignore, fTrue);
+      ExpSetN(iLetterX, rghi[i].source);
+      ExpSetN(iLetterY, rghi[i].type - 1);
+      ExpSetR(iLetterZ, rghi[i].azialt);
       if (!NParseExpression(us.szExpRis))
         continue;
     }
@@ -1515,7 +2374,8 @@ void ChartHorizonRising(void)
     if (us.fListAuto) {
       // May want to add chart for current event to chart list.
       ciEvent = ciSave;
-      sprintf(sz, "%s %s", szObjDisp[source[i]], rgszHorizon[type[i]-1]);
+      sprintf(sz, "%s %s", szObjDisp[rghi[i].source],
+        rgszHorizon[rghi[i].type-1]);
       ciEvent.nam = SzClone(sz);
       ciEvent.loc = ciDefa.loc;
       FAppendCIList(&ciEvent);
@@ -1525,38 +2385,40 @@ void ChartHorizonRising(void)
     sprintf(sz, "%.3s ", szDay[j]); PrintSz(sz);
     AnsiColor(kDefault);
     sprintf(sz, "%s %s ", SzDate(mon0, day0, yea0, fFalse),
-      SzTim(time[i] / 60.0));
+      SzTim(rghi[i].time / 60.0));
     PrintSz(sz);
-    AnsiColor(kObjA[source[i]]);
-    sprintf(sz, "%7.7s ", szObjDisp[source[i]]); PrintSz(sz);
+    AnsiColor(kObjA[rghi[i].source]);
+    sprintf(sz, "%7.7s ", szObjDisp[rghi[i].source]); PrintSz(sz);
 
-    j = kSignA(SFromZ(pos[i]));
+    j = kSignA(SFromZ(rghi[i].pos));
     AnsiColor(j);
-    sprintf(sz, "%c", fRet[i] > 0 ? '(' : (fRet[i] < 0 ? '[' : '<'));
+    sprintf(sz, "%c",
+      rghi[i].fRet > 0 ? '(' : (rghi[i].fRet < 0 ? '[' : '<'));
     PrintSz(sz);
     if (!us.fSeconds) {
-      sprintf(sz, "%.3s", szSignName[SFromZ(pos[i])]); PrintSz(sz);
+      sprintf(sz, "%.3s", szSignName[SFromZ(rghi[i].pos)]); PrintSz(sz);
     } else {
       if (!us.fSecond1K)
         us.fSeconds = fFalse;
-      PrintZodiac(pos[i]);
+      PrintZodiac(rghi[i].pos);
       us.fSeconds = fSav;
       AnsiColor(j);
     }
-    sprintf(sz, "%c ", fRet[i] > 0 ? ')' : (fRet[i] < 0 ? ']' : '>'));
+    sprintf(sz, "%c ",
+      rghi[i].fRet > 0 ? ')' : (rghi[i].fRet < 0 ? ']' : '>'));
     PrintSz(sz);
 
-    AnsiColor(kElemA[type[i]-1]);
-    sprintf(sz, "%-7s", rgszHorizon[type[i]-1]); PrintSz(sz);
+    AnsiColor(kElemA[rghi[i].type-1]);
+    sprintf(sz, "%-7s", rgszHorizon[rghi[i].type-1]); PrintSz(sz);
     AnsiColor(kDefault);
     PrintSz(" at ");
-    if (FOdd(type[i])) {
-      j = (int)(azialt[i]*60.0)%60;
-      sprintf(sz, "%3d%c%02d'", (int)azialt[i], chDegC, j); PrintSz(sz);
+    if (FOdd(rghi[i].type)) {
+      j = (int)(rghi[i].azialt*60.0)%60;
+      sprintf(sz, "%3d%c%02d'", (int)rghi[i].azialt, chDegC, j); PrintSz(sz);
       if (us.fSeconds) {
-        sprintf(sz, "%02d", (int)(azialt[i]*3600.0)%60); PrintSz(sz);
+        sprintf(sz, "%02d", (int)(rghi[i].azialt*3600.0)%60); PrintSz(sz);
         if (us.fSecond1K) {
-          sprintf(sz, ".%03d", (int)(azialt[i]*3600.0*1000.0)%1000);
+          sprintf(sz, ".%03d", (int)(rghi[i].azialt*3600.0*1000.0)%1000);
           PrintSz(sz);
         }
         PrintCh('\"');
@@ -1565,7 +2427,7 @@ void ChartHorizonRising(void)
       // For rising and setting events, also display a direction vector to
       // make the 360 degree azimuth value thought of easier.
 
-      xA = RCosD(azialt[i]); yA = RSinD(azialt[i]);
+      xA = RCosD(rghi[i].azialt); yA = RSinD(rghi[i].azialt);
       if (RAbs(xA) < RAbs(yA)) {
         xV = RAbs(xA / yA); yV = 1.0;
       } else {
@@ -1574,18 +2436,24 @@ void ChartHorizonRising(void)
       sprintf(sz, " (%.2f%c %.2f%c)",
         yV, yA < 0.0 ? 's' : 'n', xV, xA > 0.0 ? 'e' : 'w'); PrintSz(sz);
     } else
-      PrintAltitude(azialt[i]);
+      PrintAltitude(rghi[i].azialt);
     PrintL();
   }
   counttotal += occurcount;
   } // day0
   } // mon0
   } // yea0
+#ifndef PC
+  if (cw > 0)
+    WaitWorkers(cw, rgfd);
+#endif
   if (counttotal == 0)
     PrintSz("No horizon events found.\n");
 
   // Recompute original chart placements as have overwritten them.
 
+  DeallocatePIf(seg.rgcp);
+  DeallocatePIf(tsr.rgr);
   ciCore = ciMain; ciTwin = ciSav;
   us.fSidereal = fT;
   CastChart(1);
@@ -2010,4 +2878,100 @@ flag ChartExoplanet(flag fColor)
   return fTrue;
 }
 
+
+// Print a catalog of all solar eclipses, lunar eclipses, and occultations of
+// the planets by the Moon visible anywhere on Earth over a span of years
+// starting with the chart's year, as displayed with the -dE switch. With
+// -dE0, list them as comma separated values in UT instead.
+
+void ChartEclipse(void)
+{
+  char sz[cchSzDef];
+  EclipseInfo *pei;
+  real jd1, jd2, rOff, rT;
+  int cYea = Max(us.nEphemYears, 1), count = 0, mon, day, yea, sec, i, n;
+  flag fRet;
+
+  jd1 = MdytszToJulian(mJan, 1, Yea, 0.0, 0.0, 0.0) - 0.5;
+  jd2 = MdytszToJulian(mJan, 1, Yea + cYea, 0.0, 0.0, 0.0) - 0.5;
+#ifdef SWISS
+  fRet = FEclipseCatalog(jd1, jd2);
+#else
+  fRet = FEclipseCatalogCovers(jd1, jd2);
+#endif
+  if (!fRet) {
+    PrintError("Couldn't build eclipse catalog for the time period.");
+    return;
+  }
+
+  rOff = GetOffsetCI(&ciMain) / 24.0;
+  if (us.fEclipseCSV)
+    PrintSz("Date,Time,JD,Event,Object,Type,Magnitude,Begin,End\n");
+  else {
+    sprintf(sz, "Eclipses and occultations over a %d year period:\n",
+      cYea); PrintSz(sz);
+    PrintSz("Day Date");
+    PrintTab(' ', 7);
+    PrintSz("Begin");
+    PrintTab(' ', VSeconds(1, 4, 8));
+    PrintSz("Max");
+    PrintTab(' ', VSeconds(3, 6, 10));
+    PrintSz("End");
+    PrintTab(' ', VSeconds(4, 7, 11));
+    PrintSz("Event");
+    PrintTab(' ', 29);
+    PrintSz("Mag.\n\n");
+  }
+
+  // The catalog may cover more than the span, if loaded from a cache file.
+  for (i = 0; i < is.cei; i++) {
+    pei = &is.rgei[i];
+    if (pei->jd < jd1)
+      continue;
+    if (pei->jd >= jd2)
+      break;
+    count++;
+    if (us.fEclipseCSV) {
+      JulianToMdy(pei->jd, &mon, &day, &yea);
+      sec = (int)(RFract(pei->jd - 0.5) * 86400.0);
+      sprintf(sz, "%d-%02d-%02d,%02d:%02d:%02d,%.6f,%s,%s,%s,%.4f,%.6f,%.6f\n",
+        yea, mon, day, sec / 3600, sec / 60 % 60, sec % 60, pei->jd,
+        pei->obj == oSun ? "Solar" : (pei->obj == oMoo ? "Lunar" :
+        "Occultation"), szObjName[pei->obj], szEclipse[pei->et],
+        pei->mag, pei->jdBeg, pei->jdEnd); PrintSz(sz);
+      continue;
+    }
+
+    // Print date and local times of the event, and what kind it is.
+    rT = pei->jd - rOff;
+    JulianToMdy(rT, &mon, &day, &yea);
+    n = DayOfWeek(mon, day, yea);
+    AnsiColor(kRainbowA[n + 1]);
+    sprintf(sz, "%.3s ", szDay[n]); PrintSz(sz);
+    AnsiColor(kDefault);
+    sprintf(sz, "%s", SzDate(mon, day, yea, fFalse)); PrintSz(sz);
+    AnsiColor(kRedA);
+    sprintf(sz, " %s", SzTim(RFract(pei->jdBeg - rOff - 0.5) * 24.0));
+    PrintSz(sz);
+    AnsiColor(kWhiteA);
+    sprintf(sz, " %s", SzTim(RFract(rT - 0.5) * 24.0)); PrintSz(sz);
+    AnsiColor(kRedA);
+    sprintf(sz, " %s", SzTim(RFract(pei->jdEnd - rOff - 0.5) * 24.0));
+    PrintSz(sz);
+    AnsiColor(pei->et >= etPartial ? kWhiteA : kDefault);
+    if (pei->obj == oSun || pei->obj == oMoo)
+      sprintf(sz, "  %s %s Eclipse", szEclipse[pei->et],
+        pei->obj == oSun ? "Solar" : "Lunar");
+    else
+      sprintf(sz, "  %s Occultation of %s", szEclipse[pei->et],
+        szObjDisp[pei->obj]);
+    PrintSz(sz);
+    PrintTab(' ', 35 - CchSz(sz));
+    AnsiColor(kDefault);
+    sprintf(sz, " %5.3f\n", pei->mag); PrintSz(sz);
+  }
+  if (count == 0 && !us.fEclipseCSV)
+    PrintSz("No eclipses or occultations found.\n");
+}
+
 /* charts3.cpp */
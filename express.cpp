@@ -61,7 +61,7 @@
 ******************************************************************************
 */
 
-#define cfunA 470
+#define cfunA 472
 #ifdef GRAPH
 #define cfunX 70
 #else
@@ -128,11 +128,9 @@
   { xi.rgparVar[I].r = (R); xi.rgparVar[I].fReal = fTrue; }
 #define FRingObj(ring, obj) (FBetween(ring, 0, cRing) && FValidObj(obj))
 
-typedef short * TRIE;
-
 typedef struct _function {
   int ifun;     // Index of function
-  char *szName; // Name of function
+  CONST char *szName; // Name of function
   int nParam;   // Number of parameters function takes
   int nType;    // Types of return value and each parameter
 } FUN;
@@ -144,7 +142,6 @@ typedef struct _parameter {
 } PAR;
 
 typedef struct _AstroexpressionInternal {
-  TRIE rgsTrieFun;      // Trie tree of tokens for AstroExpression parsing
   PAR *rgparVar;        // List of custom variables
   int cparVar;          // Size of list of custom variables
   char **rgszExpMacro;  // List of AstroExpression macros
@@ -153,9 +150,9 @@ typedef struct _AstroexpressionInternal {
   int cszExpStr;        // Size of list of AstroExpression strings
 } XI;
 
-XI xi = {NULL, NULL, 0, NULL, 0, NULL, 0};
+XI xi = {NULL, 0, NULL, 0, NULL, 0};
 
-extern int ILookupTrie P((CONST TRIE, CONST char *, int, flag));
+extern int ILookupFun P((CONST char *, int));
 extern CONST char *PchGetParameter P((CONST char *, PAR *, int, int, flag));
 extern void GetParameter P((CONST char *, PAR *));
 extern void FormatSz P((CONST char *, char *));
@@ -355,6 +352,8 @@ enum _functionindex {
   funAlloc,
   funAllocT,
   funAllocS,
+  funCastHit,
+  funCastMis,
   funAsnObj,
   funAsnHou,
 
@@ -582,7 +581,7 @@ enum _functionindex {
   funAssignZ = cfun-1,
 };
 
-CONST FUN rgfun[cfun] = {
+constexpr FUN rgfun[cfun] = {
 // General functions (independent of Astrolog and astrology)
 {funFalse, "False", 0, I_},
 {funTrue,  "True",  0, I_},
@@ -917,6 +916,8 @@ CONST FUN rgfun[cfun] = {
 {funAlloc,   "Alloc",    0, I_},
 {funAllocT,  "AllocTot", 0, I_},
 {funAllocS,  "AllocSiz", 0, I_},
+{funCastHit, "CastHit",  0, I_},
+{funCastMis, "CastMiss", 0, I_},
 {funAsnObj,  "=Obj",     4, R_IIII},
 {funAsnHou,  "=Hou",     4, R_IIII},
 
@@ -1586,9 +1587,9 @@ flag FEvalFunction(int ifun, PAR *rgpar, char *rgpchEval[2])
   case funNutat:   r = is.rNut; break;
   case funSystem:  n = us.nHouseSystem; break;
   case funAspect:  n = GetAspect(planet, planet, planetalt, planetalt, ret,
-    ret, n1, n2, &r); SetReal(n3, r); break;
+    ret, n1, n2, &r, NULL); SetReal(n3, r); break;
   case funAspect2: n = GetAspect(cp1.obj, cp2.obj, cp1.alt, cp2.alt, cp1.dir,
-    cp2.dir, n1, n2, &r); SetReal(n3, r); break;
+    cp2.dir, n1, n2, &r, NULL); SetReal(n3, r); break;
   case funParall:  n = GetParallel(planet, planet, planetalt, planetalt,
     retalt, retalt, n1, n2, &r); SetReal(n3, r); break;
   case funParall2: n = GetParallel(cp1.obj, cp2.obj, cp1.alt, cp2.alt,
@@ -1623,6 +1624,8 @@ flag FEvalFunction(int ifun, PAR *rgpar, char *rgpchEval[2])
   case funAlloc:   n = is.cAlloc;      break;
   case funAllocT:  n = is.cAllocTotal; break;
   case funAllocS:  n = is.cbAllocSize; break;
+  case funCastHit: n = (int)is.cCastHit;  break;
+  case funCastMis: n = (int)is.cCastMiss; break;
   case funAsnObj:
     if (FRingObj(n1, n2) && FRingObj(n3, n4)) {
       r = rgpcp[n1]->obj[n2] = rgpcp[n3]->obj[n4];
@@ -2142,7 +2145,7 @@ CONST char *PchGetParameter(CONST char *pchCur, PAR *rgpar, int ifun,
   }
 
   // Check for function.
-  ifunT = ILookupTrie(xi.rgsTrieFun, pchParam, cch, fTrue);
+  ifunT = ILookupFun(pchParam, cch);
   if (ifunT >= 0) {
     rgpchEval[0] = rgpchEval[1] = NULL;
 
@@ -2210,299 +2213,140 @@ void GetParameter(CONST char *sz, PAR *ppar)
 
 /*
 ******************************************************************************
-** Trie Tree Routines
+** Function Name Hash Routines
 ******************************************************************************
 */
 
-// Create a trie tree within the buffer rgsOut of size csTrieMax. Returns the
-// size of the trie in shorts, or -1 on failure. The input list of strings is
-// used to create the trie. It does not have to be in sorted order. Trie
-// lookups on strings will return the index they are in the original list. No
-// two strings should be the same. Individual strings shouldn't be longer than
-// 255 characters, or rather trailing unique substrings can't be longer than
-// 255. With signed 16 bit indexes, these tries can't be larger than 32K
-// shorts, or 64K bytes. That can store about 2500 strings.
-//
-// The trie format is a sequence of nodes. "Pointers" to other nodes are
-// indexes into the array of shorts. There are two types of nodes: Standard
-// nodes which handle all the branches from a particular leading substring,
-// and leaf nodes for unique trailing substrings. Standard node format:
-//
-// Short 0: 0 = No string ends at this point. Non-zero = Payload + 1 for
-//   substring leading up to this node.
-// Short 1: High byte = Highest character covered by this node. Low byte =
-//   Lowest character covered. If high character is 0, this is a leaf node.
-// Short 2+: Pointers to nodes for the range of low through high characters.
-//   0 = null pointer. Less than 0 means a string ends with this character,
-//   where value contains -(Payload + 1).
-//
-// Leaf node format:
-// Short 0: Same as standard node.
-// Short 1: Length of trailing substring.
-// Short 2: Payload for the string ending after this point.
-// Short 3+: Range of characters storing final substring to compare against.
-
-int CsCreateTrie(CONST uchar *rgszIn[], int cszIn, TRIE rgsOut, int csTrieMax,
-  flag fInsensitive)
-{
-  uchar rgchStack[cchSzMax];
-  int rgisStack[cchSzMax];
-  long rgchUsed[256], iUsed = 0;
-  int iStack, csOut = 0, isz, ich, chLo, chHi, chT, is, cch, isT,
-    isRemember = 0, csz, iszSav;
-
-  for (ich = 0; ich < 256; ich++)
-    rgchUsed[ich] = 0;
-
-  for (iStack = 0;; iStack++) {
-    if (iStack >= cchSzMax) {
-      Assert(fFalse);
-      return -1;
-    }
-    rgisStack[iStack] = csOut;
-    chLo = 255, chHi = 0, iUsed++, csz = 0;
-
-    // Count how many strings match the current leading substring. Also
-    // get the low and high character for these strings.
-    for (isz = 0; isz < cszIn; isz++) {
-      if (FEqRgch((CONST char *)rgszIn[isz], (CONST char *)rgchStack, iStack,
-        fInsensitive)) {
-        chT = rgszIn[isz][iStack];
-        if (chT != 0) {
-          if (fInsensitive)
-            chT = ChCap(chT);
-          csz++;
-          iszSav = isz;
-          rgchUsed[chT] = iUsed;
-          if (chT < chLo)
-            chLo = chT;
-          if (chT > chHi)
-            chHi = chT;
-        }
-      }
-    }
+// The function names are looked up in a perfect hash table, which is built
+// by the compiler from rgfun[] so no work is done at startup. Names are hashed
+// case insensitively into one of cfunBucket buckets. Each bucket stores a
+// displacement which scrambles the hash of its names into distinct slots of
+// the table, so a lookup is one hash and one string compare. Buckets with the
+// most names are placed first, when the table is emptiest.
 
-    // If no strings match, back up to an earlier node.
-    if (csz <= 0) {
-LPop:
-      loop {
-        // Pop the stack to the parent node.
-        iStack--;
-        if (iStack < 0)
-          goto LDone;
-        is = rgisStack[iStack];
-        chLo = (word)rgsOut[is + 1] & 255;
-        chHi = (word)rgsOut[is + 1] >> 8;
-
-        // Scan for a pointer that hasn't been filled out yet.
-        for (ich = chLo + 1; ich <= chHi; ich++) {
-          if (rgsOut[is + 2 + (ich - chLo)] == 1) {
-            chT = ich;
-            goto LPush;
-          }
-        }
-      }
-    }
+#define cfunSlot   1024
+#define cfunBucket 256
 
-    // Since there's at least one string, there will be a new node. Set the
-    // pointer in the parent node to here.
-    rgsOut[isRemember] = csOut;
+typedef struct _FunctionHash {
+  short rgsDisp[cfunBucket];  // Displacement for each bucket
+  short rgsFun[cfunSlot];     // Function index in each slot, or -1 if empty
+  int cchMax;                 // Length of the longest function name
+  flag fValid;                // Whether each name got its own slot
+} FUNHASH;
 
-    if (csOut >= csTrieMax - 1) {
-      Assert(fFalse);
-      return -1;
-    }
-    rgsOut[csOut++] = 0;  // Short 0
-
-    // If exactly one string matches, create a leaf node.
-    if (csz == 1) {
-      for (ich = iStack; rgszIn[iszSav][ich] != 0; ich++)
-        ;
-      cch = ich - iStack;
-      if (cch > 255) {
-        Assert(fFalse);
-        return -1;
-      }
-      if (csOut >= csTrieMax - 2 - ((cch + 1) >> 1)) {
-        Assert(fFalse);
-        return -1;
-      }
-      rgsOut[csOut++] = cch;  // Short 1
-      rgsOut[csOut++] = 0;    // Short 2
-      CopyRgb((byte *)&rgszIn[iszSav][iStack], (byte *)&rgsOut[csOut],
-        (cch + 1) & ~1);
-      if (fInsensitive)
-        UpperRgch((char *)&rgsOut[csOut], cch);
-      csOut += (cch + 1) >> 1;
-      goto LPop;
-    }
+// Compute the FNV-1a hash of a range of characters, ignoring case. Letters
+// are folded by setting their lowercase bit. That also folds some punctuation
+// together, which is fine since those just share a hash value.
 
-    // Create a standard node.
-    if (csOut >= csTrieMax - 1 - (chHi - chLo + 1)) {
-      Assert(fFalse);
-      return -1;
-    }
-    rgsOut[csOut++] = (chHi << 8) | chLo;  // Short 1
-    // Set those characters in use to the temporary pointer value 1, which
-    // will be filled out later.
-    for (ich = chLo; ich <= chHi; ich++)
-      rgsOut[csOut++] = (rgchUsed[ich] == iUsed);
-    chT = chLo;
-
-LPush:
-    rgchStack[iStack] = chT;
-    isRemember = rgisStack[iStack] + 2 + (chT - chLo);
-    rgsOut[isRemember] = -1;
-  }
+constexpr uint NHashFun(CONST char *pch, int cch)
+{
+  uint n = 2166136261u;
+
+  while (cch-- > 0)
+    n = (n ^ ((uchar)*pch++ | 0x20)) * 16777619u;
+  return n;
+}
 
-LDone:
-  // Fill out payloads. For each string in the input list, walk the trie and
-  // set the appropriate point in it to the string's index in the input list.
-  Assert(csOut != 0);
-  for (isz = 0; isz < cszIn; isz++) {
-    is = 0;
-    for (ich = 0;; ich++) {
-      if (rgszIn[isz][ich] == chNull) {
-        // Handle the substring case (short 0).
-        Assert(rgsOut[is] == 0 || !fInsensitive);
-        rgsOut[is] = isz+1;
-        break;
-      }
-      chLo = (word)rgsOut[is + 1] & 255;
-      chHi = (word)rgsOut[is + 1] >> 8;
-      if (chHi == 0) {
-        // Handle the leaf node case (short 2).
-        Assert(rgsOut[is + 2] == 0 && FEqRgch((char *)&rgsOut[is+3],
-          (char *)&rgszIn[isz][ich], chLo, fInsensitive));
-        rgsOut[is + 2] = isz;
-        break;
-      }
-      chT = rgszIn[isz][ich];
-      if (fInsensitive)
-        chT = ChCap(chT);
-      Assert(chT >= chLo && chT <= chHi);
-      isT = rgsOut[is + 2 + (chT - chLo)];
-      Assert(isT != 0);
-      if (isT <= 0) {
-        // Handle the payload pointer within standard node case.
-        Assert(rgszIn[isz][ich + 1] == chNull);
-        rgsOut[is + 2 + (chT - chLo)] = -(isz+1);
-        break;
-      }
-      is = isT;
-    }
-  }
 
-  return csOut;
+// Scramble a hash value with a bucket's displacement, returning a slot.
+
+constexpr int IHashFunSlot(uint n, int nDisp)
+{
+  n ^= (uint)nDisp * 2654435761u;
+  n ^= n >> 16;
+  n *= 2246822507u;
+  n ^= n >> 13;
+  return n & (cfunSlot-1);
 }
 
 
-// Lookup a string in a trie created with CsCreateTrie. Return -1 if string
-// not found, otherwise return the index of the string in the original list
-// used to create the trie. This lookup is very fast, and not much slower than
-// a single string compare. For strings not in the list, usually don't even
-// have to look at all of its characters before knowing it's not in the trie.
+// Build the perfect hash table over the function names, trying successive
+// displacements for each bucket until all of its names land in empty slots.
 
-int ILookupTrie(CONST TRIE rgsIn, CONST char *rgch, int cch,
-  flag fInsensitive)
+constexpr FUNHASH FhCreateFun()
 {
-  int is = 0, chLo, chHi, ch, cchT;
-  CONST char *pchEnd = rgch + cch, *pch, *pch1, *pch2;
-
-  // Walk the input string, while going from node to node in the trie.
-  for (pch = rgch;; pch++) {
-    if (pch >= pchEnd) {
-
-      // At end of input string. Check whether current node has a payload.
-      if (rgsIn[is] != 0)
-        return rgsIn[is]-1;
-      else
-        return -1;
-    }
-    chLo = (word)rgsIn[is + 1];
-    chHi = chLo >> 8;
-    if (chHi == 0) {
-
-      // Leaf node. Compare rest of input string with substring in node.
-      pch1 = (char *)&rgsIn[is + 3], pch2 = pch, cchT = chLo;
-      if (!fInsensitive) {
-        while (cchT > 0 && *pch1 == *pch2) {
-          Assert(*pch1 != chNull);
-          pch1++, pch2++, cchT--;
-        }
-      } else {
-        while (cchT > 0 && *pch1 == ChCap(*pch2)) {
-          Assert(*pch1 != chNull);
-          pch1++, pch2++, cchT--;
+  FUNHASH fh = {};
+  uint rgn[cfun] = {};
+  int rgifun[cfun] = {}, rgiBucket[cfunBucket+1] = {}, ifun, ib, cfunMax = 0,
+    cfunT, nDisp, i, j;
+
+  for (i = 0; i < cfunSlot; i++)
+    fh.rgsFun[i] = -1;
+  for (ifun = 0; ifun < cfun; ifun++) {
+    if (rgfun[ifun].ifun != ifun)
+      return fh;
+    for (i = 0; rgfun[ifun].szName[i]; i++)
+      ;
+    fh.cchMax = Max(fh.cchMax, i);
+    rgn[ifun] = NHashFun(rgfun[ifun].szName, i);
+    rgiBucket[(rgn[ifun] & (cfunBucket-1)) + 1]++;
+  }
+
+  // Group the names by bucket, so each bucket's names are listed together
+  // within rgifun[] starting at rgiBucket[bucket].
+  for (ib = 0; ib < cfunBucket; ib++) {
+    cfunMax = Max(cfunMax, rgiBucket[ib+1]);
+    rgiBucket[ib+1] += rgiBucket[ib];
+  }
+  for (ifun = 0; ifun < cfun; ifun++) {
+    ib = rgn[ifun] & (cfunBucket-1);
+    rgifun[rgiBucket[ib]++] = ifun;
+  }
+  for (ib = cfunBucket; ib > 0; ib--)
+    rgiBucket[ib] = rgiBucket[ib-1];
+  rgiBucket[0] = 0;
+
+  for (cfunT = cfunMax; cfunT > 0; cfunT--)
+    for (ib = 0; ib < cfunBucket; ib++) {
+      if (rgiBucket[ib+1] - rgiBucket[ib] != cfunT)
+        continue;
+      for (nDisp = 0;; nDisp++) {
+        if (nDisp > 32767)
+          return fh;
+        for (j = rgiBucket[ib]; j < rgiBucket[ib+1]; j++) {
+          i = IHashFunSlot(rgn[rgifun[j]], nDisp);
+          if (fh.rgsFun[i] >= 0)
+            break;
+          fh.rgsFun[i] = rgifun[j];
         }
+        if (j >= rgiBucket[ib+1])
+          break;
+        // Some name collided, so free the slots taken so far and try again.
+        while (--j >= rgiBucket[ib])
+          fh.rgsFun[IHashFunSlot(rgn[rgifun[j]], nDisp)] = -1;
       }
-      if (cchT > 0 || pch + chLo < pchEnd)
-        return -1;
-      else
-        return rgsIn[is + 2];
+      fh.rgsDisp[ib] = nDisp;
     }
-
-    // Standard node. Get pointer to appropriate child node.
-    chLo &= 255;
-    ch = *pch;
-    if (fInsensitive)
-      ch = ChCap(ch);
-    if (ch < chLo || ch > chHi)
-      return -1;
-    is = rgsIn[is + 2 + (ch - chLo)];
-    if (is < 0) {
-      if (pch + 1 == pchEnd)
-        return -is-1;
-      else
-        return -1;
-    } else if (is == 0)
-      return -1;
-  }
+  fh.fValid = fTrue;
+  return fh;
 }
 
 
-// Create trie tree lookup tables for the various action lists. This work is
-// only done once, right before the first lookup is needed.
+constexpr FUNHASH fhFun = FhCreateFun();
+static_assert(fhFun.fValid,
+  "Function table out of order, or names don't hash to distinct slots.");
 
-flag FCreateTries()
-{
-#ifdef DEBUG
-  char sz[cchSzDef];
-#endif
-  char *rgsz[cfun];
-  int csMax = 16000, isz, cs;
 
-  xi.rgsTrieFun = RgAllocate(csMax, short, "trie");
-  if (xi.rgsTrieFun == NULL)
-    return fFalse;
+// Lookup a range of characters in the function name hash table, ignoring
+// case. Return the index of the function in rgfun[], or -1 if not found.
 
-  for (isz = 0; isz < cfun; isz++)
-    rgsz[isz] = rgfun[isz].szName;
-  cs = CsCreateTrie((CONST uchar **)rgsz, cfun, xi.rgsTrieFun, csMax, fTrue);
-  csMax -= cs;
-
-#ifdef DEBUG
-  // Sanity check to ensure the tries are valid. For each string, look it up
-  // in its trie and see if it returns the expected index.
-
-  for (isz = 0; isz < cfun; isz++) {
-    cs = ILookupTrie(xi.rgsTrieFun,
-      rgfun[isz].szName, CchSz(rgfun[isz].szName), fTrue);
-    if (cs != isz) {
-      sprintf(sz, "Function string %d (%s) maps to trie value %d.",
-        isz, rgfun[isz].szName, cs);
-      PrintError(sz);
-      break;
-    }
-    if (rgfun[isz].ifun != isz) {
-      sprintf(sz, "Function %d (%s) defined in slot %d.",
-        rgfun[isz].ifun, rgfun[isz].szName, isz);
-      PrintError(sz);
-      break;
-    }
-  }
-#endif
-  return fTrue;
+int ILookupFun(CONST char *pch, int cch)
+{
+  CONST char *szName;
+  uint n;
+  int ifun, ich;
+
+  if (cch > fhFun.cchMax)
+    return -1;
+  n = NHashFun(pch, cch);
+  ifun = fhFun.rgsFun[IHashFunSlot(n, fhFun.rgsDisp[n & (cfunBucket-1)])];
+  if (ifun < 0)
+    return -1;
+  szName = rgfun[ifun].szName;
+  for (ich = 0; ich < cch; ich++)
+    if (pch[ich] != szName[ich] && ChCap(pch[ich]) != ChCap(szName[ich]))
+      return -1;
+  return szName[cch] == chNull ? ifun : -1;
 }
 
 
@@ -2616,8 +2460,7 @@ long NParseExpression(CONST char *sz)
 {
   PAR par = {0, 0.0, fFalse};  // If parsing fails, assume 0.
 
-  // Ensure the lookup tables have been created.
-  if (us.fNoExp || us.fExpOff || (xi.rgsTrieFun == NULL && !FCreateTries()))
+  if (us.fNoExp || us.fExpOff)
     return par.n;
 
   GetParameter(sz, &par);
@@ -2631,8 +2474,7 @@ real RParseExpression(CONST char *sz)
 {
   PAR par = {0, 0.0, fFalse};  // If parsing fails, assume 0.
 
-  // Ensure the lookup tables have been created.
-  if (us.fNoExp || us.fExpOff || (xi.rgsTrieFun == NULL && !FCreateTries()))
+  if (us.fNoExp || us.fExpOff)
     return par.r;
 
   GetParameter(sz, &par);
@@ -2640,6 +2482,44 @@ real RParseExpression(CONST char *sz)
 }
 
 
+// Scan an expression without evaluating it, and return how much of the
+// current chart it may look at: 0 if none of it, 1 if only object positions
+// and velocities, which can be interpolated between charts, or 2 if anything
+// only a full cast computes, such as houses. Macros and command switches
+// could do anything, so count as the latter.
+
+int NExpressionChartUse(CONST char *sz)
+{
+  CONST char *pch;
+  int nUse = 0, cch;
+
+  for (pch = sz; *pch; pch += cch) {
+    while (*pch == ' ')
+      pch++;
+    for (cch = 0; pch[cch] && pch[cch] != ' '; cch++)
+      ;
+    switch (ILookupFun(pch, cch)) {
+    case funObjLon:  case funObjLat:  case funObjDir:  case funObjDirY:
+    case funObjDirL: case funObjLonN: case funObjLatN: case funObjDirN:
+    case funObjDirYN: case funObjDirLN: case funObjLen: case funObjLenN:
+    case funObjX:    case funObjY:    case funObjZ:    case funObjXN:
+    case funObjYN:   case funObjZN:   case funObjAng:  case funAspect:
+    case funParall:
+      nUse = Max(nUse, 1);
+      break;
+    case funObjHou:  case funObjHouN: case funCusp:    case funCusp3D:
+    case funSector:  case funLonHou:  case funLonHou3: case funJulianT:
+    case funLatLmt:  case funOblique: case funRAMC:    case funDeltaT:
+    case funSidDiff: case funNutat:   case funGridNam: case funGridVal:
+    case funGridDo:  case funGridDo2: case funAsnObj:  case funAsnHou:
+    case funMacro:   case funSwitch:
+      return 2;
+    }
+  }
+  return nUse;
+}
+
+
 // Parse an arbitrary integer or real expression, and display its result.
 
 flag ShowParseExpression(CONST char *sz)
@@ -2647,8 +2527,7 @@ flag ShowParseExpression(CONST char *sz)
   PAR par = {0, 0.0, fFalse};  // If parsing fails, assume 0.
   char szMsg[cchSzMax], szNum[cchSzDef];
 
-  // Ensure the lookup tables have been created.
-  if (us.fNoExp || (xi.rgsTrieFun == NULL && !FCreateTries()))
+  if (us.fNoExp)
     return fFalse;
 
   GetParameter(sz, &par);
@@ -2808,7 +2687,6 @@ void ExpFinalize(void)
 {
   int i;
 
-  DeallocatePIf(xi.rgsTrieFun);
   DeallocatePIf(xi.rgparVar);
   if (xi.rgszExpMacro != NULL) {
     for (i = 0; i < xi.cszExpMacro; i++)
@@ -76,6 +76,15 @@ extern flag FProcessSwitches P((int, char **));
 extern void InitRestrictions P((flag));
 extern void InitProgram P((void));
 extern void FinalizeProgram P((flag));
+#ifndef PC
+extern int NParseRequest P((char *, char **));
+extern void RunRequest P((int, char **, int));
+extern void ServeRequest P((char *, int));
+extern flag FReadRequest P((FILE *, char *, int));
+extern void EndServer P((int));
+extern void ServeCharts P((void));
+extern void RunBatch P((void));
+#endif
 
 
 // From data.cpp
@@ -282,6 +291,7 @@ extern flag FMatchSz P((CONST char *, CONST char *));
 extern CONST char *SzInList P((CONST char *, CONST char *, int *));
 extern void ClearB P((pbyte, int));
 extern void CopyRgb P((CONST byte *, byte *, int));
+extern flag FEqRgb P((CONST byte *, CONST byte *, int));
 extern void CopyRgchToSz P((CONST char *, int, char *, int));
 extern real RSgn P((real));
 extern real RAngle P((real, real));
@@ -319,6 +329,7 @@ extern void SetCentric P((int));
 extern int ObjOrbit P((int));
 extern int ObjMoons P((int));
 extern real RObjDiam P((int));
+extern PrintTable *PptGetPrintTable P((flag));
 extern void PrintSz P((CONST char *));
 extern void PrintCh P((char));
 extern void PrintTab P((char, int));
@@ -326,6 +337,12 @@ extern void PrintCh2 P((char));
 extern void PrintTab2 P((char, int));
 extern void PrintSzScreen P((CONST char *));
 extern void PrintSzFormat P((CONST char *, flag));
+extern void PrintJSON P((CONST char *));
+extern void PrintJSONBegin P((CONST char *));
+extern void PrintJSONSz P((CONST char *, CONST char *));
+extern void PrintJSONN P((CONST char *, int));
+extern void PrintJSONR P((CONST char *, real));
+extern void PrintJSONEnd P((void));
 extern void PrintProgress P((CONST char *));
 extern void PrintNotice P((CONST char *));
 extern void PrintWarning P((CONST char *));
@@ -359,6 +376,8 @@ extern int NFromAltN P((int));
 extern char *SzProcessProgname P((char *));
 extern flag FAppendCIList P((CONST CI *));
 extern flag FSortCIList P((int));
+extern void SortTransTarget P((TransTarget *, int));
+extern int ITransTargetFind P((CONST TransTarget *, int, real));
 extern void FilterCIList P((CONST char *, CONST char *));
 extern flag FEnumerateCIList P((int));
 extern int UTF8ToWch P((CONST uchar *, wchar *));
@@ -377,6 +396,19 @@ extern pbyte PAllocate P((long, CONST char *));
 extern void DeallocateP P((void *));
 extern pbyte RgReallocate P((void *, int, int, int, CONST char *));
 extern flag FEnsureMacro P((int));
+extern real RTimer P((void));
+extern void TraceBegin P((CONST char *));
+extern void TraceEnd P((void));
+extern flag FPrintTrace P((void));
+extern int NWorkerCount P((int));
+#ifndef PC
+extern flag FDetachWorkerFiles P((flag));
+extern int IForkWorkers P((int *, int *));
+extern flag FReadWorker P((int, void *, long));
+extern flag FWriteWorker P((int, CONST void *, long));
+extern void EndWorker P((int));
+extern void WaitWorkers P((int, int *));
+#endif
 #ifdef DEBUG
 extern void Assert P((flag));
 #else
@@ -400,10 +432,13 @@ extern flag FOutputData P((void));
 extern flag FOutputAAFFile P((void));
 extern flag FOutputQuickFile P((void));
 extern flag FOutputChartList P((void));
+extern flag FOutputPositions P((flag));
 #ifdef SWISSGRAPH
 extern flag FOutputDaedalusStar P((void));
 #endif
 extern flag FOutputSettings P((void));
+extern flag FOutputEclipse P((CONST char *));
+extern flag FInputEclipse P((CONST char *));
 extern void OpenDir P((CONST char *));
 extern int NFromSz P((CONST char *));
 extern real RFromSz P((CONST char *));
@@ -414,8 +449,19 @@ extern int NInputRange P((CONST char *, int, int, int));
 extern real RInputRange P((CONST char *, real, real, int));
 extern flag FInputData P((CONST char *));
 #ifdef JPLWEB
+extern void JPLHorizonsURL P((char *, int, CONST char *, CONST char *,
+  CONST char *));
+extern int NReadJPLHorizons P((CONST char *, PT3R *, int, char *));
+extern void JPLHorizonsVector P((CONST PT3R *,
+  real *, real *, real *, real *, real *, real *));
 extern flag GetJPLHorizons P((int,
   real *, real *, real *, real *, real *, real *, char *));
+extern flag FInputJPLCache P((CONST char *));
+extern flag FOutputJPLBlock P((CONST JPLBlock *));
+extern JPLBlock *PjbNewJPLBlock P((void));
+extern void JPLInterpolate P((CONST JPLBlock *, real, PT3R *));
+extern flag FJPLHorizonsCache P((int, real,
+  real *, real *, real *, real *, real *, real *));
 #endif
 
 
@@ -440,6 +486,7 @@ extern real MdytszToJulian P((int, int, int, real, real, real));
 extern void JulianToMdy P((real, int *, int *, int *));
 extern real RHousePlaceIn3DCore P((real, real));
 extern real RHousePlaceIn3D P((real, real));
+extern int NHousePlaceInCusp P((real, CONST real *));
 extern int NHousePlaceIn P((real, real));
 extern void ComputeInHouses P((void));
 extern void ComputeHouses P((int));
@@ -456,12 +503,29 @@ extern void CoorXformFast P((real *, real *,
   real, real, real, real, real, real));
 extern void ProcessPlanet P((int, real));
 extern void ComputeEphem P((real));
+extern void GetCastSettings P((CCS *));
+extern int GetCastStrings P((CONST char **));
+extern void ClearCastCache P((void));
+extern flag FCastCacheLookup P((void));
+extern void CastCacheStore P((void));
+extern flag FCastHooks P((void));
 extern real CastChart P((int));
+extern real CastChartPart P((int, CONST byte *, int));
+extern void SetCoreJulian P((real));
+extern void RelocSweepRow P((CONST RLS *, CONST RLST *, int, real *));
+extern flag FRelocSweep P((RLS *));
+extern real RHermite P((real, real, real, real, real, real, real *));
+extern flag FChartInterpolable P((CONST byte *));
+extern flag FEphemSeries P((TSR *, CONST byte *, real, real, int));
+extern void EphemSeriesCast P((CONST TSR *, real));
+extern flag FInterpolateChart P((CONST CP *, CONST CP *, CONST byte *, real,
+  real, flag));
 extern void CastSectors P((void));
 extern flag FEnsureGrid P((void));
 extern flag FAcceptAspect P((int, int, int));
+extern flag FAspectGap P((AG *));
 extern int GetAspect P((CONST real *, CONST real *, CONST real *,
-  CONST real *, CONST real *, CONST real *, int, int, real *));
+  CONST real *, CONST real *, CONST real *, int, int, real *, CONST AG *));
 extern int GetParallel P((CONST real *, CONST real *, CONST real *,
   CONST real *, CONST real *, CONST real *, int, int, real *));
 extern flag FCreateGrid P((flag));
@@ -470,7 +534,11 @@ extern int NCheckEclipseSolar P((int, int, int, real *));
 extern int NCheckEclipse P((int, int, real *));
 extern int NCheckEclipseLunar P((int, int, int, real *));
 extern int NCheckEclipseAny P((int, int, int, real *));
+extern flag FEclipseCatalogCovers P((real, real));
+extern flag FEclipseCatalogNone P((int, int, int, real));
 extern int NCheckEclipseSolarLoc P((real, real, real *));
+extern int NEclipseWindow P((real, real, EclipseInfo *, int));
+extern flag FEclipseCatalog P((real, real));
 extern void CreateElemTable P((ET *));
 
 #ifdef SWISS
@@ -480,8 +548,12 @@ extern int rgObjSwiss[cCust], rgTypSwiss[cCust], rgPntSwiss[cCust],
 
 extern flag FSwissPlanet
   P((int, real, int, real *, real *, real *, real *, real *, real *));
+extern char ChSwissHouse P((int));
+extern void SwissHouseTime P((real, real *, real *, real *, real *, real *));
 extern void SwissHouse P((real, real, real, int,
   real *, real *, real *, real *, real *, real *, real *, real *));
+extern void SwissRelocTime P((RLST *, real));
+extern flag FSwissHouseArmc P((CONST RLST *, real, real, real *));
 extern void SwissComputeStars P((real, flag));
 extern flag SwissComputeStar P((real, ES *));
 extern flag SwissComputeStarSort P((real, ES *));
@@ -490,6 +562,7 @@ extern flag SwissComputeAsteroid P((real, ES *, flag));
 extern flag SwissComputeAsteroidSort P((real, ES *));
 extern void SwissGetObjName P((char *, int));
 extern flag FSwissPlanetData P((real, int, real *, real *, real *));
+extern flag FSwissEclipseNext P((int, real, real, EclipseInfo *));
 extern real SwissRefract P((real));
 extern void SwissGetFileData P((real *, real *));
 extern real SwissLatLmt P((real));
@@ -593,6 +666,7 @@ extern void ChartOrbit P((void));
 extern int ChartEsoteric P((flag));
 extern void ChartSector P((void));
 extern flag ChartAstroGraph P((void));
+extern void PrintChartJSON P((flag));
 extern void PrintChart P((flag));
 
 
@@ -604,11 +678,15 @@ extern void ChartListingRelation P((void));
 extern void ChartGridRelation P((void));
 extern void ChartAspectRelation P((void));
 extern void ChartMidpointRelation P((void));
+#ifndef PC
+extern int IForkCastWorker P((int));
+#endif
 extern void CastRelation P((void));
-extern void PrintInDayEvent P((int, int, int, int));
+extern void PrintInDayEvent P((int, int, int, int, flag));
 extern void PrintAspect P((int, real, real, int, int, real, real, char));
 extern void ChartInDayInfluence P((void));
 extern void ChartTransitInfluence P((flag));
+extern void SetTransitGraphSlice P((CONST CI *, int, int));
 extern void ChartTransitGraph P((flag, flag));
 extern flag ChartAstroGraphRelation P((void));
 extern void EclToHoriz P((real *, real *, real, real, real, real));
@@ -622,11 +700,27 @@ extern void DisplayRelation P((void));
 #define FAspectVoid(obj1, obj2, asp) (FBetween(asp, aCon, aSex) && \
   ((obj1) == oMoo || (obj2) == oMoo) && (obj1) <= oPlu && (obj2) <= oPlu)
 
+extern int ISegAppend P((SEG *, CONST CP *, CONST CP *, long));
+extern void SegmentCast P((CONST SEG *, int, real, CONST byte *, flag));
+extern void PrintEventJSON P((int, int, int));
 extern void ChartInDaySearch P((flag));
+extern flag FTransitHouse3D P((CONST CP *, real, real, CONST CP *,
+  CONST CP *, int, real, real, TransInfo *));
+extern flag FTransitAspect P((CONST CP *, CONST CP *, CONST CP *,
+  int, int, int, real, real, TransInfo *));
+extern flag FTransitDisequ P((CONST CP *, CONST CP *, CONST CP *,
+  int, int, real, real, TransInfo *));
+extern real RTransitDecl P((CONST CP *, int));
 extern void ChartTransitSearch P((flag));
+extern TransEvent *PteAppendTransEvent P((TransEvent **, int *, int *));
+extern void ChartTransitSearchList P((flag));
+extern void HorizonSeriesPos P((CONST TSR *, int, real, real,
+  real *, real *, real *, real *));
+extern int NHorizonSolveDay P((CONST TSR *, int, int, int, HorizonInfo *));
 extern void ChartHorizonRising P((void));
 extern void ChartEphemeris P((void));
 extern flag ChartExoplanet P((flag));
+extern void ChartEclipse P((void));
 
 
 // From intrpret.cpp
@@ -703,6 +797,7 @@ extern real ZondefFromIzn P((int));
 
 extern long NParseExpression P((CONST char *));
 extern real RParseExpression P((CONST char *));
+extern int NExpressionChartUse P((CONST char *));
 extern flag ShowParseExpression P((CONST char *));
 extern int NExpGet P((int));
 extern real RExpGet P((int));
@@ -802,6 +897,9 @@ extern CONST char *szDrawObject[objMaxG], *szDrawObject2[objMaxG],
 #define DrawCircle2(x, y, xr, yr) \
   DrawEllipse2((x)-(xr), (y)-(yr), (x)+(xr), (y)+(yr))
 
+#ifdef X11
+extern void FlushDrawX P((void));
+#endif
 extern void DrawColor P((KI));
 extern void DrawThick P((flag));
 extern void DrawPoint P((int, int));
@@ -828,6 +926,7 @@ extern void DrawStar P((int, int, CONST ES *));
 extern void DrawAspect P((int, int, int));
 extern void DrawNakshatra P((int, int, int));
 extern int NFromPch P((CONST char **));
+extern void ClearTurtleCache P((void));
 extern void DrawTurtle P((CONST char *, int, int));
 extern KI KiCity P((int));
 
@@ -904,6 +1003,8 @@ extern void WriteAscii P((FILE *));
 extern void WriteBmp P((FILE *));
 extern flag BeginFileX P((void));
 extern void EndFileX P((void));
+extern void FrameToRgb P((pbyte));
+extern void FrameFilename P((CONST char *, int, char *));
 extern void PsStrokeForce P((void));
 extern void PsStroke P((int));
 extern void PsLineCap P((flag));
@@ -938,9 +1039,17 @@ extern void DrawRing P((int, int, real *, real *, int, int, real,
 extern void DrawObjects P((ObjDraw *, int, int));
 extern void DrawAspectLine
   P((int, int, int, int, real, real, real, real, real, flag));
-extern flag EnumWorldLines P((int *, int *, int *, int *, int *));
+extern flag FAllocLineStore P((LS *, int, int));
+extern void FinishLineStore P((LS *));
+extern void PrintLineStoreName P((CONST LS *, int));
+extern CONST LS *PlsWorldLines P((void));
+extern flag FEnumLineStore P((LE *, int *, int *, int *, int *, int *));
+extern flag EnumWorldLines P((LE *, int *, int *, int *, int *, int *));
 #ifdef CONSTEL
-extern flag EnumConstelLines P((int *, int *, int *, int *, int *));
+extern void AddConstelLine P((LS *, int, int, int, int, int));
+extern void DecodeConstelLines P((LS *));
+extern CONST LS *PlsConstelLines P((void));
+extern flag EnumConstelLines P((LE *, int *, int *, int *, int *, int *));
 extern int LookupConstel P((real, real));
 #endif
 extern flag FReadWorldData P((CONST char **, CONST char **, CONST char **));
@@ -970,6 +1079,8 @@ extern void EquToTelescope P((real, real, TELE *, int *, int *, real*, real*));
 extern void EclToTelescope P((real, real, TELE *, int *, int *, real*, real*));
 
 extern void XChartWheel P((void));
+extern CONST real *RgAstroGraphLine P((int, real, int, int, real));
+extern flag FDrawRelocMap P((flag));
 extern void XChartAstroGraph P((void));
 extern KI FormatGridCell P((char *, int, int, int, flag));
 extern void XChartGrid P((int, int));
@@ -1004,6 +1115,7 @@ extern void XChartWheelMulti P((void));
 extern void XChartGridRelation P((void));
 extern void XChartEphemeris P((void));
 extern void XChartEsoteric P((void));
+extern void SetTransitGraphSliceX P((CONST CI *, int, int, int));
 extern void XChartTransit P((flag, flag));
 extern flag XChartRising P((void));
 extern void XChartBiorhythm P((void));
@@ -1017,6 +1129,7 @@ extern void InitColorsX P((void));
 extern void ResizeWindowToChart P((void));
 extern void BeginX P((void));
 extern void Animate P((int, int));
+extern flag FAnimateFramesX P((void));
 extern void CommandLineX P((void));
 extern void SquareX P((int *, int *, flag));
 extern void InteractX P((void));
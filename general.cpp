@@ -52,6 +52,7 @@
 */
 
 #include "astrolog.h"
+#include <charconv>
 
 
 /*
@@ -215,6 +216,17 @@ void CopyRgb(CONST byte *pbSrc, byte *pbDst, int cb)
 }
 
 
+// Return whether two ranges of a given number of bytes are identical.
+
+flag FEqRgb(CONST byte *pb1, CONST byte *pb2, int cb)
+{
+  while (cb-- > 0)
+    if (*pb1++ != *pb2++)
+      return fFalse;
+  return fTrue;
+}
+
+
 // Copy a range of characters and zero terminate it. If there are too many
 // characters to fit in the destination buffer, the string is truncated.
 
@@ -676,8 +688,11 @@ void EnsureStarBright()
 
 #ifdef SWISS
     // Swiss Ephemeris reads star brightnesses from an external file.
-    if (FCmSwissStar())
+    if (FCmSwissStar()) {
+      TraceBegin("Star brightnesses");
       SwissComputeStars(0.0, fTrue);
+      TraceEnd();
+    }
 #endif
   }
 }
@@ -1053,6 +1068,73 @@ real RObjDiam(int obj)
 ******************************************************************************
 */
 
+// Return a table of the bytes to output for each byte of text, given the
+// current input and output character sets. The two most recently used
+// tables are kept, since PrintCh2() switches character sets back and forth.
+
+PrintTable *PptGetPrintTable(flag fWantIBM)
+{
+  PrintTable *ppt;
+  char szInput[cchSzDef];
+  uchar szCh[2];
+  wchar wch;
+  int nKey, ch, chOut, dch;
+
+  nKey = ((us.nCharset << 3 | us.nCharsetOut) << 1 | fWantIBM) + 1;
+  if (is.rgpt[is.ipt].nKey == nKey)
+    return &is.rgpt[is.ipt];
+  if (is.rgpt[!is.ipt].nKey == nKey) {
+    is.ipt = !is.ipt;
+    return &is.rgpt[is.ipt];
+  }
+  is.ipt = !is.ipt;
+  ppt = &is.rgpt[is.ipt];
+  ppt->nKey = nKey;
+
+  // Convert each byte the same way PrintSz() converts single characters.
+  // Newlines and the start of multibyte UTF8 sequences are left to it.
+  for (ch = 0; ch < 256; ch++) {
+    chOut = ch;
+    dch = 0;
+    if (ch == chNull || ch == '\n' || (us.nCharset >= ccUTF8 && ch >= 0x80)) {
+      ppt->rgcch[ch] = 0;
+      continue;
+    }
+    if (us.nCharset >= ccUTF8) {
+      szCh[0] = (uchar)ch; szCh[1] = chNull;
+      UTF8ToWch(szCh, &wch);
+      if (us.nCharsetOut == ccUTF8)
+        dch = WchToUTF8(wch, szInput);
+      else if (fWantIBM || us.nCharsetOut == ccIBM)
+        chOut = ChIBMFromWch(wch);
+      else
+        chOut = ChLatinFromWch(wch);
+    } else if (us.nCharset == ccLatin) {
+      if (us.nCharsetOut == ccUTF8)
+        dch = WchToUTF8(WchFromChLatin(ch), szInput);
+      else if (fWantIBM || us.nCharsetOut == ccIBM)
+        chOut = ChIBMFromWch(WchFromChLatin(ch));
+    } else if (us.nCharset > ccNone) {
+      if (us.nCharsetOut == ccUTF8)
+        dch = WchToUTF8(WchFromChIBM(ch), szInput);
+      else if (!(fWantIBM || us.nCharsetOut == ccIBM))
+        chOut = ChLatinFromWch(WchFromChIBM(ch));
+    }
+    if (dch < 1) {
+      ppt->rgrgch[ch][0] = (char)chOut;
+      ppt->rgcch[ch] = ((uchar)chOut == ch ? -1 : 1);
+    } else {
+      dch = CchSz(szInput);
+      if (dch > 4)
+        dch = 0;
+      CopyRgb((pbyte)szInput, (pbyte)ppt->rgrgch[ch], dch);
+      ppt->rgcch[ch] = (dch == 1 && (uchar)szInput[0] == ch ? -1 : dch);
+    }
+  }
+  return ppt;
+}
+
+
 // Print a string on the screen. A seemingly simple operation, however
 // keep track of what column are printing at after each newline so can
 // automatically clip at the appropriate point, and keep track of the row
@@ -1060,10 +1142,11 @@ real RObjDiam(int obj)
 
 void PrintSz(CONST char *sz)
 {
-  char szInput[cchSzDef], *pch;
+  char szInput[cchSzDef], *pch, *pchRun, *pchEnd, *pchT;
   wchar wch;
-  int ch, dch;
+  int ch, dch, cch;
   flag fWantIBM = fFalse;
+  PrintTable *ppt = NULL;
 #ifndef WIN
   int fT;
 #endif
@@ -1074,8 +1157,40 @@ void PrintSz(CONST char *sz)
   if (is.S == stdout)
     fWantIBM = fTrue;
 #endif
+  // Plain text not going to a window can be output a run at a time.
+#ifdef WIN
+  if (is.S != stdout)
+#endif
+  if (is.nHTML != 1)
+    ppt = PptGetPrintTable(fWantIBM);
   for (pch = (char *)sz; *pch; pch++) {
     ch = (uchar)*pch;
+    if (ppt != NULL && ppt->rgcch[ch] != 0) {
+      // Fast path: Find the run of characters up to the next newline or
+      // multibyte character, and output all of the unclipped ones at once.
+      for (pchRun = pch; ppt->rgcch[(uchar)pch[1]] != 0; pch++)
+        ;
+      cch = (int)(pch - pchRun) + 1;
+      if (is.nHTML != 2) {
+        if (us.fClip80)
+          cch = Min(cch, Max(us.nScreenWidth - 1 - is.cchCol, 0));
+        is.cchCol += (int)(pch - pchRun) + 1;
+      }
+      pchEnd = pchRun + cch;
+      while (pchRun < pchEnd) {
+        for (pchT = pchRun; pchRun < pchEnd &&
+          ppt->rgcch[(uchar)*pchRun] < 0; pchRun++)
+          ;
+        if (pchRun > pchT)
+          fwrite(pchT, 1, pchRun - pchT, is.S);
+        if (pchRun < pchEnd) {
+          fwrite(ppt->rgrgch[(uchar)*pchRun], 1,
+            ppt->rgcch[(uchar)*pchRun], is.S);
+          pchRun++;
+        }
+      }
+      continue;
+    }
     if (ch != '\n') {
       if (is.nHTML != 2) {
         is.cchCol++;
@@ -1323,6 +1438,113 @@ void PrintSzFormat(CONST char *sz, flag fPopup)
 }
 
 
+// Print a string of JSON Lines machine readable output, as done with the -kj
+// switch. Unlike PrintSz(), the text is never clipped, converted to another
+// character set, or colored, and it goes out immediately without being
+// collected into any document first.
+
+void PrintJSON(CONST char *sz)
+{
+  if (!us.fNoDisplay)
+    fputs(sz, is.S);
+}
+
+
+// Start a JSON object on a new line, with a "type" field naming what sort
+// of record it is. Fields are appended with the routines below.
+
+void PrintJSONBegin(CONST char *szType)
+{
+  PrintJSON("{\"type\":\"");
+  PrintJSON(szType);
+  PrintJSON("\"");
+}
+
+
+// Append a string field to a JSON object, escaping any characters which
+// can't appear within a JSON string as is.
+
+void PrintJSONSz(CONST char *szKey, CONST char *sz)
+{
+  char szT[cchSzDef], *pch;
+  int ch, cch;
+  wchar wch;
+
+  sprintf(szT, ",\"%s\":\"", szKey);
+  PrintJSON(szT);
+  pch = szT;
+  for (; *sz; sz++) {
+    ch = (uchar)*sz;
+    if (ch == '"' || ch == '\\') {
+      *pch++ = '\\'; *pch++ = ch;
+    } else if (ch < ' ') {
+      sprintf(pch, "\\u%04x", ch);
+      pch += 6;
+    } else if (ch >= 0x80) {
+      // JSON is always UTF8, so convert from the input character set. Bytes
+      // that aren't valid UTF8 are assumed to be Latin-1.
+      cch = 1;
+      if (us.nCharset >= ccUTF8 || us.nCharset == ccNone)
+        cch = UTF8ToWch((CONST uchar *)sz, &wch);
+      if (cch > 1)
+        sz += cch-1;
+      else if (us.nCharset == ccIBM)
+        wch = WchFromChIBM(ch);
+      else
+        wch = WchFromChLatin(ch);
+      pch += WchToUTF8(wch, pch);
+    } else
+      *pch++ = ch;
+    if (pch - szT > cchSzDef - 8) {
+      *pch = chNull;
+      PrintJSON(szT);
+      pch = szT;
+    }
+  }
+  *pch++ = '"'; *pch = chNull;
+  PrintJSON(szT);
+}
+
+
+// Append an integer field to a JSON object.
+
+void PrintJSONN(CONST char *szKey, int n)
+{
+  char sz[cchSzDef];
+
+  sprintf(sz, ",\"%s\":%d", szKey, n);
+  PrintJSON(sz);
+}
+
+
+// Append a real number field to a JSON object. The number is written with
+// the fewest digits which still read back as exactly the same value.
+
+void PrintJSONR(CONST char *szKey, real r)
+{
+  char sz[cchSzDef], *pch;
+  std::to_chars_result tcr;
+
+  sprintf(sz, ",\"%s\":", szKey);
+  for (pch = sz; *pch; pch++)
+    ;
+  tcr = std::to_chars(pch, sz + cchSzDef - 1, (double)r);
+  *tcr.ptr = chNull;
+  // JSON has no way to write infinity or NaN.
+  if (tcr.ec != std::errc() || FBetween(pch[*pch == '-'], 'a', 'z'))
+    sprintf(pch, "null");
+  PrintJSON(sz);
+}
+
+
+// Finish the current JSON object, ending its line.
+
+void PrintJSONEnd(void)
+{
+  PrintJSON("}\n");
+}
+
+
 // Print a partial progress message given a string. This is meant to be used
 // in the middle of long operations such as creating and saving files.
 
@@ -1534,9 +1756,11 @@ void AnsiColor(int k)
 #endif
 
   // Special case: If passed the "color" Reverse, and Ansi color is not only
-  // on but set to a value > 1, then enter reverse video mode.
+  // on but set to a value > 1, then enter reverse video mode. JSON output
+  // with -kj never has colors.
 
-  if (!us.fAnsiColor || (k == kReverse && us.fAnsiColor < 2))
+  if (!us.fAnsiColor || (k == kReverse && us.fAnsiColor < 2) ||
+    us.fTextJSON)
     return;
   cchSav = is.cchCol;
   is.cchCol = 0;
@@ -2255,9 +2479,11 @@ flag FAppendCIList(CONST CI *pci)
       return fTrue;
   }
 
-  // Extend the size of the chart list allocation if necessary.
+  // Extend the size of the chart list allocation if necessary. Grow by half
+  // again each time, so importing a huge file doesn't copy the list over and
+  // over.
   if (is.cci >= is.cciAlloc) {
-    cciAlloc = is.cciAlloc + 500;
+    cciAlloc = is.cciAlloc + Max(500, is.cciAlloc >> 1);
     pciNew = RgAllocate(cciAlloc, CI, "chart list");
     if (pciNew == NULL)
       return fFalse;
@@ -2369,6 +2595,43 @@ flag FSortCIList(int nMethod)
 }
 
 
+// Sort a list of natal transit targets by position, using shell sort.
+
+void SortTransTarget(TransTarget *rgtt, int ctt)
+{
+  int ig, gap, i, j;
+  TransTarget ttT;
+
+  for (ig = cShellGap-1; ig >= 0; ig--) {
+    gap = rgnShellGap[ig];
+    for (i = gap; i < ctt; i++) {
+      ttT = rgtt[i];
+      for (j = i; j >= gap && rgtt[j - gap].pos > ttT.pos; j -= gap)
+        rgtt[j] = rgtt[j - gap];
+      rgtt[j] = ttT;
+    }
+  }
+}
+
+
+// Given a list of transit targets sorted by position, return the index of
+// the first target whose position is at least the given value.
+
+int ITransTargetFind(CONST TransTarget *rgtt, int ctt, real pos)
+{
+  int iLo = 0, iHi = ctt, i;
+
+  while (iLo < iHi) {
+    i = (iLo + iHi) >> 1;
+    if (rgtt[i].pos < pos)
+      iLo = i+1;
+    else
+      iHi = i;
+  }
+  return iLo;
+}
+
+
 // Filter the program's chart list to those charts that meet a criteria,
 // deleting all other charts from the list that don't meet it.
 
@@ -3079,6 +3342,311 @@ flag FEnsureMacro(int cszNew)
 }
 
 
+// Return a wall clock time in seconds, with fractional precision, relative to
+// some arbitrary point. Used to time how long lengthy operations take.
+
+real RTimer()
+{
+#ifndef PC
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (real)tv.tv_sec + (real)tv.tv_usec / 1000000.0;
+#else
+  return (real)GetTickCount() / 1000.0;
+#endif
+}
+
+
+// Start timing a named phase of program startup, for the -YL switch. Phases
+// may nest, and each one must be closed with a matching TraceEnd(). Timing
+// is always recorded, since it's cheap, so the phases before the -YL switch
+// itself is processed are included when the trace is printed.
+
+void TraceBegin(CONST char *sz)
+{
+  TraceMark *ptm;
+
+  if (is.ctm >= cTraceMax) {
+    is.ntmSkip++;
+    return;
+  }
+  ptm = &is.rgtm[is.ctm++];
+  ptm->sz = sz;
+  ptm->nDepth = is.ntmDepth++;
+  ptm->rTime = -1.0;
+  ptm->rStart = RTimer();
+}
+
+
+// Finish timing the most recently started startup phase still in progress.
+
+void TraceEnd(void)
+{
+  int i;
+
+  if (is.ntmSkip > 0) {
+    is.ntmSkip--;
+    return;
+  }
+  for (i = is.ctm-1; i >= 0; i--)
+    if (is.rgtm[i].rTime < 0.0) {
+      is.rgtm[i].rTime = RTimer() - is.rgtm[i].rStart;
+      is.ntmDepth--;
+      return;
+    }
+}
+
+
+// Print the hierarchical breakdown of how long each phase of startup took,
+// as recorded by TraceBegin() and TraceEnd(), and stop recording. Return
+// whether the total exceeded the budget in milliseconds given to -YL.
+
+flag FPrintTrace(void)
+{
+  char sz[cchSzMax];
+  TraceMark *ptm;
+  real rTotal = 0.0, rSelf;
+  int i, j;
+  flag fOver;
+
+  AnsiColor(kWhiteA);
+  PrintSz("Startup phase                          Time (us)  Self (us)\n");
+  AnsiColor(kDefault);
+  for (i = 0; i < is.ctm; i++) {
+    ptm = &is.rgtm[i];
+    if (ptm->rTime < 0.0)
+      ptm->rTime = RTimer() - ptm->rStart;
+    if (ptm->nDepth == 0)
+      rTotal += ptm->rTime;
+
+    // Self time is what's left after subtracting immediate children.
+    rSelf = ptm->rTime;
+    for (j = i+1; j < is.ctm && is.rgtm[j].nDepth > ptm->nDepth; j++)
+      if (is.rgtm[j].nDepth == ptm->nDepth+1 && is.rgtm[j].rTime >= 0.0)
+        rSelf -= is.rgtm[j].rTime;
+    sprintf(sz, "%*s%-*.*s %10.0f %10.0f\n", ptm->nDepth*2, "",
+      36 - ptm->nDepth*2, 36 - ptm->nDepth*2, ptm->sz, ptm->rTime * 1000000.0,
+      Max(rSelf, 0.0) * 1000000.0);
+    PrintSz(sz);
+  }
+  sprintf(sz, "%-36.36s %10.0f\n", "Total", rTotal * 1000000.0);
+  PrintSz(sz);
+
+  // Stop recording, so later -Q loop iterations don't add phases.
+  is.ntmSkip += is.ntmDepth;
+  is.ntmDepth = 0;
+  is.ctm = cTraceMax;
+  fOver = us.nTraceBudget > 0 && rTotal * 1000.0 > (real)us.nTraceBudget;
+  if (fOver) {
+    sprintf(sz, "Startup took %.3f milliseconds, over the -YL budget of %d.",
+      rTotal * 1000.0, us.nTraceBudget);
+    PrintWarning(sz);
+  }
+  return fOver;
+}
+
+
+// Return the number of parallel worker processes to use for an operation
+// with the given number of independent jobs, as set with -YW, or else one
+// for each processor. Parallelism is only supported on Unix systems.
+
+int NWorkerCount(int cJob)
+{
+  int cw = us.nWorker;
+
+#ifndef PC
+  if (cw <= 0)
+    cw = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+  cw = 1;
+#endif
+  if (cw > cJob)
+    cw = cJob;
+#ifndef PC
+  // Workers which can't be given their own files can't run at the same time.
+  if (cw > 1 && !FDetachWorkerFiles(fFalse))
+    cw = 1;
+#endif
+  return Max(Min(cw, cWorkerMax), 1);
+}
+
+
+#ifndef PC
+// Give a new worker process its own file offsets for any files it has open
+// for reading, e.g. ephemeris files, by opening them again. Otherwise a
+// worker and its parent would share the same offsets and could move them out
+// from under each other. If fDetach is false, just return whether that can
+// be done, which requires the system to say what path each file was opened
+// with. This is possible on Linux and Mac systems, or if no files are open.
+
+flag FDetachWorkerFiles(flag fDetach)
+{
+  struct stat st;
+#ifdef F_GETPATH
+  char sz[MAXPATHLEN];
+#else
+  char sz[cchSzDef];
+#endif
+  int fd, fdNew;
+
+  for (fd = 3; fd < 256; fd++) {
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) ||
+      (fcntl(fd, F_GETFL) & O_ACCMODE) != O_RDONLY)
+      continue;
+#ifdef __linux__
+    sprintf(sz, "/proc/self/fd/%d", fd);
+#elif defined(F_GETPATH)
+    if (fcntl(fd, F_GETPATH, sz) < 0)
+      return fFalse;
+#else
+    return fFalse;
+#endif
+    if (!fDetach)
+      continue;
+    fdNew = open(sz, O_RDONLY);
+    if (fdNew < 0)
+      continue;
+    lseek(fdNew, lseek(fd, 0, SEEK_CUR), SEEK_SET);
+    dup2(fdNew, fd);
+    close(fdNew);
+  }
+  return fTrue;
+}
+
+
+// Start worker processes, each a copy of this one with all current settings,
+// connected back to this process by a pipe. In each worker, return the
+// worker's index, with rgfd[0] set to the pipe to write results into. In the
+// parent, return -1, with rgfd[] set to the pipes to read each worker's
+// results from. If not all the processes could be started, none are used,
+// and *pcw is set to 0 so the caller will do all the work itself.
+
+int IForkWorkers(int *pcw, int *rgfd)
+{
+  int iw, j, rgfdT[2];
+  pid_t pid, rgpid[cWorkerMax];
+
+  fflush(NULL);    // Don't have workers repeat any pending output.
+  Assert(*pcw <= cWorkerMax);
+  for (iw = 0; iw < *pcw; iw++) {
+    if (pipe(rgfdT) < 0)
+      break;
+    pid = fork();
+    if (pid < 0) {
+      close(rgfdT[0]);
+      close(rgfdT[1]);
+      break;
+    }
+    if (pid == 0) {
+      for (j = 0; j < iw; j++)
+        close(rgfd[j]);
+      close(rgfdT[0]);
+      rgfd[0] = rgfdT[1];
+      ClearB((pbyte)is.rgpidWorker, sizeof(is.rgpidWorker));
+      FDetachWorkerFiles(fTrue);
+      return iw;
+    }
+    close(rgfdT[1]);
+    rgfd[iw] = rgfdT[0];
+    rgpid[iw] = pid;
+  }
+  if (iw < *pcw) {
+    // Workers divide up the work assuming they all exist, so stop any that
+    // were started.
+    for (j = 0; j < iw; j++) {
+      kill(rgpid[j], SIGKILL);
+      close(rgfd[j]);
+    }
+    for (j = 0; j < iw; j++)
+      waitpid(rgpid[j], NULL, 0);
+    PrintWarning("Couldn't start all parallel worker processes.");
+    *pcw = 0;
+    return -1;
+  }
+
+  // Remember each worker's process, for WaitWorkers() to wait for.
+  for (iw = 0, j = 0; iw < *pcw; iw++) {
+    while (j < cWorkerMax && is.rgpidWorker[j] != 0)
+      j++;
+    Assert(j < cWorkerMax);
+    if (j >= cWorkerMax)
+      break;
+    is.rgfdWorker[j] = rgfd[iw];
+    is.rgpidWorker[j] = rgpid[iw];
+  }
+  return -1;
+}
+
+
+// Read a block of data of the given size from a worker's pipe, waiting until
+// all of it arrives. Return false if the worker exited before sending it.
+
+flag FReadWorker(int fd, void *pv, long cb)
+{
+  pbyte pb = (pbyte)pv;
+  long cbT;
+
+  while (cb > 0) {
+    cbT = read(fd, pb, cb);
+    if (cbT <= 0)
+      return fFalse;
+    pb += cbT;
+    cb -= cbT;
+  }
+  return fTrue;
+}
+
+
+// Write a block of data of the given size to a worker's pipe.
+
+flag FWriteWorker(int fd, CONST void *pv, long cb)
+{
+  CONST byte *pb = (CONST byte *)pv;
+  long cbT;
+
+  while (cb > 0) {
+    cbT = write(fd, pb, cb);
+    if (cbT <= 0)
+      return fFalse;
+    pb += cbT;
+    cb -= cbT;
+  }
+  return fTrue;
+}
+
+
+// Finish up a worker process, after it has written all its results. Exit
+// immediately without doing any of the main program's normal cleanup.
+
+void EndWorker(int fd)
+{
+  fflush(NULL);
+  close(fd);
+  _exit(0);
+}
+
+
+// Wait for the worker processes connected to the given pipes to exit,
+// closing the pipes to them. Other child processes aren't waited for.
+
+void WaitWorkers(int cw, int *rgfd)
+{
+  int iw, i;
+
+  for (iw = 0; iw < cw; iw++)
+    close(rgfd[iw]);
+  for (iw = 0; iw < cw; iw++)
+    for (i = 0; i < cWorkerMax; i++)
+      if (is.rgpidWorker[i] != 0 && is.rgfdWorker[i] == rgfd[iw]) {
+        waitpid(is.rgpidWorker[i], NULL, 0);
+        is.rgpidWorker[i] = 0;
+        break;
+      }
+}
+#endif // PC
+
+
 #ifdef DEBUG
 // Assert a condition. If not, display an error message.
 
@@ -3108,7 +3676,7 @@ void Terminate(int tc)
   }
   if (tc == tcError && us.fLoop)
     return;
-  if (us.fAnsiColor) {
+  if (us.fAnsiColor && !us.fTextJSON) {
     sprintf(sz, "%c[0m", chEscape);    // Get out of any Ansi color mode.
     PrintSz(sz);
   }
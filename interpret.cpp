@@ -13,6 +13,9 @@
 
 #include "astrolog.h"
 #include <cstring>
+#ifndef PC
+#include <sys/mman.h>
+#endif
 
 #define COMBO_ALLOC 64  // Initial allocation for combo array
 
@@ -267,6 +270,19 @@ void FreeInterpretationStyle(InterpretationStyle *style)
   if (style == NULL)
     return;
 
+  // A compiled style's strings all live inside its mapped image
+  if (style->pbCache != NULL) {
+#ifndef PC
+    munmap(style->pbCache, style->cbCache);
+#else
+    DeallocateP(style->pbCache);
+#endif
+    if (style->filename != NULL)
+      DeallocateP(style->filename);
+    DeallocateP(style);
+    return;
+  }
+
   if (style->filename != NULL)
     DeallocateP(style->filename);
   if (style->name != NULL)
@@ -328,6 +344,316 @@ void FreeInterpretationStyle(InterpretationStyle *style)
 }
 
 
+/*
+******************************************************************************
+** Compiled Style Cache
+******************************************************************************
+*/
+
+// Fill in pointers to each fixed string field of a style, in the order they
+// are stored in a compiled .aisc file.
+static void GetStyleSlots(InterpretationStyle *style, char **rgpsz[cStyleSlot])
+{
+  int i, j = 0;
+
+  rgpsz[j++] = &style->name;
+  rgpsz[j++] = &style->author;
+  rgpsz[j++] = &style->version;
+  rgpsz[j++] = &style->defaultLocation;
+  rgpsz[j++] = &style->defaultAspect;
+  for (i = 0; i < objMax; i++)
+    rgpsz[j++] = &style->planetMeaning[i];
+  for (i = 0; i <= cSign; i++) {
+    rgpsz[j++] = &style->signDesc[i];
+    rgpsz[j++] = &style->signDesire[i];
+    rgpsz[j++] = &style->houseArea[i];
+  }
+  for (i = 0; i <= cAspect; i++) {
+    rgpsz[j++] = &style->aspectInteract[i];
+    rgpsz[j++] = &style->aspectTherefore[i];
+  }
+  Assert(j == cStyleSlot);
+}
+
+
+// FNV-1a hash of a string, used for the compiled combination key index.
+static uint NHashStyleKey(CONST char *sz)
+{
+  uint n = 2166136261u;
+
+  for (; *sz; sz++)
+    n = (n ^ (uchar)*sz) * 16777619u;
+  return n;
+}
+
+
+// Fold a source file's size and modification time into a cache stamp, so a
+// compiled style is rebuilt whenever any of its .ais files change.
+static uint NStampStyleFile(CONST char *szFile, uint nStamp)
+{
+  struct stat statBuf;
+  uint rgn[3];
+  int i;
+
+  if (stat(szFile, &statBuf) != 0)
+    return nStamp;
+  rgn[0] = (uint)statBuf.st_size;
+  rgn[1] = (uint)statBuf.st_mtime;
+  rgn[2] = (uint)((long long)statBuf.st_mtime >> 32);
+  for (i = 0; i < 3; i++)
+    nStamp = (nStamp ^ rgn[i]) * 16777619u;
+  return nStamp;
+}
+
+
+// Insert combination number i into a compiled hash index, unless an earlier
+// entry already has the same key, so lookups still find the first match.
+static void HashStyleCombo(int *rgiHash, int cHash, CONST int *rgib,
+  CONST char *pchPool, int i)
+{
+  uint n;
+  int j;
+  CONST char *szKey = pchPool + rgib[i*2];
+
+  for (n = NHashStyleKey(szKey) & (cHash-1); (j = rgiHash[n]) != 0;
+    n = (n+1) & (cHash-1))
+    if (FEqSz(pchPool + rgib[(j-1)*2], szKey))
+      return;
+  rgiHash[n] = i+1;
+}
+
+
+// Write a loaded style to a compiled .aisc file: one contiguous string pool
+// plus hashed key indexes for the combination tables. The file is written
+// under a temporary name and then renamed, so concurrent processes never see
+// a partial image.
+static flag FWriteStyleCache(InterpretationStyle *style, CONST char *szCache,
+  uint nStamp)
+{
+  StyleCacheHeader sch;
+  char **rgpsz[cStyleSlot], szTemp[cchStylePath + cchSzDef], *pchPool;
+  int *rgib, *rgibCombo, *rgibAsp, *rgiHash, *rgiAsp, cInt, cb, ib, i;
+  pbyte pbImage;
+  FILE *file;
+  flag fRet = fFalse;
+
+  if (us.fNoWrite || style->pbCache != NULL)
+    return fFalse;
+  GetStyleSlots(style, rgpsz);
+
+  // Size the string pool. Offset 0 is an empty string meaning "no value".
+  cb = 1;
+  for (i = 0; i < cStyleSlot; i++)
+    if (*rgpsz[i] != NULL)
+      cb += CchSz(*rgpsz[i]) + 1;
+  for (i = 0; i < style->comboCount; i++)
+    cb += CchSz(style->combos[i].key) + CchSz(style->combos[i].value) + 2;
+  for (i = 0; i < style->aspectComboCount; i++)
+    cb += CchSz(style->aspectCombos[i].key) +
+      CchSz(style->aspectCombos[i].value) + 2;
+
+  ClearB((pbyte)&sch, sizeof(sch));
+  sprintf(sch.szMagic, "@AS%s", szVerCore);
+  sch.nStamp = nStamp;
+  sch.cSlot = cStyleSlot;
+  sch.cCombo = style->comboCount;
+  sch.cAspCombo = style->aspectComboCount;
+  for (sch.cHash = 16; sch.cHash < Max(sch.cCombo, sch.cAspCombo)*2;
+    sch.cHash <<= 1)
+    ;
+  cInt = sch.cSlot + (sch.cCombo + sch.cAspCombo)*2 + sch.cHash*2;
+  sch.ibPool = sizeof(sch) + cInt*sizeof(int);
+  sch.cbImage = sch.ibPool + cb;
+  pbImage = (pbyte)PAllocate(sch.cbImage, "style cache");
+  if (pbImage == NULL)
+    return fFalse;
+  ClearB(pbImage, sch.cbImage);
+  CopyRgb((pbyte)&sch, pbImage, sizeof(sch));
+  rgib = (int *)(pbImage + sizeof(sch));
+  rgibCombo = rgib + sch.cSlot;
+  rgibAsp = rgibCombo + sch.cCombo*2;
+  rgiHash = rgibAsp + sch.cAspCombo*2;
+  rgiAsp = rgiHash + sch.cHash;
+  pchPool = (char *)pbImage + sch.ibPool;
+
+  // Copy each string into the pool, recording its offset.
+  ib = 1;
+#define StoreSz(sz, ibOut) if ((sz) == NULL) ibOut = 0; else { ibOut = ib; \
+  CopyRgb((pbyte)(sz), (pbyte)pchPool + ib, CchSz(sz) + 1); \
+  ib += CchSz(sz) + 1; }
+  for (i = 0; i < cStyleSlot; i++)
+    StoreSz(*rgpsz[i], rgib[i]);
+  for (i = 0; i < sch.cCombo; i++) {
+    StoreSz(style->combos[i].key, rgibCombo[i*2]);
+    StoreSz(style->combos[i].value, rgibCombo[i*2+1]);
+    HashStyleCombo(rgiHash, sch.cHash, rgibCombo, pchPool, i);
+  }
+  for (i = 0; i < sch.cAspCombo; i++) {
+    StoreSz(style->aspectCombos[i].key, rgibAsp[i*2]);
+    StoreSz(style->aspectCombos[i].value, rgibAsp[i*2+1]);
+    HashStyleCombo(rgiAsp, sch.cHash, rgibAsp, pchPool, i);
+  }
+#undef StoreSz
+  Assert(ib == cb);
+
+#ifndef PC
+  sprintf(szTemp, "%s.%d", szCache, (int)getpid());
+#else
+  sprintf(szTemp, "%s.tmp", szCache);
+#endif
+  file = fopen(szTemp, "wb");
+  if (file == NULL)
+    goto LDone;
+  fRet = fwrite(pbImage, 1, sch.cbImage, file) == (size_t)sch.cbImage;
+  fRet &= fclose(file) == 0;
+  if (fRet) {
+#ifdef PC
+    remove(szCache);
+#endif
+    fRet = rename(szTemp, szCache) == 0;
+  }
+  if (!fRet)
+    remove(szTemp);
+LDone:
+  DeallocateP(pbImage);
+  return fRet;
+}
+
+
+// Map a compiled .aisc style file into memory, returning a style whose
+// strings all point into the mapped image, or NULL if the file is missing,
+// stale, or damaged and needs to be rebuilt from its source.
+static InterpretationStyle *PStyleFromCache(CONST char *szCache, uint nStamp,
+  CONST char *szName)
+{
+  StyleCacheHeader *psch;
+  InterpretationStyle *style;
+  char **rgpsz[cStyleSlot], szMagic[8], *pchPool;
+  CONST int *rgib;
+  pbyte pbImage = NULL;
+  long cbImage;
+  int i, cInt;
+#ifndef PC
+  struct stat statBuf;
+  int fd;
+
+  fd = open(szCache, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  if (fstat(fd, &statBuf) == 0 && statBuf.st_size >=
+    (off_t)sizeof(StyleCacheHeader)) {
+    cbImage = (long)statBuf.st_size;
+    pbImage = (pbyte)mmap(NULL, cbImage, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (pbImage == (pbyte)MAP_FAILED)
+      pbImage = NULL;
+  }
+  close(fd);
+#else
+  FILE *file;
+
+  file = fopen(szCache, "rb");
+  if (file == NULL)
+    return NULL;
+  fseek(file, 0, SEEK_END);
+  cbImage = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (cbImage >= (long)sizeof(StyleCacheHeader)) {
+    pbImage = (pbyte)PAllocate(cbImage, "style cache");
+    if (pbImage != NULL &&
+      fread(pbImage, 1, cbImage, file) != (size_t)cbImage) {
+      DeallocateP(pbImage);
+      pbImage = NULL;
+    }
+  }
+  fclose(file);
+#endif
+  if (pbImage == NULL)
+    return NULL;
+
+  // Validate the header against the source stamp and this build's tables.
+  psch = (StyleCacheHeader *)pbImage;
+  sprintf(szMagic, "@AS%s", szVerCore);
+  i = CchSz(szMagic);
+  cInt = psch->cSlot + (psch->cCombo + psch->cAspCombo)*2 + psch->cHash*2;
+  if (!FEqRgch(psch->szMagic, szMagic, i, fFalse) ||
+    psch->szMagic[i] != chNull ||
+    psch->nStamp != nStamp || psch->cbImage != cbImage ||
+    psch->cSlot != cStyleSlot || psch->cCombo < 0 || psch->cAspCombo < 0 ||
+    psch->cHash <= 0 || (psch->cHash & (psch->cHash-1)) != 0 ||
+    psch->ibPool != (int)(sizeof(StyleCacheHeader) + cInt*sizeof(int)) ||
+    psch->ibPool >= cbImage || pbImage[cbImage-1] != chNull)
+    goto LFail;
+  rgib = (CONST int *)(pbImage + sizeof(StyleCacheHeader));
+  for (i = 0; i < psch->cSlot + (psch->cCombo + psch->cAspCombo)*2; i++)
+    if (!FBetween(rgib[i], 0, cbImage - psch->ibPool - 1))
+      goto LFail;
+
+  style = (InterpretationStyle *)PAllocateCore(sizeof(InterpretationStyle));
+  if (style == NULL)
+    goto LFail;
+  ClearB((pbyte)style, sizeof(InterpretationStyle));
+  style->filename = SzClone((char *)szName);
+  style->pbCache = pbImage;
+  style->cbCache = cbImage;
+  style->comboCount = psch->cCombo;
+  style->aspectComboCount = psch->cAspCombo;
+  pchPool = (char *)pbImage + psch->ibPool;
+  GetStyleSlots(style, rgpsz);
+  for (i = 0; i < cStyleSlot; i++)
+    *rgpsz[i] = rgib[i] > 0 ? pchPool + rgib[i] : NULL;
+  style->fLoaded = fTrue;
+  return style;
+
+LFail:
+#ifndef PC
+  munmap(pbImage, cbImage);
+#else
+  DeallocateP(pbImage);
+#endif
+  return NULL;
+}
+
+
+// Look up a combination or aspect combination value by exact key, using the
+// compiled hash index if the style is mapped, or a linear scan if not.
+static CONST char *SzLookupStyleCombo(InterpretationStyle *style,
+  flag fAspect, CONST char *szKey)
+{
+  StyleCacheHeader *psch;
+  InterpretationCombo *rgic;
+  CONST int *rgib, *rgiHash;
+  CONST char *pchPool;
+  uint n;
+  int i, c;
+
+  if (style->pbCache != NULL) {
+    psch = (StyleCacheHeader *)style->pbCache;
+    rgib = (CONST int *)(style->pbCache + sizeof(StyleCacheHeader)) +
+      psch->cSlot;
+    rgiHash = rgib + (psch->cCombo + psch->cAspCombo)*2;
+    if (fAspect) {
+      rgib += psch->cCombo*2;
+      rgiHash += psch->cHash;
+      c = psch->cAspCombo;
+    } else
+      c = psch->cCombo;
+    pchPool = (CONST char *)style->pbCache + psch->ibPool;
+    for (n = NHashStyleKey(szKey) & (psch->cHash-1); (i = rgiHash[n]) != 0;
+      n = (n+1) & (psch->cHash-1))
+      if (FBetween(i, 1, c) && FEqSz(pchPool + rgib[(i-1)*2], szKey))
+        return pchPool + rgib[(i-1)*2+1];
+    return NULL;
+  }
+
+  rgic = fAspect ? style->aspectCombos : style->combos;
+  c = fAspect ? style->aspectComboCount : style->comboCount;
+  for (i = 0; i < c; i++)
+    if (rgic[i].key != NULL && FEqSz(rgic[i].key, szKey))
+      return rgic[i].value;
+  return NULL;
+}
+
+
 // Load an interpretation style from file
 flag FLoadInterpretationStyle(CONST char *szFile)
 {
@@ -339,11 +665,29 @@ flag FLoadInterpretationStyle(CONST char *szFile)
   flag fContinuation = fFalse;
   char *szContinuation = NULL;
   char *szContinuationKey = NULL;  // Save the key for continuation lines
-
-  file = FileOpen((char *)szFile, 0, NULL);
+  char szPath[cchSzMax], szCache[cchSzMax+1];
+  InterpretationStyle *styleCache;
+  uint nStamp;
+
+  // Use the compiled .aisc beside the source if it's still up to date
+  // When asked for the path it found, FileOpen() closes the file itself, and
+  // only returns whether it was found, so the file is opened again below.
+  TraceBegin("Interpretation style");
+  if (FileOpen((char *)szFile, 0, szPath) != NULL) {
+    nStamp = NStampStyleFile(szPath, 2166136261u);
+    sprintf(szCache, "%sc", szPath);
+    style = PStyleFromCache(szCache, nStamp, szFile);
+    if (style != NULL) {
+      im.style[im.styleCount] = style;
+      TraceEnd();
+      return fTrue;
+    }
+    file = fopen(szPath, "r");
+  }
   if (file == NULL) {
     sprintf(szLine, "Could not open interpretation file: %s", szFile);
     PrintError(szLine);
+    TraceEnd();
     return fFalse;
   }
 
@@ -573,6 +917,15 @@ LProcessValue:
   }
 
   style->fLoaded = fTrue;
+
+  // Compile the style so later runs can map it instead of parsing
+  if (FWriteStyleCache(style, szCache, nStamp)) {
+    styleCache = PStyleFromCache(szCache, nStamp, szFile);
+    if (styleCache != NULL) {
+      FreeInterpretationStyle(style);
+      style = styleCache;
+    }
+  }
   im.style[im.styleCount] = style;
   fRet = fTrue;
 
@@ -583,6 +936,7 @@ LDone:
     DeallocateP(szContinuation);
   if (!fRet && style != NULL)
     FreeInterpretationStyle(style);
+  TraceEnd();
   return fRet;
 }
 
@@ -598,7 +952,7 @@ CONST char *SzGetComboInterpretation(int obj, int sign, int house)
 {
   InterpretationStyle *style;
   char szKey[cchSzMax];
-  int i;
+  CONST char *szValue;
 
   // Use custom style if loaded
   if (im.currentStyle < 0 || im.currentStyle >= im.styleCount)
@@ -609,31 +963,23 @@ CONST char *SzGetComboInterpretation(int obj, int sign, int house)
 
   // Try exact match first: "0+1+1" (Sun+Aries+1st)
   sprintf(szKey, "%d+%d+%d", obj, sign, house);
-  for (i = 0; i < style->comboCount; i++) {
-    if (style->combos[i].key != NULL && FEqSz(style->combos[i].key, szKey))
-      return style->combos[i].value;
-  }
+  if ((szValue = SzLookupStyleCombo(style, fFalse, szKey)) != NULL)
+    return szValue;
 
   // Try planet+sign wildcard: "0+1+*" (Sun+Aries+*)
   sprintf(szKey, "%d+%d+*", obj, sign);
-  for (i = 0; i < style->comboCount; i++) {
-    if (style->combos[i].key != NULL && FEqSz(style->combos[i].key, szKey))
-      return style->combos[i].value;
-  }
+  if ((szValue = SzLookupStyleCombo(style, fFalse, szKey)) != NULL)
+    return szValue;
 
   // Try planet+house wildcard: "0+*+1" (Sun+*+1st)
   sprintf(szKey, "%d+*+%d", obj, house);
-  for (i = 0; i < style->comboCount; i++) {
-    if (style->combos[i].key != NULL && FEqSz(style->combos[i].key, szKey))
-      return style->combos[i].value;
-  }
+  if ((szValue = SzLookupStyleCombo(style, fFalse, szKey)) != NULL)
+    return szValue;
 
   // Try sign wildcard: "*+1+*" (Aries+*)
   sprintf(szKey, "*+%d+*", sign);
-  for (i = 0; i < style->comboCount; i++) {
-    if (style->combos[i].key != NULL && FEqSz(style->combos[i].key, szKey))
-      return style->combos[i].value;
-  }
+  if ((szValue = SzLookupStyleCombo(style, fFalse, szKey)) != NULL)
+    return szValue;
 
   // Use default template if available
   if (style->defaultLocation != NULL)
@@ -667,7 +1013,7 @@ CONST char *SzGetAspectComboInterpretation(int obj1, int obj2, int asp)
 {
   InterpretationStyle *style;
   char szKey[cchSzMax];
-  int i;
+  CONST char *szValue;
 
   // Use custom style if loaded
   if (im.currentStyle < 0 || im.currentStyle >= im.styleCount)
@@ -678,24 +1024,18 @@ CONST char *SzGetAspectComboInterpretation(int obj1, int obj2, int asp)
 
   // Try exact match first: "0+4+1" (Sun+Venus+Conjunct)
   sprintf(szKey, "%d+%d+%d", obj1, obj2, asp);
-  for (i = 0; i < style->aspectComboCount; i++) {
-    if (style->aspectCombos[i].key != NULL && FEqSz(style->aspectCombos[i].key, szKey))
-      return style->aspectCombos[i].value;
-  }
+  if ((szValue = SzLookupStyleCombo(style, fTrue, szKey)) != NULL)
+    return szValue;
 
   // Try planet1+planet2 wildcard: "0+4+*" (Sun+Venus+any aspect)
   sprintf(szKey, "%d+%d+*", obj1, obj2);
-  for (i = 0; i < style->aspectComboCount; i++) {
-    if (style->aspectCombos[i].key != NULL && FEqSz(style->aspectCombos[i].key, szKey))
-      return style->aspectCombos[i].value;
-  }
+  if ((szValue = SzLookupStyleCombo(style, fTrue, szKey)) != NULL)
+    return szValue;
 
   // Try aspect wildcard: "*+*+1" (any planet+any planet+Conjunct)
   sprintf(szKey, "*+*+%d", asp);
-  for (i = 0; i < style->aspectComboCount; i++) {
-    if (style->aspectCombos[i].key != NULL && FEqSz(style->aspectCombos[i].key, szKey))
-      return style->aspectCombos[i].value;
-  }
+  if ((szValue = SzLookupStyleCombo(style, fTrue, szKey)) != NULL)
+    return szValue;
 
   return NULL;
 }
@@ -904,8 +1244,9 @@ flag FLoadStyleConfig(InterpretationFolder *folder, CONST char *szPath)
 flag FSetActiveStyle(CONST char *szName)
 {
   int i, j;
-  char szPath[cchStylePath];
-  InterpretationStyle *style = NULL;
+  char szPath[cchStylePath + cchSzDef], szCache[cchStylePath + 16];
+  InterpretationStyle *style = NULL, *styleCache;
+  uint nStamp;
 
   // First ensure we've scanned for folders
   if (ifm.folderCount == 0 && !FInitInterpretationFolders()) {
@@ -921,6 +1262,14 @@ flag FSetActiveStyle(CONST char *szName)
       ifm.folder[i].fActive = fTrue;
       sprintf(ifm.activePath, "%s", ifm.folder[i].path);
 
+      // Switching back to a style already loaded just selects its slot
+      for (j = 0; j < im.styleCount; j++)
+        if (im.stylePath[j] != NULL &&
+          FEqSz(im.stylePath[j], ifm.folder[i].name)) {
+          im.currentStyle = j;
+          return fTrue;
+        }
+
       // Load all .ais files from this folder into an InterpretationStyle
       // First, allocate a new style slot
       if (im.styleCount >= cMaxStyle) {
@@ -928,10 +1277,24 @@ flag FSetActiveStyle(CONST char *szName)
         return fFalse;
       }
 
+      // Map the folder's compiled style.aisc if no .ais file has changed
+      TraceBegin("Interpretation style");
+      nStamp = 2166136261u;
+      for (j = 1; j <= cPlanet; j++) {
+        sprintf(szPath, "%s/signs/%s.ais", ifm.activePath, szObjName[j]);
+        nStamp = NStampStyleFile(szPath, nStamp);
+      }
+      sprintf(szCache, "%s/style.aisc", ifm.activePath);
+      style = PStyleFromCache(szCache, nStamp, ifm.folder[i].displayName);
+      if (style != NULL)
+        goto LAdd;
+
       // Allocate style structure
       style = (InterpretationStyle *)PAllocateCore(sizeof(InterpretationStyle));
-      if (style == NULL)
+      if (style == NULL) {
+        TraceEnd();
         return fFalse;
+      }
       ClearB((pbyte)style, sizeof(InterpretationStyle));
       style->filename = SzClone(ifm.folder[i].displayName);
 
@@ -962,7 +1325,17 @@ flag FSetActiveStyle(CONST char *szName)
       }
 
       style->fLoaded = fTrue;
+      if (FWriteStyleCache(style, szCache, nStamp)) {
+        styleCache = PStyleFromCache(szCache, nStamp,
+          ifm.folder[i].displayName);
+        if (styleCache != NULL) {
+          FreeInterpretationStyle(style);
+          style = styleCache;
+        }
+      }
 
+LAdd:
+      TraceEnd();
       // Add to style array
       j = im.styleCount;
       im.style[j] = style;
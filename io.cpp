@@ -68,7 +68,9 @@
 // Open the file indicated by the given string and return the file's stream
 // pointer, or NULL if the file couldn't be found or opened. All parts of the
 // program which open files to read call this routine. We look in several
-// various locations and directories for the file before giving up.
+// various locations and directories for the file before giving up. If szPath
+// is set, the path of the file found is returned in it, and the file is
+// closed, so the return value only indicates whether it was found.
 
 FILE *FileOpen(CONST char *szFile, int nFileMode, char *szPath)
 {
@@ -311,11 +313,14 @@ flag FOutputData(void)
   if (us.fNoWrite)
     return fFalse;
 
-  // Write other file formats if -od, -ol, -oa, -oq, or -ox is in effect.
+  // Write other file formats if -od, -ol, -ob, -oc, -oa, -oq, or -ox is in
+  // effect.
   if (us.nWriteFormat == 'd')
     return FOutputSettings();
   else if (us.nWriteFormat == 'l')
     return FOutputChartList();
+  else if (us.nWriteFormat == 'b' || us.nWriteFormat == 'c')
+    return FOutputPositions(us.nWriteFormat == 'b');
   else if (us.nWriteFormat == 'a')
     return FOutputAAFFile();
   else if (us.nWriteFormat == 'q')
@@ -437,15 +442,101 @@ flag FOutputData(void)
 }
 
 
+// Read the rest of an open text file into a single memory buffer, so the
+// chart importers below can walk it a line at a time without copying each
+// line or being limited by a fixed line length.
+
+flag FLoadTextBuf(FILE *file, TextBuf *ptb)
+{
+  long lPos, lEnd, cch = 0, cchAlloc;
+  char *rgch;
+  flag fSized;
+
+  ClearB((pbyte)ptb, sizeof(TextBuf));
+  lPos = ftell(file);
+  fSized = lPos >= 0 && fseek(file, 0, SEEK_END) == 0;
+  if (fSized) {
+    lEnd = ftell(file);
+    fseek(file, lPos, SEEK_SET);
+    cchAlloc = Max(lEnd - lPos, 0) + 1;
+  } else
+    cchAlloc = cchSzLine * 16;
+
+  // Size isn't known ahead of time for pipes, so grow the buffer as needed.
+  loop {
+    rgch = (char *)RgReallocate(ptb->rgch, cch, sizeof(char), cchAlloc,
+      "file buffer");
+    if (rgch == NULL) {
+      DeallocatePIf(ptb->rgch);
+      ptb->rgch = NULL;    // So DoneTextBuf() won't free it again.
+      return fFalse;
+    }
+    DeallocatePIf(ptb->rgch);
+    ptb->rgch = rgch;
+    cch += (long)fread(rgch + cch, 1, cchAlloc-1 - cch, file);
+    if (fSized || cch < cchAlloc-1 || feof(file))
+      break;
+    cchAlloc <<= 1;
+  }
+  rgch[cch] = chNull;
+  ptb->pch = rgch;
+  ptb->pchEnd = rgch + cch;
+  return fTrue;
+}
+
+
+// Return the next line from a text file buffer, or NULL at the end of the
+// buffer. The line is zero terminated in place, with any carriage return or
+// other trailing control characters removed.
+
+char *SzTextBufLine(TextBuf *ptb)
+{
+  char *pch, *pchLine = ptb->pch;
+
+  if (pchLine >= ptb->pchEnd)
+    return NULL;
+  pch = (char *)memchr(pchLine, '\n', ptb->pchEnd - pchLine);
+  if (pch == NULL)
+    pch = ptb->pchEnd;
+  ptb->pch = pch + (pch < ptb->pchEnd);
+  while (pch > pchLine && (uchar)pch[-1] < ' ')
+    pch--;
+  *pch = chNull;
+  return pchLine;
+}
+
+
+// Finish importing charts from a text file buffer, freeing it. For large
+// files, report how many chart records were read and how fast.
+
+void DoneTextBuf(TextBuf *ptb, CONST char *szFile, int cci, real rTime)
+{
+  char sz[cchSzLine];
+
+  DeallocatePIf(ptb->rgch);
+  ptb->rgch = ptb->pch = ptb->pchEnd = NULL;
+  if (cci < 1000)
+    return;
+  rTime = RTimer() - rTime;
+  sprintf(sz, "Imported %d charts from '%s' in %.2f seconds "
+    "(%.0f charts per second).", cci, szFile, rTime,
+    (real)cci / Max(rTime, 0.001));
+  PrintProgress(sz);
+}
+
+
 // Load an Astrological Exchange Format (AAF) file into the default set of
 // chart information, given a file name or a file handle.
 
 flag FProcessAAFFile(CONST char *szFile, FILE *file)
 {
-  char szLine[cchSzLine], sz[cchSzMax], *pch, *sz1, *sz2, ch;
-  int i, grf;
+  TextBuf tb;
+  char sz[cchSzLine], *szLine = NULL, *pch, *sz1, *sz2;
+  int grf, cci = is.cci;
+  real rTime = RTimer();
   flag fHaveFile, fRet = fFalse;
 
+  tb.rgch = NULL;
   fHaveFile = (file != NULL);
   if (!fHaveFile) {
     file = FileOpen(szFile, 0, NULL);
@@ -453,25 +544,24 @@ flag FProcessAAFFile(CONST char *szFile, FILE *file)
       goto LDone;
   }
   is.fileIn = file;
-  do {
+  if (!FLoadTextBuf(file, &tb))
+    goto LDone;
+  loop {
 
   grf = 0;
   while (grf != 3) {
-    while (!feof(file) && (ch = getc(file)) < ' ')
-      ;
-    if (feof(file))
+    szLine = SzTextBufLine(&tb);
+    if (szLine == NULL)
       break;
-    for (szLine[0] = ch, i = 1; i < cchSzLine-1 && !feof(file) &&
-      (uchar)(szLine[i] = getc(file)) >= ' '; i++)
-      ;
-    szLine[i] = chNull;
+    while (*szLine && (uchar)*szLine < ' ')
+      szLine++;
     if (szLine[0] == chNull)
       continue;
     if (szLine[0] != '#') {
-      sprintf(szLine,
+      sprintf(sz,
         "The AAF file '%s' has a line not starting with '#' (character %d).",
-        szFile, (int)ch);
-      PrintWarning(szLine);
+        szFile, (int)szLine[0]);
+      PrintWarning(sz);
       goto LDone;
     }
     if (szLine[1] == ':')  // Skip over comment lines
@@ -486,9 +576,9 @@ flag FProcessAAFFile(CONST char *szFile, FILE *file)
       AdvancePast(',');
       pch[-1] = chNull;
       if (*sz1 && !FEqSz(sz1, "*"))
-        sprintf(sz, "%s %s", sz2, sz1);
+        sprintf(sz, "%.*s %.*s", cchSzMax, sz2, cchSzMax, sz1);
       else
-        sprintf(sz, "%s", sz2);
+        sprintf(sz, "%.*s", cchSzMax, sz2);
       ciCore.nam = SzClone(sz);
       AdvancePast(',');
       DD = NFromSz(pch);
@@ -514,9 +604,9 @@ flag FProcessAAFFile(CONST char *szFile, FILE *file)
             *pch = chNull;
       }
       if (*sz1)
-        sprintf(sz, "%s, %s", sz1, sz2);
+        sprintf(sz, "%.*s, %.*s", cchSzMax, sz1, cchSzMax, sz2);
       else
-        sprintf(sz, "%s", sz2);
+        sprintf(sz, "%.*s", cchSzMax, sz2);
       ciCore.loc = SzClone(sz);
       grf |= 1;
 
@@ -538,12 +628,14 @@ flag FProcessAAFFile(CONST char *szFile, FILE *file)
         SS = RParseSz(pch, pmDst);
       grf |= 2;
     } else {
-      sprintf(szLine,
+      sprintf(sz,
         "The AAF file '%s' has a line that can't be parsed.", szFile);
-      PrintWarning(szLine);
+      PrintWarning(sz);
       goto LDone;
     }
   }
+  if (grf == 0)
+    break;
   if (!FValidMon(MM) || !FValidDay(DD, MM, YY) || !FValidYea(YY) ||
     !FValidTim(TT) || !FValidZon(ZZ) || !FValidLon(OO) || !FValidLat(AA)) {
     PrintWarning("Values in AAF file are out of range.");
@@ -551,12 +643,15 @@ flag FProcessAAFFile(CONST char *szFile, FILE *file)
   }
   if (!FAppendCIList(&ciCore))
     goto LDone;
+  if (szLine == NULL)
+    break;
 
-  } while (!feof(file));
+  } // loop
   fRet = fTrue;
 LDone:
+  DoneTextBuf(&tb, szFile, is.cci - cci, rTime);
   is.fileIn = NULL;
-  if (!fHaveFile)
+  if (!fHaveFile && file != NULL)
     fclose(file);
   return fRet;
 }
@@ -635,10 +730,13 @@ flag FOutputAAFFile(void)
 
 flag FProcessQuickFile(CONST char *szFile, FILE *file)
 {
-  char szLine[cchSzMax], sz[cchSzDef];
-  int i;
+  TextBuf tb;
+  char rgchLine[cchSzMax], *szLine, sz[cchSzDef];
+  int i, cci = is.cci;
+  real rTime = RTimer();
   flag fHaveFile, fRet = fFalse;
 
+  tb.rgch = NULL;
   fHaveFile = (file != NULL);
   if (!fHaveFile) {
     file = FileOpen(szFile, 0, NULL);
@@ -646,11 +744,20 @@ flag FProcessQuickFile(CONST char *szFile, FILE *file)
       goto LDone;
   }
   is.fileIn = file;
-  do {
-    fgets(szLine, cchSzMax, file);
-    if (feof(file)) {
-      fRet = fTrue;
-      goto LDone;
+  if (!FLoadTextBuf(file, &tb))
+    goto LDone;
+  while ((szLine = SzTextBufLine(&tb)) != NULL) {
+    i = CchSz(szLine);
+    if (i <= 0)
+      continue;
+
+    // Fields are at fixed columns, so pad out any short line with spaces.
+    if (i < 100) {
+      CopyRgb((pbyte)szLine, (pbyte)rgchLine, i);
+      for (; i < 100; i++)
+        rgchLine[i] = ' ';
+      rgchLine[i] = chNull;
+      szLine = rgchLine;
     }
 
     // Parse line of 100 characters.
@@ -692,12 +799,13 @@ flag FProcessQuickFile(CONST char *szFile, FILE *file)
     }
     if (!FAppendCIList(&ciCore))
       goto LDone;
-  } while (!feof(file));
+  }
 
   fRet = fTrue;
 LDone:
+  DoneTextBuf(&tb, szFile, is.cci - cci, rTime);
   is.fileIn = NULL;
-  if (!fHaveFile)
+  if (!fHaveFile && file != NULL)
     fclose(file);
   return fRet;
 }
@@ -965,10 +1073,13 @@ LDone:
 
 flag FProcessSFTextFile(CONST char *szFile, FILE *file)
 {
-  char szLine[cchSzLine], *pch, *pch2;
-  int nState = -1, cch;
+  TextBuf tb;
+  char *szLine, *pch, *pch2;
+  int nState = -1, cch, cci = is.cci;
+  real rTime = RTimer();
   flag fHaveFile, fRet = fFalse;
 
+  tb.rgch = NULL;
   fHaveFile = (file != NULL);
   if (!fHaveFile) {
     file = FileOpen(szFile, 0, NULL);
@@ -976,11 +1087,9 @@ flag FProcessSFTextFile(CONST char *szFile, FILE *file)
       goto LDone;
   }
   is.fileIn = file;
-  loop {
-
-  fgets(szLine, cchSzMax, file);
-  if (feof(file))
-    break;
+  if (!FLoadTextBuf(file, &tb))
+    goto LDone;
+  while ((szLine = SzTextBufLine(&tb)) != NULL) {
   for (pch = szLine; *pch; pch++)
     ;
   while (pch > szLine && pch[-1] <= ' ')
@@ -1081,7 +1190,7 @@ flag FProcessSFTextFile(CONST char *szFile, FILE *file)
       nState = 0;
   }
 
-  } // loop
+  } // while
   if (nState < 0) {
     PrintWarning("Couldn't detect chart information in text file.");
     goto LDone;
@@ -1089,8 +1198,9 @@ flag FProcessSFTextFile(CONST char *szFile, FILE *file)
 
   fRet = fTrue;
 LDone:
+  DoneTextBuf(&tb, szFile, is.cci - cci, rTime);
   is.fileIn = NULL;
-  if (!fHaveFile)
+  if (!fHaveFile && file != NULL)
     fclose(file);
   return fRet;
 }
@@ -1141,6 +1251,151 @@ flag FOutputChartList()
 }
 
 
+// Cast every chart in the chart list, and write the positions of all
+// unrestricted objects in each to the file indicated by the -ob or -oc
+// switch. The -oc form writes comma separated text, one row per chart. The
+// -ob form writes a columnar binary file suitable for memory mapping: A text
+// schema header names each column, followed by each column in turn, being
+// one native format 8 byte real per chart. Charts are cast in parallel by
+// worker processes, and columns are written a batch of rows at a time.
+
+flag FOutputPositions(flag fBinary)
+{
+  char sz[cchSzMax], *pch;
+  FILE *file;
+  CI ciSav = ciCore, ciSav2 = ciMain;
+  real *rgrRow = NULL, *rgrBatch = NULL;
+  int rgobj[objMax], rgfd[cWorkerMax], cobj = 0, ccol, cw = 1, iw = 0,
+    irow, irow0 = 0, cBatch, i, j;
+  long lData = 0, lT;
+  flag fRet = fFalse;
+
+  if (us.fNoWrite)
+    return fFalse;
+  if (is.cci <= 0) {
+    PrintWarning("There are no charts in the chart list to write.");
+    return fFalse;
+  }
+  for (i = 0; i <= is.nObj; i++)
+    if (!ignore[i])
+      rgobj[cobj++] = i;
+  ccol = cobj * 5;
+  cBatch = Min(is.cci, 4096);
+  rgrRow = RgAllocate(ccol, real, "position row");
+  if (rgrRow == NULL)
+    return fFalse;
+  if (fBinary) {
+    rgrBatch = RgAllocate((long)ccol * cBatch, real, "position batch");
+    if (rgrBatch == NULL)
+      goto LDone;
+  }
+  file = fopen(is.szFileOut, fBinary ? "wb" : "w");
+  if (file == NULL) {
+    sprintf(sz, "Position file %s can not be created.", is.szFileOut);
+    PrintError(sz);
+    goto LDone;
+  }
+
+  // Write the schema header, which for binary files is padded so the
+  // columns start at a multiple of 8 bytes.
+  if (fBinary) {
+    fprintf(file, "@AB%s %d %d %10ld\n", szVerCore, is.cci, ccol, lData);
+    for (j = 0; j < cobj; j++) {
+      pch = (char *)szObjDisp[rgobj[j]];
+      fprintf(file, "%s lon\n%s lat\n%s speed\n%s dist\n%s house\n",
+        pch, pch, pch, pch, pch);
+    }
+    lData = (ftell(file) + 1 + 7) & ~7L;
+    for (lT = ftell(file); lT < lData - 1; lT++)
+      putc(' ', file);
+    putc('\n', file);
+    rewind(file);
+    fprintf(file, "@AB%s %d %d %10ld\n", szVerCore, is.cci, ccol, lData);
+  } else {
+    fprintf(file, "Chart,Name");
+    for (j = 0; j < cobj; j++) {
+      pch = (char *)szObjDisp[rgobj[j]];
+      fprintf(file, ",%s Lon,%s Lat,%s Speed,%s Dist,%s House",
+        pch, pch, pch, pch, pch);
+    }
+    fprintf(file, "\n");
+  }
+
+  // Have worker processes cast the charts in parallel, each one taking
+  // every cw'th chart and passing back its row of positions.
+#ifndef PC
+  cw = is.cci >= 64 ? NWorkerCount(is.cci) : 1;
+  if (cw > 1 && (iw = IForkWorkers(&cw, rgfd)) < 0 && cw <= 0) {
+    cw = 1;
+    iw = 0;
+  }
+#endif
+  for (irow = (iw >= 0 ? iw : 0); irow < is.cci;
+    irow += (iw >= 0 ? cw : 1)) {
+    if (iw >= 0) {
+      ciCore = ciMain = is.rgci[irow];
+      CastChart(1);
+      for (j = 0; j < cobj; j++) {
+        i = rgobj[j];
+        rgrRow[j*5]   = planet[i];
+        rgrRow[j*5+1] = planetalt[i];
+        rgrRow[j*5+2] = ret[i];
+        rgrRow[j*5+3] = cp0.dist[i];
+        rgrRow[j*5+4] = (real)inhouse[i];
+      }
+#ifndef PC
+      if (cw > 1) {
+        if (!FWriteWorker(rgfd[0], rgrRow, ccol * sizeof(real)))
+          break;
+        continue;
+      }
+#endif
+    }
+#ifndef PC
+    else if (!FReadWorker(rgfd[irow % cw], rgrRow, ccol * sizeof(real)))
+      break;
+#endif
+
+    // Add the row to the output, flushing a full batch of binary rows.
+    if (fBinary) {
+      for (j = 0; j < ccol; j++)
+        rgrBatch[(long)j * cBatch + (irow - irow0)] = rgrRow[j];
+      if (irow - irow0 + 1 >= cBatch || irow + 1 >= is.cci) {
+        for (j = 0; j < ccol; j++) {
+          fseek(file, lData + ((long)j * is.cci + irow0) * sizeof(real),
+            SEEK_SET);
+          fwrite(&rgrBatch[(long)j * cBatch], sizeof(real),
+            irow - irow0 + 1, file);
+        }
+        irow0 = irow + 1;
+      }
+    } else {
+      fprintf(file, "%d,\"", irow + 1);
+      for (pch = is.rgci[irow].nam; *pch; pch++)
+        putc(*pch != '"' ? *pch : '\'', file);
+      putc('"', file);
+      for (j = 0; j < ccol; j++)
+        fprintf(file, ",%.7f", rgrRow[j]);
+      putc('\n', file);
+    }
+  }
+#ifndef PC
+  if (iw >= 0 && cw > 1)
+    EndWorker(rgfd[0]);
+  if (iw < 0)
+    WaitWorkers(cw, rgfd);
+#endif
+  fclose(file);
+  fRet = (irow >= is.cci);
+  ciCore = ciSav; ciMain = ciSav2;
+
+LDone:
+  DeallocatePIf(rgrRow);
+  DeallocatePIf(rgrBatch);
+  return fRet;
+}
+
+
 // Output the extended star list (and asteroid list) in memory to a Daedalus
 // script file, which will set Daedalus' star background to their positions.
 
@@ -1762,6 +2017,87 @@ flag FOutputSettings()
 }
 
 
+// Write the eclipse and occultation catalog in memory to the cache file set
+// with -Yuc, so later runs can look up eclipses in it instead of searching.
+
+flag FOutputEclipse(CONST char *szFile)
+{
+  char sz[cchSzDef];
+  FILE *file;
+  EclipseInfo *pei;
+  int i;
+
+  if (us.fNoWrite || is.rgei == NULL)
+    return fFalse;
+  file = fopen(szFile, "w");    // Create and open the file for output.
+  if (file == NULL) {
+    sprintf(sz, "Eclipse catalog file %s can not be created.", szFile);
+    PrintError(sz);
+    return fFalse;
+  }
+  fprintf(file, "@AE%s  ; %s eclipse catalog.\n", szVerCore, szAppName);
+  // Write times with enough digits to read them back exactly, so the cache
+  // reproduces the same output as searching again.
+  fprintf(file, "%.17g %.17g %d %d\n", is.jdEclipse1, is.jdEclipse2, is.cei,
+    us.nSwissEph);
+  for (i = 0; i < is.cei; i++) {
+    pei = &is.rgei[i];
+    fprintf(file, "%.17g %.17g %.17g %.17g %d %d\n", pei->jd, pei->jdBeg,
+      pei->jdEnd, pei->mag, pei->obj, pei->et);
+  }
+  fclose(file);
+  return fTrue;
+}
+
+
+// Read an eclipse and occultation catalog written by FOutputEclipse() into
+// memory. Return false if the file doesn't exist, or was written with a
+// different ephemeris than the one currently in effect.
+
+flag FInputEclipse(CONST char *szFile)
+{
+  char szLine[cchSzLine], sz[cchSzDef];
+  FILE *file;
+  EclipseInfo *rgei, *pei;
+  real jd1, jd2;
+  int cei, nEph, i;
+
+  file = fopen(szFile, "r");
+  if (file == NULL)
+    return fFalse;
+  if (fgets(szLine, cchSzLine, file) == NULL ||
+    szLine[0] != '@' || szLine[1] != 'A' || szLine[2] != 'E' ||
+    fgets(szLine, cchSzLine, file) == NULL ||
+    sscanf(szLine, "%lf %lf %d %d", &jd1, &jd2, &cei, &nEph) < 4 ||
+    cei <= 0 || nEph != us.nSwissEph) {
+    fclose(file);
+    return fFalse;
+  }
+  rgei = RgAllocate(cei, EclipseInfo, "eclipse catalog");
+  if (rgei == NULL) {
+    fclose(file);
+    return fFalse;
+  }
+  for (i = 0; i < cei; i++) {
+    pei = &rgei[i];
+    if (fgets(szLine, cchSzLine, file) == NULL ||
+      sscanf(szLine, "%lf %lf %lf %lf %d %d", &pei->jd, &pei->jdBeg,
+      &pei->jdEnd, &pei->mag, &pei->obj, &pei->et) < 6) {
+      sprintf(sz, "Eclipse catalog file %s is truncated.", szFile);
+      PrintWarning(sz);
+      DeallocateP(rgei);
+      fclose(file);
+      return fFalse;
+    }
+  }
+  fclose(file);
+  DeallocatePIf(is.rgei);
+  is.rgei = rgei; is.cei = cei;
+  is.jdEclipse1 = jd1; is.jdEclipse2 = jd2;
+  return fTrue;
+}
+
+
 // Open all the Astrolog chart info files within the specified directory, and
 // append their chart information to the chart list.
 
@@ -2193,6 +2529,7 @@ void InputString(CONST char *szPrompt, char *sz)
   AnsiColor(kYellowA);
   PrintSz(" > ");
   AnsiColor(kDefault);
+  fflush(stdout);                            // Show prompt before waiting.
   if (fgets(sz, cchSzMax, stdin) == NULL)    // Pressing Control+d terminates
     Terminate(tcForce);                      // the program on some systems.
   cch = CchSz(sz);
@@ -2536,14 +2873,41 @@ flag FInputData(CONST char *szFile)
 #include <urlmon.h>  // For URLDownloadToFile()
 #endif
 
-// Download a Web page from a URL to the specified file.
+// Download a Web page from a URL to the specified file. A "file://" URL just
+// copies the local file it names, ignoring any query string, which allows a
+// stand-in for a Web site to be used when testing or without a network.
 
 flag GetURL(const char *szUrl, const char *szFile)
 {
-  char sz[cchSzLine];
+  char sz[cchSzLine], *pch;
+  FILE *fileIn, *fileOut;
+  long cb;
 #ifdef WINANY
   HRESULT hr;
+#endif
 
+  if (FEqRgch(szUrl, "file://", 7, fFalse)) {
+    sprintf(sz, "%s", szUrl + 7);
+    for (pch = sz; *pch && *pch != '?'; pch++)
+      ;
+    *pch = chNull;
+    fileIn = fopen(sz, "rb");
+    if (fileIn != NULL) {
+      fileOut = fopen(szFile, "wb");
+      if (fileOut != NULL) {
+        while ((cb = (long)fread(sz, 1, cchSzLine, fileIn)) > 0)
+          fwrite(sz, 1, cb, fileOut);
+        fclose(fileOut);
+      }
+      fclose(fileIn);
+      if (fileOut != NULL)
+        return fTrue;
+    }
+    sprintf(sz, "Failed to copy '%s'\n", szUrl);
+    PrintWarning(sz);
+    return fFalse;
+  }
+#ifdef WINANY
   hr = URLDownloadToFile(NULL, szUrl, szFile, 0, NULL);
   if (!FAILED(hr))
     return fTrue;
@@ -2559,47 +2923,17 @@ flag GetURL(const char *szUrl, const char *szFile)
 }
 
 
-// Given a JPL object index, compute its geocentric position and velocity
-// vectors. Similar to FSwissPlanet() but does a JPL Horizons Web query
-// instead of calling Swiss Ephemeris to compute the position.
+// Compose the URL of a JPL Horizons query for the given object index, for
+// ephemeris rows between the given start and stop times, which are in any
+// format Horizons accepts, at the given step size. The query is sent to the
+// site set with -YH, or to JPL's site by default.
 
-flag GetJPLHorizons(int id, real *obj, real *objalt, real *dir, real *dist,
-  real *diralt, real *dirlen, char *szOut)
+void JPLHorizonsURL(char *szUrl, int id, CONST char *szStart,
+  CONST char *szStop, CONST char *szStep)
 {
-  char szUrl[cchSzLine], szLine[cchSzLine], szName[cchSzMax],
-    szMon[3][4], *pch, *pch2, ch;
-  CI ci[3];
-  PT3R pt[3];
-  FILE *file;
-  real sec[3], len[3], rT;
-  int hr[3], min[3], phase = -1, i;
+  char szLine[cchSzLine], *pch, *pch2, ch;
   flag fSemicolon;
 
-  if (us.fNoNetwork) {    // Don't allow if -0n set.
-    if (!is.fNoEphFile) {
-      is.fNoEphFile = fTrue;
-      PrintWarning("Internet features are disabled.");
-    }
-    return fFalse;
-  }
-
-  // Determine time range to get ephemeris for.
-  for (i = 0; i < 3; i++) {
-    ci[i] = ciCore;
-    AddTime(&ci[i], 2, 0);     // Sanitize time if hour out of range
-    if (i <= 0)
-      AddTime(&ci[i], 2, -5);  // Subtract 5 minutes
-    else if (i >= 2)
-      AddTime(&ci[i], 2, 6);   // Add at least 5 minutes
-    sprintf(szMon[i], "%.3s", szMonth[ci[i].mon]);
-    for (pch = szMon[i]; *pch; pch++)
-      *pch = ChCap(*pch);
-    hr[i] = NFloor(ci[i].tim);
-    min[i] = (int)(RFract(RAbs(ci[i].tim))*60.0);
-    sec[i] =  RMod(RFract(RAbs(ci[i].tim))*3600.0 + rSmall, 60.0);
-  }
-
-  // Compose URL to download from internet.
   if (us.fTopoPos) {
     sprintf(szLine, "COORD_TYPE= 'GEODETIC'&"
       "SITE_COORD='%lf,%lf,%lf'&",
@@ -2607,21 +2941,21 @@ flag GetJPLHorizons(int id, real *obj, real *objalt, real *dir, real *dist,
   } else
     *szLine = chNull;
   fSemicolon = FBetween(id, nMillion, nMillion*2-1);
-  sprintf(szUrl, "https://ssd.jpl.nasa.gov/horizons_batch.cgi?batch=1&"
+  sprintf(szUrl, "%s?batch=1&"
     "COMMAND='%d%s'&"
     "OBJ_DATA='YES'&"
     "MAKE_EPHEM='YES'&"
     "TABLE_TYPE='OBSERVER'&"
     "CENTER='%s'&%s"
-    "START_TIME='%d-%s-%02d%%20%d:%02d:%lf'&"
-    "STOP_TIME='%d-%s-%02d%%20%d:%02d:%lf'&"
-    "STEP_SIZE='5%%20min'&"
+    "START_TIME='%s'&"
+    "STOP_TIME='%s'&"
+    "STEP_SIZE='%s'&"
     "QUANTITIES='21,31'&"
     "CSV_FORMAT='YES'",
+    FSzSet(us.szJPLURL) ? us.szJPLURL :
+    "https://ssd.jpl.nasa.gov/horizons_batch.cgi",
     fSemicolon ? id - nMillion : id, fSemicolon ? ";" : "",
-    !us.fTopoPos ? "500" : "coord@399", szLine,
-    ci[0].yea, szMon[0], ci[0].day, hr[0], min[0], sec[0],
-    ci[2].yea, szMon[2], ci[2].day, hr[2], min[2], sec[2]);
+    !us.fTopoPos ? "500" : "coord@399", szLine, szStart, szStop, szStep);
   for (pch = szUrl; *pch; pch++)
     ;
   for (pch--; pch >= szUrl; pch--) {
@@ -2640,13 +2974,34 @@ flag GetJPLHorizons(int id, real *obj, real *objalt, real *dir, real *dist,
       pch[1] = '3'; pch[2] = 'B';
     }
   }
+}
+
+
+// Do a JPL Horizons query with the given URL, and read up to the given number
+// of ephemeris rows from the reply, each with light time in minutes and
+// ecliptic longitude and latitude. Return the number of rows read, and the
+// JPL name of the object if a string to store it in is given.
+
+int NReadJPLHorizons(CONST char *szUrl, PT3R *rgpt, int cpt, char *szName)
+{
+  char szLine[cchSzLine], *pch, ch;
+  FILE *file;
+  int phase = -1, i;
+
+  if (us.fNoNetwork) {    // Don't allow if -0n set.
+    if (!is.fNoEphFile) {
+      is.fNoEphFile = fTrue;
+      PrintWarning("Internet features are disabled.");
+    }
+    return 0;
+  }
   GetURL(szUrl, szFileJPLCore);
 
   // Process downloaded file.
   file = FileOpen(szFileJPLCore, 1, NULL);
   if (file == NULL) {
     // Error message printed inside FileOpen().
-    return fFalse;
+    return 0;
   }
   loop {
     while (!feof(file) && (ch = getc(file)) < ' ')
@@ -2657,19 +3012,23 @@ flag GetJPLHorizons(int id, real *obj, real *objalt, real *dir, real *dist,
       (uchar)(szLine[i] = getc(file)) >= ' '; i++)
       ;
     szLine[i] = chNull;
-    if (FBetween(phase, 0, 2)) {
+    if (FBetween(phase, 0, cpt-1)) {
       // Parse ephemeris data for one instant of time.
+      if (FEqRgch(szLine, "$$EOE", 5, fTrue))
+        break;
       for (i = 0, pch = szLine; i < 3 && *pch; pch++)
         if (*pch == ',')
           i++;
-      sscanf(pch, "%lf,%lf,%lf", &pt[phase].z, &pt[phase].x, &pt[phase].y);
+      sscanf(pch, "%lf,%lf,%lf", &rgpt[phase].z, &rgpt[phase].x,
+        &rgpt[phase].y);
       phase++;
-      if (phase >= 3)
+      if (phase >= cpt)
         break;
     } else if (FEqRgch(szLine, "$$SOE", 5, fTrue)) {
       // Search for start of ephemeris data.
       phase = 0;
-    } else if (phase < 0 && FEqRgch(szLine, "Target body name: ", 18, fTrue)) {
+    } else if (phase < 0 && szName != NULL &&
+      FEqRgch(szLine, "Target body name: ", 18, fTrue)) {
       // Search for JPL name of body this ephemeris is for.
       i = 0;
       for (pch = szLine+18; *pch &&
@@ -2684,35 +3043,274 @@ flag GetJPLHorizons(int id, real *obj, real *objalt, real *dir, real *dist,
 #else
   remove(szFileJPLCore);
 #endif
-  if (phase < 3) {
+  if (phase < cpt) {
     if (!is.fNoEphFile) {
       is.fNoEphFile = fTrue;
       PrintWarning("Failed to get positions from " szFileJPLCore);
     }
-    return fFalse;
+    return Max(phase, 0);
   }
+  return phase;
+}
+
+
+// Given an object's light time and ecliptic coordinates five minutes before,
+// at, and five minutes after some time, as read from JPL Horizons, compute
+// its position and velocity vectors.
+
+void JPLHorizonsVector(CONST PT3R *pt, real *obj, real *objalt, real *dir,
+  real *dist, real *diralt, real *dirlen)
+{
+  real len[3], rT;
+  int i;
 
-  // Process planet data.
   for (i = 0; i < 3; i++) {
     // Convert speed of light in min to AU.
     len[i] = pt[i].z / (1440.0*rDayInYear) * rLYToAU;
   }
   *obj = pt[1].x;
   *objalt = pt[1].y;
-  *dir = (pt[2].x - pt[0].x) * 144.0;
+  *dir = MinDifference(pt[0].x, pt[2].x) * 144.0;
   *dist = len[1];
   *diralt = (pt[2].y - pt[0].y) * 144.0;
   *dirlen = (len[2] - len[0]) * 144.0;
   if (us.fTruePos) {
     rT = pt[1].z / 1440.0;
-    *obj += *dir * rT;
+    *obj = Mod(*obj + *dir * rT);
     *objalt += *diralt * rT;
     *dist += *dirlen * rT;
   }
+}
+
+
+// Given a JPL object index, compute its geocentric position and velocity
+// vectors. Similar to FSwissPlanet() but does a JPL Horizons Web query
+// instead of calling Swiss Ephemeris to compute the position.
+
+flag GetJPLHorizons(int id, real *obj, real *objalt, real *dir, real *dist,
+  real *diralt, real *dirlen, char *szOut)
+{
+  char szUrl[cchSzLine], szName[cchSzMax], szTime[3][cchSzDef], szMon[4],
+    *pch;
+  CI ci[3];
+  PT3R pt[3];
+  int i;
+
+  // Determine time range to get ephemeris for.
+  for (i = 0; i < 3; i += 2) {
+    ci[i] = ciCore;
+    AddTime(&ci[i], 2, 0);     // Sanitize time if hour out of range
+    if (i <= 0)
+      AddTime(&ci[i], 2, -5);  // Subtract 5 minutes
+    else
+      AddTime(&ci[i], 2, 6);   // Add at least 5 minutes
+    sprintf(szMon, "%.3s", szMonth[ci[i].mon]);
+    for (pch = szMon; *pch; pch++)
+      *pch = ChCap(*pch);
+    sprintf(szTime[i], "%d-%s-%02d%%20%d:%02d:%lf", ci[i].yea, szMon,
+      ci[i].day, NFloor(ci[i].tim), (int)(RFract(RAbs(ci[i].tim))*60.0),
+      RMod(RFract(RAbs(ci[i].tim))*3600.0 + rSmall, 60.0));
+  }
+
+  // Compose URL to download from internet, and process its reply.
+  JPLHorizonsURL(szUrl, id, szTime[0], szTime[2], "5%20min");
+  *szName = chNull;
+  if (NReadJPLHorizons(szUrl, pt, 3, szName) < 3)
+    return fFalse;
+  JPLHorizonsVector(pt, obj, objalt, dir, dist, diralt, dirlen);
   if (szOut != NULL)
     CopyRgchToSz(szName, CchSz(szName)+1, szOut, cchSzMax);
   return fTrue;
 }
+
+
+// Load JPL Horizons positions saved by earlier runs from a cache file, as
+// set with -YH0, appending them to the positions cached in memory.
+
+flag FInputJPLCache(CONST char *szFile)
+{
+  char szLine[cchSzLine], szCenter[cchSzDef];
+  FILE *file;
+  JPLBlock *pjb;
+  PT3R *ppt;
+  real jd;
+  int id, i;
+  flag fRet = fFalse;
+
+  file = fopen(szFile, "r");
+  if (file == NULL)
+    return fFalse;
+  if (fgets(szLine, cchSzLine, file) == NULL ||
+    szLine[0] != '@' || szLine[1] != 'A' || szLine[2] != 'J')
+    goto LDone;
+  while (fgets(szLine, cchSzLine, file) != NULL) {
+    if (sscanf(szLine, "%d %63s %lf", &id, szCenter, &jd) < 3)
+      goto LDone;
+    pjb = PjbNewJPLBlock();
+    if (pjb == NULL)
+      goto LDone;
+    for (i = 0; i < cJPLRow; i++) {
+      ppt = &pjb->rgpt[i];
+      if (fgets(szLine, cchSzLine, file) == NULL ||
+        sscanf(szLine, "%lf %lf %lf", &ppt->x, &ppt->y, &ppt->z) < 3) {
+        sprintf(szLine, "JPL cache file %s is truncated.", szFile);
+        PrintWarning(szLine);
+        goto LDone;
+      }
+    }
+    pjb->id = id;
+    CopyRgchToSz(szCenter, CchSz(szCenter), pjb->szCenter,
+      sizeof(pjb->szCenter));
+    pjb->jd = jd;
+    is.cjb++;
+  }
+  fRet = fTrue;
+
+LDone:
+  fclose(file);
+  return fRet;
+}
+
+
+// Append a block of JPL Horizons positions to the cache file set with -YH0,
+// so later runs can use them without querying Horizons again.
+
+flag FOutputJPLBlock(CONST JPLBlock *pjb)
+{
+  FILE *file;
+  int i;
+
+  if (us.fNoWrite)
+    return fFalse;
+  file = fopen(us.szJPLFile, "a");
+  if (file == NULL)
+    return fFalse;
+  fseek(file, 0, SEEK_END);
+  if (ftell(file) <= 0)
+    fprintf(file, "@AJ780  ; Astrolog JPL Horizons cache.\n");
+  fprintf(file, "%d %s %.6f\n", pjb->id, pjb->szCenter, pjb->jd);
+  for (i = 0; i < cJPLRow; i++)
+    fprintf(file, "%.9f %.9f %.9f\n",
+      pjb->rgpt[i].x, pjb->rgpt[i].y, pjb->rgpt[i].z);
+  fclose(file);
+  return fTrue;
+}
+
+
+// Return a pointer to a free slot at the end of the JPL Horizons position
+// cache, growing it if needed. The slot isn't counted until it's filled in.
+
+JPLBlock *PjbNewJPLBlock(void)
+{
+  JPLBlock *rgjb;
+  int cjbMax;
+
+  if (is.cjb >= is.cjbMax) {
+    cjbMax = Max(is.cjbMax * 2, 16);
+    rgjb = (JPLBlock *)RgReallocate(is.rgjb, is.cjbMax, sizeof(JPLBlock),
+      cjbMax, "JPL cache");
+    if (rgjb == NULL)
+      return NULL;
+    DeallocatePIf(is.rgjb);
+    is.rgjb = rgjb;
+    is.cjbMax = cjbMax;
+  }
+  return &is.rgjb[is.cjb];
+}
+
+
+// Interpolate an object's light time and ecliptic coordinates at a time
+// within a cached block of JPL Horizons positions, from the four epochs
+// around it.
+
+void JPLInterpolate(CONST JPLBlock *pjb, real jd, PT3R *ppt)
+{
+  CONST PT3R *rgpt;
+  real rgw[4], u;
+  int i0, i;
+
+  u = (jd - pjb->jd) / rJPLStep;
+  i0 = NFloor(u) - 1;
+  i0 = Max(i0, 0); i0 = Min(i0, cJPLRow - 4);
+  u -= (real)i0;
+  rgw[0] = -(u - 1.0)*(u - 2.0)*(u - 3.0) / 6.0;
+  rgw[1] = u*(u - 2.0)*(u - 3.0) / 2.0;
+  rgw[2] = -u*(u - 1.0)*(u - 3.0) / 2.0;
+  rgw[3] = u*(u - 1.0)*(u - 2.0) / 6.0;
+  rgpt = &pjb->rgpt[i0];
+  ppt->x = ppt->y = ppt->z = 0.0;
+  for (i = 0; i < 4; i++) {
+    ppt->x += rgw[i] * MinDifference(rgpt[0].x, rgpt[i].x);
+    ppt->y += rgw[i] * rgpt[i].y;
+    ppt->z += rgw[i] * rgpt[i].z;
+  }
+  ppt->x = Mod(rgpt[0].x + ppt->x);
+}
+
+
+// Like GetJPLHorizons() but for the given Julian day (UT), and using cached
+// positions where possible. A cache miss fetches a whole day of positions
+// for the object in one query, which later times that day are interpolated
+// from, e.g. as a transit search steps through the day.
+
+flag FJPLHorizonsCache(int id, real jd, real *obj, real *objalt, real *dir,
+  real *dist, real *diralt, real *dirlen)
+{
+  char szUrl[cchSzLine], szCenter[cchSzDef], szStart[cchSzDef],
+    szStop[cchSzDef];
+  JPLBlock *pjb;
+  PT3R pt[3];
+  real jd0;
+  int i;
+
+  // Load the cache file the first time the cache is used.
+  if (is.rgjb == NULL) {
+    if (PjbNewJPLBlock() == NULL)
+      return fFalse;
+    if (FSzSet(us.szJPLFile))
+      FInputJPLCache(us.szJPLFile);
+  }
+
+  // Look for a cached block covering the day containing this time.
+  if (us.fTopoPos)
+    sprintf(szCenter, "coord@399:%.6f,%.6f,%.3f",
+      -ciCore.lon, ciCore.lat, us.elvDef);
+  else
+    sprintf(szCenter, "500");
+  jd0 = RFloor(jd - 0.5) + 0.5 - 1.0/24.0;
+  for (i = 0; i < is.cjb; i++) {
+    pjb = &is.rgjb[i];
+    if (pjb->id == id && RAbs(pjb->jd - jd0) < rJPLStep / 2.0 &&
+      FEqSz(pjb->szCenter, szCenter))
+      break;
+  }
+
+  // If not found, fetch a block of positions from one hour before the start
+  // of the day through one hour after its end.
+  if (i >= is.cjb) {
+    pjb = PjbNewJPLBlock();
+    if (pjb == NULL)
+      return fFalse;
+    sprintf(szStart, "JD%.6f", jd0);
+    sprintf(szStop, "JD%.6f", jd0 + rJPLStep * (real)(cJPLRow-1));
+    JPLHorizonsURL(szUrl, id, szStart, szStop, "10%20min");
+    if (NReadJPLHorizons(szUrl, pjb->rgpt, cJPLRow, NULL) < cJPLRow)
+      return fFalse;
+    pjb->id = id;
+    CopyRgchToSz(szCenter, CchSz(szCenter), pjb->szCenter,
+      sizeof(pjb->szCenter));
+    pjb->jd = jd0;
+    is.cjb++;
+    if (FSzSet(us.szJPLFile))
+      FOutputJPLBlock(pjb);
+  }
+
+  for (i = 0; i < 3; i++)
+    JPLInterpolate(pjb, jd + (real)(i - 1) * 5.0/1440.0, &pt[i]);
+  JPLHorizonsVector(pt, obj, objalt, dir, dist, diralt, dirlen);
+  return fTrue;
+}
 #endif // JPLWEB
 
+
 /* io.cpp */
@@ -1159,123 +1159,230 @@ flag FReadWorldData(CONST char **nam, CONST char **loc, CONST char **lin)
 }
 
 
-// Enumerator to return line segments (and their color) composing Astrolog's
-// map of the world. Used by astro-graph, map/globe, and nearest city charts.
+// Allocate the arrays of a line store, given the number of polylines and
+// total vertices it will contain, in one block of memory.
 
-flag EnumWorldLines(int *x1, int *y1, int *x2, int *y2, int *kRainbow)
+flag FAllocLineStore(LS *pls, int cpl, int cpt)
 {
-  static CONST char **psz;
-  static CONST char *lin;
-  static int xold, yold;
-  CONST char *nam, *loc;
-  char chCmd;
-  int lon, lat, x, y, i, k = -1;
+  long cb;
+  pbyte pb;
 
-  // Call with Null pointer to initialize new enumeration.
-  if (x1 == NULL) {
-    psz = szWorldData;
-    lin = "";
-    return fTrue;
+  cb = (long)cpl*(sizeof(CONST char *) + sizeof(int) + sizeof(short)*4 + 1) +
+    sizeof(int) + (long)cpt*sizeof(short)*2;
+  pb = PAllocate(cb, "map lines");
+  if (pb == NULL)
+    return fFalse;
+  ClearB(pb, cb);
+  pls->pb = pb;
+  pls->rgszNam = (CONST char **)pb; pb += cpl*sizeof(CONST char *);
+  pls->rgipt = (int *)pb;           pb += (cpl+1)*sizeof(int);
+  pls->rgx = (short *)pb;           pb += cpt*sizeof(short);
+  pls->rgy = (short *)pb;           pb += cpt*sizeof(short);
+  pls->rgxLo = (short *)pb;         pb += cpl*sizeof(short);
+  pls->rgxHi = (short *)pb;         pb += cpl*sizeof(short);
+  pls->rgyLo = (short *)pb;         pb += cpl*sizeof(short);
+  pls->rgyHi = (short *)pb;         pb += cpl*sizeof(short);
+  pls->rgk = (char *)pb;
+  pls->cpl = pls->cpt = 0;
+  return fTrue;
+}
+
+
+// Finish a line store whose vertices have all been added, by terminating
+// the polyline index and computing the bounding box of each polyline.
+
+void FinishLineStore(LS *pls)
+{
+  int ipl, ipt;
+
+  pls->rgipt[pls->cpl] = pls->cpt;
+  for (ipl = 0; ipl < pls->cpl; ipl++) {
+    ipt = pls->rgipt[ipl];
+    pls->rgxLo[ipl] = pls->rgxHi[ipl] = pls->rgx[ipt];
+    pls->rgyLo[ipl] = pls->rgyHi[ipl] = pls->rgy[ipt];
+    for (ipt++; ipt < pls->rgipt[ipl+1]; ipt++) {
+      if (pls->rgx[ipt] < pls->rgxLo[ipl])
+        pls->rgxLo[ipl] = pls->rgx[ipt];
+      else if (pls->rgx[ipt] > pls->rgxHi[ipl])
+        pls->rgxHi[ipl] = pls->rgx[ipt];
+      if (pls->rgy[ipt] < pls->rgyLo[ipl])
+        pls->rgyLo[ipl] = pls->rgy[ipt];
+      else if (pls->rgy[ipt] > pls->rgyHi[ipl])
+        pls->rgyHi[ipl] = pls->rgy[ipt];
+    }
   }
+}
 
-  // Get the next chunk of data to process.
-  if (!*lin) {
 
-    // Get data for the next coastline piece.
-    loc = *psz++;
-    lin = *psz++;
-    nam = *psz++;
-    if (loc[0]) {
-      i = nam[0]-'0';
-      if (gs.fPrintMap && gi.fFile) {
-        AnsiColor(i ? kRainbowA[i] : kDkBlueA);
-        PrintSz(nam+1); PrintL();
-      }
-    } else
-      return fFalse;
-    k = i;
+// Print the name of a coastline piece of the world map, if -XP set.
+
+void PrintLineStoreName(CONST LS *pls, int ipl)
+{
+  int i;
+
+  if (gs.fPrintMap && gi.fFile && pls->rgszNam[ipl] != NULL) {
+    i = pls->rgk[ipl];
+    AnsiColor(i ? kRainbowA[i] : kDkBlueA);
+    PrintSz(pls->rgszNam[ipl]+1); PrintL();
+  }
+}
+
+
+// Return Astrolog's map of the world, as a store of polylines (with their
+// colors) composing each piece of coastline. The text encoded map data is
+// decoded into the store the first time this is called.
+
+CONST LS *PlsWorldLines()
+{
+  LS *pls = &gi.lsWorld;
+  CONST char **psz, *loc, *lin;
+  char chCmd;
+  int cpl = 0, cpt = 0, x, y, lon, lat;
+
+  if (pls->pb != NULL)
+    return pls;
+
+  // Count the coastline pieces and vertices, and allocate room for them.
+  for (psz = szWorldData; psz[0][0]; psz += 3) {
+    cpl++;
+    cpt += CchSz(psz[1]) + 1;
+  }
+  if (!FAllocLineStore(pls, cpl, cpt))
+    return NULL;
+  pls->kRest = -1;
+
+  for (psz = szWorldData; psz[0][0]; psz += 3) {
+    loc = psz[0];
+    lin = psz[1];
+    pls->rgszNam[pls->cpl] = psz[2];
+    pls->rgk[pls->cpl] = psz[2][0]-'0';
+    pls->rgipt[pls->cpl++] = pls->cpt;
     lon = (loc[0] == '+' ? 1 : -1)*
       ((loc[1]-'0')*100 + (loc[2]-'0')*10 + (loc[3]-'0'));
     lat = (loc[4] == '+' ? 1 : -1)*((loc[5]-'0')*10 + (loc[6]-'0'));
-    xold = nDegHalf - lon;
-    yold = 90 - lat;
-  }
-  x = xold; y = yold;
-
-  // Get the next unit from the world map string.
-  chCmd = *lin++;
-
-  // Each unit is exactly one character in the coastline string.
-  if (chCmd == 'L' || chCmd == 'H' || chCmd == 'G')
-    x--;
-  else if (chCmd == 'R' || chCmd == 'E' || chCmd == 'F')
-    x++;
-  if (chCmd == 'U' || chCmd == 'H' || chCmd == 'E')
-    y--;
-  else if (chCmd == 'D' || chCmd == 'G' || chCmd == 'F')
-    y++;
-
-  // Take care of coordinate wrap around.
-  while (x >= nDegMax)
-    x -= nDegMax;
-  while (x < 0)
-    x += nDegMax;
-
-  *x1 = xold; *y1 = yold; *x2 = x; *y2 = y;
-  *kRainbow = k;
-  xold = x; yold = y;
-  return fTrue;
+    x = nDegHalf - lon;
+    y = 90 - lat;
+    pls->rgx[pls->cpt] = x; pls->rgy[pls->cpt++] = y;
+
+    // Each unit is exactly one character in the coastline string.
+    while ((chCmd = *lin++)) {
+      if (chCmd == 'L' || chCmd == 'H' || chCmd == 'G')
+        x--;
+      else if (chCmd == 'R' || chCmd == 'E' || chCmd == 'F')
+        x++;
+      if (chCmd == 'U' || chCmd == 'H' || chCmd == 'E')
+        y--;
+      else if (chCmd == 'D' || chCmd == 'G' || chCmd == 'F')
+        y++;
+
+      // Take care of coordinate wrap around.
+      while (x >= nDegMax)
+        x -= nDegMax;
+      while (x < 0)
+        x += nDegMax;
+      pls->rgx[pls->cpt] = x; pls->rgy[pls->cpt++] = y;
+    }
+  }
+  FinishLineStore(pls);
+  return pls;
 }
 
 
-#ifdef CONSTEL
-// Enumerator to return line segments (and their constellation) composing
-// Astrolog's map of constellation boundaries. Used by local horizon,
-// map/globe, chart sphere, and telescope charts.
+// Enumerate the line segments composing the polylines in a line store. Each
+// call returns the next segment's endpoints, along with the polyline's index
+// for its first segment, and the store's kRest value for later segments.
 
-flag EnumConstelLines(int *x1, int *y1, int *x2, int *y2, int *iConst)
+flag FEnumLineStore(LE *ple, int *x1, int *y1, int *x2, int *y2, int *k)
 {
-  static int isz, nC, xold = 0, yold = 0, xDelta, yDelta, xLo, xHi, yLo, yHi;
-  static CONST char *pch;
-  int lon, lat, x, y;
-  char chCmd;
-  flag fBlank;
+  CONST LS *pls = ple->pls;
+  int ipt;
+
+  if (pls == NULL || ple->ipl >= pls->cpl)
+    return fFalse;
+  ipt = ple->ipt;
+  if (ipt <= pls->rgipt[ple->ipl]) {
+    // Starting a new polyline.
+    ipt = pls->rgipt[ple->ipl];
+    *k = pls->rgk[ple->ipl];
+    if (pls->rgszNam[ple->ipl] != NULL)
+      PrintLineStoreName(pls, ple->ipl);
+    if (ipt + 1 >= pls->rgipt[ple->ipl+1]) {
+      // A polyline with a single vertex is returned as a single point.
+      *x1 = *x2 = pls->rgx[ipt]; *y1 = *y2 = pls->rgy[ipt];
+      ple->ipl++;
+      return fTrue;
+    }
+    ipt++;
+  } else
+    *k = pls->kRest;
+  *x1 = pls->rgx[ipt-1]; *y1 = pls->rgy[ipt-1];
+  *x2 = pls->rgx[ipt];   *y2 = pls->rgy[ipt];
+  ipt++;
+  if (ipt >= pls->rgipt[ple->ipl+1])
+    ple->ipl++;
+  ple->ipt = ipt;
+  return fTrue;
+}
 
-  // Call with Null pointer to initialize new enumeration.
+
+// Enumerator to return line segments (and their color) composing Astrolog's
+// map of the world. Used by astro-graph, map/globe, and nearest city charts.
+// Call with Null coordinates to initialize the enumeration state.
+
+flag EnumWorldLines(LE *ple, int *x1, int *y1, int *x2, int *y2,
+  int *kRainbow)
+{
   if (x1 == NULL) {
-    isz = nC = 0;
-    pch = "";
-    return fTrue;
+    ple->pls = PlsWorldLines();
+    ple->ipl = ple->ipt = 0;
+    return ple->pls != NULL;
   }
+  return FEnumLineStore(ple, x1, y1, x2, y2, kRainbow);
+}
 
-  // Get the next chunk of data to process.
-LNext:
-  x = xold; y = yold;
-  if (!*pch && nC <= 0) {
 
-    if (isz > 0) {
-      // If reached the end of current constellation, compute the center
-      // location in it based on lower and upper bounds that have been
-      // maintained, and print the name of the constellation there.
+#ifdef CONSTEL
+// Add a line segment to the constellation line store being built, extending
+// the current polyline if the segment starts where it left off. A positive
+// constellation index adds a single point where that label is drawn. If the
+// store's arrays haven't been allocated yet, just count what would be added.
 
-      x = xLo + (xHi - xLo)*(szDrawConstel[isz][0]-'1')/8;
-      y = yLo + (yHi - yLo)*(szDrawConstel[isz][1]-'1')/8;
-      if (x < 0)
-        x += nDegMax;
-      else if (x > nDegMax)
-        x -= nDegMax;
-      *x1 = *x2 = x;
-      *y1 = *y2 = y;
-      *iConst = isz;
-      neg(isz);
-      return fTrue;
-    } else if (isz < 0)
-      neg(isz);
+void AddConstelLine(LS *pls, int x1, int y1, int x2, int y2, int iConst)
+{
+  flag fFill = pls->pb != NULL;
+
+  if (iConst > 0 || pls->cpl <= 0 || pls->kLast > 0 ||
+    x1 != pls->xLast || y1 != pls->yLast) {
+    if (fFill) {
+      pls->rgipt[pls->cpl] = pls->cpt;
+      pls->rgk[pls->cpl] = iConst;
+      pls->rgx[pls->cpt] = x1; pls->rgy[pls->cpt] = y1;
+    }
+    pls->cpl++; pls->cpt++;
+  }
+  if (iConst <= 0) {
+    if (fFill) {
+      pls->rgx[pls->cpt] = x2; pls->rgy[pls->cpt] = y2;
+    }
+    pls->cpt++;
+  }
+  pls->xLast = x2; pls->yLast = y2; pls->kLast = iConst;
+}
 
-    // Get data for the next constellation shape.
-    isz++;
-    if (isz > cCnstl)
-      return fFalse;
+
+// Decode Astrolog's map of constellation boundaries into a line store, or
+// just count the polylines and vertices it needs if not allocated yet.
+
+void DecodeConstelLines(LS *pls)
+{
+  int isz, nC, xold, yold, xDelta = 0, yDelta = 0, xLo, xHi, yLo, yHi,
+    lon, lat, x, y, x1, y1;
+  CONST char *pch;
+  char chCmd;
+  flag fBlank;
+
+  pls->cpl = pls->cpt = 0;
+  for (isz = 1; isz <= cCnstl; isz++) {
     pch = szDrawConstel[isz];
     lon = nDegMax -
       (((pch[2]-'0')*10 + (pch[3]-'0'))*15 + (pch[4]-'0')*10 + (pch[5]-'0'));
@@ -1283,69 +1390,122 @@ LNext:
     if (lon >= nDegMax)
       lon -= nDegMax;
     pch += 9;
-    xLo = xHi = xold = x = lon;
-    yLo = yHi = yold = y = lat;
-  }
-
-  // Get the next unit from the string to draw on the screen as a line. For
-  // constellations have a cache of how long should keep going in the previous
-  // direction, for example "u5" for up five moves pointer up five times
-  // without advancing string pointer.
-
-  fBlank = fFalse;
-  loop {
-    if (nC <= 0) {
-      chCmd = *pch++;
-
-      // Get the next direction and distance from constellation string.
-      fBlank = (chCmd == 'b');
-      if (fBlank)
-        chCmd = *pch++;
-      xDelta = yDelta = 0;
-      switch (chCmd) {
-      case 'u': yDelta = -1; break;    // Up
-      case 'd': yDelta =  1; break;    // Down
-      case 'l': xDelta = -1; break;    // Left
-      case 'r': xDelta =  1; break;    // Right
-      case 'U': yDelta = -1; nC = (y-1)%10+1;    break;  // Up until
-      case 'D': yDelta =  1; nC = 10-y%10;       break;  // Down until
-      case 'L': xDelta = -1; nC = (x+599)%15+1;  break;  // Left until
-      case 'R': xDelta =  1; nC = 15-(x+600)%15; break;  // Right until
-      default: PrintError("Bad constel enum.");          // Shouldn't happen.
+    xLo = xHi = xold = lon;
+    yLo = yHi = yold = lat;
+    nC = 0;
+
+    while (*pch || nC > 0) {
+      x = xold; y = yold;
+
+      // Get the next unit from the string to draw as a line. For
+      // constellations have a cache of how long should keep going in the
+      // previous direction, for example "u5" for up five moves pointer up
+      // five times without advancing string pointer.
+
+      fBlank = fFalse;
+      loop {
+        if (nC <= 0) {
+          chCmd = *pch++;
+
+          // Get the next direction and distance from constellation string.
+          fBlank = (chCmd == 'b');
+          if (fBlank)
+            chCmd = *pch++;
+          xDelta = yDelta = 0;
+          switch (chCmd) {
+          case 'u': yDelta = -1; break;    // Up
+          case 'd': yDelta =  1; break;    // Down
+          case 'l': xDelta = -1; break;    // Left
+          case 'r': xDelta =  1; break;    // Right
+          case 'U': yDelta = -1; nC = (y-1)%10+1;    break;  // Up until
+          case 'D': yDelta =  1; nC = 10-y%10;       break;  // Down until
+          case 'L': xDelta = -1; nC = (x+599)%15+1;  break;  // Left until
+          case 'R': xDelta =  1; nC = 15-(x+600)%15; break;  // Right until
+          default: PrintError("Bad constel enum.");  // Shouldn't happen.
+          }
+          if (chCmd >= 'a')
+            nC = NFromPch(&pch);  // Figure out how far to draw.
+        }
+        nC--;
+        x += xDelta; y += yDelta;
+        if (!fBlank)
+          break;
+        // Occasionally want to move the pointer without drawing anything.
+        xold = x; yold = y;
       }
-      if (chCmd >= 'a')
-        nC = NFromPch(&pch);  // Figure out how far to draw.
+
+      if (x < xLo)              // Maintain bounding rectangle for this
+        xLo = x;                // constellation if have crossed over it.
+      else if (x > xHi)
+        xHi = x;
+      if (y < yLo)
+        yLo = y;
+      else if (y > yHi)
+        yHi = y;
+
+      x1 = xold; y1 = yold;
+      xold = x; yold = y;
+      // Draw each line segment once instead of twice.
+      if (!(x > x1 || y > y1))
+        continue;
+      // Take care of coordinate wrap around.
+      while (x >= nDegMax)
+        x -= nDegMax;
+      while (x < 0)
+        x += nDegMax;
+      AddConstelLine(pls, x1, y1, x, y, 0);
     }
-    nC--;
-    x += xDelta; y += yDelta;
-    if (!fBlank)
-      break;
-    // Occasionally want to move the pointer without drawing anything.
-    xold = x; yold = y;     
-    continue;
-  }
-
-  if (x < xLo)              // Maintain bounding rectangle for this
-    xLo = x;                // constellation if have crossed over it.
-  else if (x > xHi)
-    xHi = x;
-  if (y < yLo)
-    yLo = y;
-  else if (y > yHi)
-    yHi = y;
-
-  // Take care of coordinate wrap around.
-  *x1 = xold; *y1 = yold; 
-  xold = x; yold = y;
-  if (!(x > *x1 || y > *y1))  // draw each line segment once instead of twice.
-    goto LNext;
-  while (x >= nDegMax)
-    x -= nDegMax;
-  while (x < 0)
-    x += nDegMax;
-  *x2 = x; *y2 = y;
-  *iConst = 0;
-  return fTrue;
+
+    // When reached the end of current constellation, compute the center
+    // location in it based on lower and upper bounds that have been
+    // maintained, which is where the name of the constellation is printed.
+
+    x = xLo + (xHi - xLo)*(szDrawConstel[isz][0]-'1')/8;
+    y = yLo + (yHi - yLo)*(szDrawConstel[isz][1]-'1')/8;
+    if (x < 0)
+      x += nDegMax;
+    else if (x > nDegMax)
+      x -= nDegMax;
+    AddConstelLine(pls, x, y, x, y, isz);
+  }
+}
+
+
+// Return Astrolog's map of constellation boundaries, as a store of polylines
+// composing the boundaries, along with single point polylines indicating
+// where each constellation's label goes. The text encoded boundaries are
+// decoded into the store the first time this is called.
+
+CONST LS *PlsConstelLines()
+{
+  LS *pls = &gi.lsConstel;
+
+  if (pls->pb != NULL)
+    return pls;
+  DecodeConstelLines(pls);
+  if (!FAllocLineStore(pls, pls->cpl, pls->cpt))
+    return NULL;
+  DecodeConstelLines(pls);
+  pls->kRest = 0;
+  FinishLineStore(pls);
+  return pls;
+}
+
+
+// Enumerator to return line segments (and their constellation) composing
+// Astrolog's map of constellation boundaries. Used by local horizon,
+// map/globe, chart sphere, and telescope charts. Call with Null coordinates
+// to initialize the enumeration state.
+
+flag EnumConstelLines(LE *ple, int *x1, int *y1, int *x2, int *y2,
+  int *iConst)
+{
+  if (x1 == NULL) {
+    ple->pls = PlsConstelLines();
+    ple->ipl = ple->ipt = 0;
+    return ple->pls != NULL;
+  }
+  return FEnumLineStore(ple, x1, y1, x2, y2, iConst);
 }
 
 
@@ -1359,6 +1519,7 @@ int LookupConstel(real lon, real lat)
   int xmax = nDegMax*2, ymax = nDegHalf*2, x1, y1, x2, y2, iConst;
   PT2S rgpt[iFillMax], rgptConstel[cCnstl+1];
   int iTop, iCur, x, y, xnew, ynew, d;
+  LE le;
 
   // Allocate an array to map equatorial coordinates to constellation.
   if (gi.rgConstel == NULL) {
@@ -1368,8 +1529,8 @@ int LookupConstel(real lon, real lat)
     ClearB((pbyte)gi.rgConstel, xmax*ymax);
 
     // Draw constellation boundaries in the array.
-    EnumConstelLines(NULL, NULL, NULL, NULL, NULL);
-    while (EnumConstelLines(&x1, &y1, &x2, &y2, &iConst)) {
+    EnumConstelLines(&le, NULL, NULL, NULL, NULL, NULL);
+    while (EnumConstelLines(&le, &x1, &y1, &x2, &y2, &iConst)) {
       if (x1 < 0)
         x1 += nDegMax;
       else if (x1 >= nDegMax)
@@ -1759,10 +1920,13 @@ void DrawMapTriangles(flag fGlobe, int nScl, CIRC *pcr, real deg)
 void DrawMap(flag fSky, flag fGlobe, real deg)
 {
   int cx = gs.xWin/2, cy = gs.yWin/2, rx, ry, unit = 12*gi.nScale,
-    nScl = gi.nScale, x, y, xold, yold, m, n, u, v, i, j, k, l;
-  flag fNext = fTrue, fSimple, fDir = (gi.nMode == gSphere && gs.fSouth),
-    fDidBitmap;
-  real planet1[objMax], planet2[objMax], x1, y1, rT;
+    nScl = gi.nScale, x, y, xold = 0, yold, m = 0, n = 0, u, v, i, j, k,
+    l = 0, ipl, ipt, iptLo, iptHi;
+  flag fNext = fTrue, fSimple = fFalse,
+    fDir = (gi.nMode == gSphere && gs.fSouth), fDidBitmap, fBack, fVis,
+    fVisOld;
+  real planet1[objMax], planet2[objMax], x1, y1, rT, rLo, rHi;
+  CONST LS *pls;
   ObjDraw rgod[objMax * arMax];
   CIRC cr;
   ES es;
@@ -1804,15 +1968,16 @@ void DrawMap(flag fSky, flag fGlobe, real deg)
     goto LAfter;
 #ifdef CONSTEL
   if (fSky)
-    EnumConstelLines(NULL, NULL, NULL, NULL, NULL);
+    pls = PlsConstelLines();
   else
 #endif
-    EnumWorldLines(NULL, NULL, NULL, NULL, NULL);
-  while (
-#ifdef CONSTEL
-    fSky ? EnumConstelLines(&xold, &yold, &x, &y, &i) :
-#endif
-    EnumWorldLines(&xold, &yold, &x, &y, &i)) {
+    pls = PlsWorldLines();
+  if (pls == NULL)
+    goto LAfter;
+  for (ipl = 0; ipl < pls->cpl; ipl++) {
+    i = pls->rgk[ipl];
+    iptLo = pls->rgipt[ipl]; iptHi = pls->rgipt[ipl+1];
+    PrintLineStoreName(pls, ipl);
     if (fSky) {
       if (i > 0)
         DrawColor(gi.nMode == gSphere || (!gs.fAlt && gi.nMode != gPolar &&
@@ -1820,68 +1985,78 @@ void DrawMap(flag fSky, flag fGlobe, real deg)
       else
         DrawColor(gi.nMode == gSphere ? kPurpleB :
           (gs.fAlt ? kBlueB : kDkBlueB));
-    } else {
-      if (i >= 0)
-        DrawColor((!fGlobe && gi.nMode == gAstroGraph) ? gi.kiOn :
-          (!gs.fAlt && !gs.fColorHouse ? gi.kiGray :
-          (i ? kRainbowB[i] : kDkBlueB)));
-    }
+    } else
+      DrawColor((!fGlobe && gi.nMode == gAstroGraph) ? gi.kiOn :
+        (!gs.fAlt && !gs.fColorHouse ? gi.kiGray :
+        (i ? kRainbowB[i] : kDkBlueB)));
     if (fGlobe) {
       // For globes, have to do a complicated transformation, and not draw
       // when hidden on the back side of the sphere. Be smart and only do slow
-      // calculations when know will be visible.
-
-      j = fTrue;
-      if (fSimple && !gs.fSouth) {
-        rT = (real)xold+deg;
-        if (rT >= rDegMax)
-          rT -= rDegMax;
-        j &= rT <= rDegHalf;
-        rT = (real)x+deg;
-        if (rT >= rDegMax)
-          rT -= rDegMax;
-        j &= rT <= rDegHalf;
+      // calculations when know will be visible. Skip polylines entirely
+      // when their bounding box is known to be on the back side.
+
+      fBack = fSimple && !gs.fSouth;
+      if (fBack) {
+        rLo = (real)pls->rgxLo[ipl] + deg;
+        rHi = (real)pls->rgxHi[ipl] + deg;
+        if ((rLo > rDegHalf && rHi < rDegMax) ||
+          (rLo > rDegMax + rDegHalf && rHi < rDegMax*2.0))
+          continue;
       }
-      if (j) {
-        k = FGlobeCalc((real)xold, (real)yold, &m, &n, &cr, deg) ^ fDir;
+      // Project each vertex once, reusing it for both segments it ends.
+      fVisOld = fFalse;
+      for (ipt = iptLo; ipt < iptHi; ipt++) {
+        x = pls->rgx[ipt]; y = pls->rgy[ipt];
+        fVis = fTrue;
+        if (fBack) {
+          rT = (real)x+deg;
+          if (rT >= rDegMax)
+            rT -= rDegMax;
+          fVis = rT <= rDegHalf;
+        }
+        if (fVis)
+          l = FGlobeCalc((real)x, (real)y, &u, &v, &cr, deg) ^ fDir;
 #ifdef CONSTEL
         if (fSky && i > 0) {
-          if (!k && gs.fText)
-            DrawSz(szCnstlAbbrev[i], m, n, dtCent | dtScale2);
-          continue;
+          if (fVis && !l && gs.fText)
+            DrawSz(szCnstlAbbrev[i], u, v, dtCent | dtScale2);
+          break;
         }
 #endif
-        l = FGlobeCalc((real)x, (real)y, &u, &v, &cr, deg) ^ fDir;
-        if (!k && !l)
-          DrawLine(m, n, u, v);
-        else if (gs.fSouth && gi.nMode != gSphere) {
-          if (k) DrawPoint(m, n);
-          if (l) DrawPoint(u, v);
+        if (ipt > iptLo && fVisOld && fVis) {
+          if (!k && !l)
+            DrawLine(m, n, u, v);
+          else if (gs.fSouth && gi.nMode != gSphere) {
+            if (k) DrawPoint(m, n);
+            if (l) DrawPoint(u, v);
+          }
         }
+        fVisOld = fVis; m = u; n = v; k = l;
       }
     } else {
       // Rectangular maps are much simpler, with screen coordinates
       // proportional to internal coordinates. For the Mollewide projection
       // have to apply a factor to the horizontal positioning though.
 
-      m = (int)(Mod((real)xold + deg)*(real)nScl);
-      u = (int)(Mod((real)x + deg)*(real)nScl);
-      if (NAbs(u-m) <= nDegHalf) {
-        n = yold*nScl;
+      for (ipt = iptLo; ipt < iptHi; ipt++) {
+        x = pls->rgx[ipt]; y = pls->rgy[ipt];
+        u = (int)(Mod((real)x + deg)*(real)nScl);
         v = y*nScl;
+        l = u;
         if (gs.fMollewide && gi.nMode != gAstroGraph) {
           j = nDegHalf*nScl;
-          m = j + NMultDiv(m-j, NMollewide(yold-90), j);
-          u = j + NMultDiv(u-j, NMollewide(y   -90), j);
+          l = j + NMultDiv(u-j, NMollewide(y-90), j);
         }
 #ifdef CONSTEL
         if (fSky && i > 0) {
           if (gs.fText)
-            DrawSz(szCnstlAbbrev[i], m, n, dtCent | dtScale2);
-          continue;
+            DrawSz(szCnstlAbbrev[i], l, v, dtCent | dtScale2);
+          break;
         }
 #endif
-        DrawLine(m, n, u, v);
+        if (ipt > iptLo && NAbs(u-xold) <= nDegHalf)
+          DrawLine(k, n, l, v);
+        xold = u; k = l; n = v;
       }
     }
   }
@@ -2284,8 +2459,13 @@ void DrawChartX()
 
   gi.nScale = gs.nScale/100;
 
-  if (gs.ft == ftBmp || gs.ft == ftWmf || gs.ft == ftWire)
+  if ((gs.ft == ftBmp || gs.ft == ftWmf || gs.ft == ftWire) &&
+    gs.nAnimFrame <= 0)
     PrintProgress("Creating graphics chart in memory.");
+#ifdef X11
+  gi.cxReq = gi.cxPrim = 0;
+#endif
+  gi.cTurtleHit = gi.cTurtleMiss = 0;
   DrawClearScreen();
   FBmpDrawBack(NULL);
   fAltWire = gs.ft == ftWire &&
@@ -2346,7 +2526,14 @@ void DrawChartX()
     XChartEsoteric();
     break;
   case gAstroGraph:
-    DrawMap(fFalse, fFalse, gs.rRot);    // First draw map of world.
+    // First draw map of world, with any -XH relocation colors either under
+    // the map outlines or blended onto the map bitmap.
+    fSav = gi.fBmp && gi.fFile && gs.ft == ftBmp;
+    if (gs.fReloc && !fSav)
+      FDrawRelocMap(fFalse);
+    DrawMap(fFalse, fFalse, gs.rRot);
+    if (gs.fReloc && fSav)
+      FDrawRelocMap(fTrue);
     XChartAstroGraph();                  // Then draw astro-graph lines on it.
     break;
   case gCalendar:
@@ -2451,11 +2638,33 @@ void DrawChartX()
   if (gs.fAntialias)
     FBmpAntialias();
 
+#ifdef X11
+  // Send any queued X11 drawing, and report how many requests it all took.
+  if (!gi.fFile) {
+    FlushDrawX();
+    if (gs.fDrawStats) {
+      sprintf(sz, "Chart drawn with %ld X11 requests for %ld primitives.",
+        gi.cxReq, gi.cxPrim);
+      PrintProgress(sz);
+    }
+  }
+#endif
+  if (gs.fDrawStats) {
+    sprintf(sz, "Glyph cache: %ld hits, %ld misses, %ld bytes used.",
+      gi.cTurtleHit, gi.cTurtleMiss, gi.cbTurtle);
+    PrintProgress(sz);
+  }
+
 #ifdef EXPRESS
   // Notify AstroExpression a chart has just been drawn.
   if (!us.fExpOff && FSzSet(us.szExpDisp2))
     ParseExpression(us.szExpDisp2);
 #endif
+#ifdef X11
+  // Send anything the above hook drew, so it's part of this frame too.
+  if (!gi.fFile)
+    FlushDrawX();
+#endif
 }
 #endif // GRAPH
 
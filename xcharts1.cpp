@@ -136,6 +136,134 @@ void XChartWheel()
 }
 
 
+// Return the ascensional difference of an object at each latitude step from
+// lat1 to lat2 along its astro-graph Ascendant and Descendant lines, or
+// rLarge at latitudes where it doesn't rise or set. These only depend on the
+// object's declination, so they're traced once and kept, instead of being
+// recomputed each time the map is redrawn as it's rotated or animated.
+
+CONST real *RgAstroGraphLine(int obj, real dec, int lat1, int lat2,
+  real dlat)
+{
+  AGL *pagl = &gi.rgagl[obj];
+  real lat, ad;
+  int cpt, ipt;
+
+  if (pagl->rgad != NULL && pagl->rDec == dec && pagl->rStep == dlat)
+    return pagl->rgad;
+  cpt = 0;
+  for (lat = (real)lat1; lat <= (real)lat2; lat += dlat)
+    cpt++;
+  if (pagl->rgad == NULL || cpt > pagl->cpt) {
+    DeallocatePIf(pagl->rgad);
+    pagl->rgad = RgAllocate(cpt, real, "astro-graph line");
+    if (pagl->rgad == NULL)
+      return NULL;
+    pagl->cpt = cpt;
+  }
+  for (ipt = 0, lat = (real)lat1; ipt < cpt; ipt++, lat += dlat) {
+    ad = RTanD(dec)*RTanD(lat);
+    pagl->rgad[ipt] = ad*ad > 1.0 ? rLarge : DFromR(RAsin(ad));
+  }
+  pagl->rDec = dec;
+  pagl->rStep = dlat;
+  return pagl->rgad;
+}
+
+
+#define latAstroGraphLo -60  // Astro-graph lines only drawn between these.
+#define latAstroGraphHi 75
+
+// Color an astro-graph world map by which house an object falls in at each
+// location, or for house cusp objects by which sign that cusp is in at each
+// location, as done with the -XH switch. The colors are either blended onto
+// the world map bitmap, or else drawn as solid areas under the map outlines.
+
+flag FDrawRelocMap(flag fBlend)
+{
+  RLS rls;
+  CI ciSav = ciCore;
+  real rgcusp[cSign+1];
+  CONST real *pr;
+  byte rgfIgnore[objMax];
+  int obj = gs.objReloc, z = gi.nScaleT, y1 = (90-latAstroGraphHi)*gi.nScale,
+    nContext = is.nContext, x, y, x0, n, n0, i;
+  flag f3D = us.fHouse3D && !FCusp(obj);
+  KV kv;
+
+  // Compute house cusps for the center of each cell within the latitudes
+  // that astro-graph lines are drawn between. Cells are single pixels,
+  // except for vector graphics with their finer coordinates.
+  rls.clon = gs.xWin / z;
+  rls.clat = ((latAstroGraphHi - latAstroGraphLo)*gi.nScale + 1) / z;
+  rls.dlon = rls.dlat = -(real)z / (real)gi.nScale;
+  rls.lon = rDegHalf + gs.rRot + rls.dlon/2.0;
+  rls.lat = (real)latAstroGraphHi + rls.dlat/2.0;
+
+  // 3D house placements depend on the object's latitude and on the sky at
+  // each location, not just on the cusps, so cast a chart at each cell for
+  // them instead of sweeping house cusps.
+  if (f3D) {
+    rls.rgcusp = NULL;
+    for (i = 0; i <= is.nObj; i++)
+      rgfIgnore[i] = (i != obj);
+  } else {
+    rls.rgcusp = RgAllocate((long)rls.clon * rls.clat * cSign, real,
+      "relocation map");
+    if (rls.rgcusp == NULL)
+      return fFalse;
+    if (!FRelocSweep(&rls)) {
+      DeallocateP(rls.rgcusp);
+      return fFalse;
+    }
+  }
+
+  // Color each row of cells, drawing runs of the same color as blocks.
+  pr = rls.rgcusp;
+  for (y = 0; y < rls.clat; y++) {
+    n0 = -1; x0 = 0;
+    for (x = 0; x <= rls.clon; x++) {
+      if (x < rls.clon) {
+        if (f3D) {
+          OO = rls.lon + rls.dlon*(real)x;
+          AA = rls.lat + rls.dlat*(real)y;
+          CastChartPart(0, rgfIgnore, cfInHouse);
+          n = inhouse[obj];
+        } else {
+          if (FCusp(obj))
+            n = SFromZ(pr[obj - cuspLo]);
+          else {
+            for (i = 1; i <= cSign; i++)
+              rgcusp[i] = pr[i-1];
+            n = NHousePlaceInCusp(planet[obj], rgcusp);
+          }
+          pr += cSign;
+        }
+        if (fBlend) {
+          kv = BmpGetXY(&gi.bmp, x, y1 + y);
+          BmpSetXY(&gi.bmp, x, y1 + y, KvBlend(kv, rgbbmp[kSignB(n)], 0.5));
+          continue;
+        }
+      } else
+        n = -1;
+      if (n != n0) {
+        if (n0 > 0) {
+          DrawColor(kSignB(n0));
+          DrawBlock(x0*z, y1 + y*z, x*z - 1, y1 + (y+1)*z - 1);
+        }
+        n0 = n; x0 = x;
+      }
+    }
+  }
+  if (f3D) {
+    ciCore = ciSav;
+    CastChart(nContext);
+  } else
+    DeallocateP(rls.rgcusp);
+  return fTrue;
+}
+
+
 // Draw an astro-graph chart on a map of the world, i.e. the draw the
 // Ascendant, Descendant, Midheaven, and Nadir lines corresponding to the
 // time in the chart. This chart is done when the -L switch is combined
@@ -146,9 +274,11 @@ void XChartAstroGraph()
   real planet1[objMax], planet2[objMax],
     end1[cObj*2+2], end2[cObj*2+2],
     symbol1[cObj*2+2], symbol2[cObj*2+2],
-    lon = Lon, longm, x, y, z, ad, oa, am, od, dm, lat;
-  int unit = gi.nScale, fVector, lat1 = -60, lat2 = 75, y1, y2, xold1, xold2,
-    xmid, i, j, k, l;
+    lon = Lon, longm, x, y, z, ad, oa, am, od, dm, lat, dlat;
+  int unit = gi.nScale, fVector, lat1 = latAstroGraphLo,
+    lat2 = latAstroGraphHi, y1, y2, xold1, xold2,
+    xmid, ipt, i, j, k, l;
+  CONST real *rgad;
 
   // Erase top and bottom parts of map. We don't draw the astro-graph lines
   // above certain latitudes, and this gives us room for glyph labels, too.
@@ -241,9 +371,13 @@ void XChartAstroGraph()
   // the Ascendant and Descendant lines here.
 
   longm = Mod(cp0.lonMC + lon);
+  dlat = 1.0/(real)(gi.nScale/gi.nScaleT);
   if (!gs.fAlt && (!ignorez[arAsc] || !ignorez[arDes]))
   for (i = 1; i <= is.nObj; i++) if (FProper(i)) {
     xold1 = xold2 = nNegative;
+    rgad = RgAstroGraphLine(i, planet2[i], lat1, lat2, dlat);
+    if (rgad == NULL)
+      continue;
 
     // Normally the Ascendant and Descendant line segments are drawn
     // simultaneously. However, for the PostScript and metafile vector
@@ -253,18 +387,14 @@ void XChartAstroGraph()
     fVector = (gs.ft == ftPS || gs.ft == ftWmf);
     for (l = 0; l <= fVector; l++)
 
-    for (lat = (real)lat1; lat <= (real)lat2;
-      lat += 1.0/(real)(gi.nScale/gi.nScaleT)) {
+    for (lat = (real)lat1, ipt = 0; lat <= (real)lat2; lat += dlat, ipt++) {
 
       // First compute and draw the current segment of Ascendant line.
 
       j = (int)((rDegQuad-lat)*(real)gi.nScale);
-      ad = RTanD(planet2[i])*RTanD(lat);
-      if (ad*ad > 1.0)
-        ad = rLarge;
-      else {
-        ad = RAsin(ad);
-        oa = planet1[i] - DFromR(ad);
+      ad = rgad[ipt];
+      if (ad != rLarge) {
+        oa = planet1[i] - ad;
         if (oa < 0.0)
           oa += rDegMax;
         am = oa - rDegQuad;
@@ -320,7 +450,7 @@ void XChartAstroGraph()
 
         // Then compute and draw corresponding segment of Descendant line.
 
-        od = planet1[i] + DFromR(ad);
+        od = planet1[i] + ad;
         dm = od + rDegQuad;
         z = longm-dm;
         if (z < 0.0)
@@ -675,6 +805,7 @@ void XChartHorizon()
   ES es;
 #ifdef CONSTEL
   int m1, n1, m2, n2, xpT, ypT;
+  LE le;
 #endif
 #ifdef SWISS
   ES *pes1, *pes2;
@@ -725,8 +856,8 @@ void XChartHorizon()
 #ifdef CONSTEL
   // Draw constellations.
   if (gs.fConstel) {
-    EnumConstelLines(NULL, NULL, NULL, NULL, NULL);
-    while (EnumConstelLines(&m1, &n1, &m2, &n2, &i)) {
+    EnumConstelLines(&le, NULL, NULL, NULL, NULL, NULL);
+    while (EnumConstelLines(&le, &m1, &n1, &m2, &n2, &i)) {
       EquToHorizon2((real)(nDegMax-m1), (real)(90-n1), x1, y1, xs, ys,
         &xp, &yp, fFlip);
       if (i <= 0) {
@@ -1080,6 +1211,7 @@ void XChartHorizonSky()
   ES es;
 #ifdef CONSTEL
   int m1, n1, m2, n2, xpT, ypT;
+  LE le;
 #endif
 #ifdef SWISS
   ES *pes1, *pes2;
@@ -1131,8 +1263,8 @@ void XChartHorizonSky()
 #ifdef CONSTEL
   // Draw constellations.
   if (gs.fConstel) {
-    EnumConstelLines(NULL, NULL, NULL, NULL, NULL);
-    while (EnumConstelLines(&m1, &n1, &m2, &n2, &i)) {
+    EnumConstelLines(&le, NULL, NULL, NULL, NULL, NULL);
+    while (EnumConstelLines(&le, &m1, &n1, &m2, &n2, &i)) {
       EquToHorizonSky2((real)(nDegMax-m1), (real)(90-n1), &cr, &xp, &yp,
         fFlip);
       if (i <= 0) {
@@ -1476,6 +1608,7 @@ void XChartTelescope()
   ES es;
 #ifdef CONSTEL
   int m1, n1, m2, n2;
+  LE le;
 #endif
 #ifdef SWISS
   ES *pes1, *pes2;
@@ -1623,8 +1756,8 @@ void XChartTelescope()
 #ifdef CONSTEL
   // Draw constellations.
   if (gs.fConstel) {
-    EnumConstelLines(NULL, NULL, NULL, NULL, NULL);
-    while (EnumConstelLines(&m1, &n1, &m2, &n2, &i)) {
+    EnumConstelLines(&le, NULL, NULL, NULL, NULL, NULL);
+    while (EnumConstelLines(&le, &m1, &n1, &m2, &n2, &i)) {
       EquToTelescope2((real)(nDegMax-m1), (real)(90-n1), &te, &xp, &yp,
         &xr, &yr, fFlip);
       if (i <= 0) {
@@ -2121,6 +2254,7 @@ void XChartLocal()
     xr, yr, xi, yi, lon, lat, len;
   flag fShowLabel, fDidBitmap;
   TELE te;
+  LE le;
   static real lonPrev = rLarge, latPrev = rLarge;
   static int objPrev = nLarge;
 
@@ -2217,8 +2351,8 @@ void XChartLocal()
 
   // Draw world map.
   if (!fDidBitmap) {
-    EnumWorldLines(NULL, NULL, NULL, NULL, NULL);
-    while (EnumWorldLines(&m1, &n1, &m2, &n2, &k)) {
+    EnumWorldLines(&le, NULL, NULL, NULL, NULL, NULL);
+    while (EnumWorldLines(&le, &m1, &n1, &m2, &n2, &k)) {
       if (k >= 0)
         DrawColor(k <= 0 ? kDkBlueB :
           (gs.fColorSign ? kRainbowB[k] : kLtGrayB));
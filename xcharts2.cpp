@@ -1067,6 +1067,36 @@ void XChartEsoteric()
 }
 
 
+// Set the current chart's time to that of a particular pixel column in a
+// graphical transit graph, given the chart the graph is centered on.
+
+void SetTransitGraphSliceX(CONST CI *pciT, int iw, int xWid, int dYea)
+{
+  int iSect = iw / xWid, iFrac = iw % xWid;
+  real rT;
+
+  ciCore = *pciT;
+  rT = (real)iFrac / (real)xWid;
+  if (!us.fInDayMonth) {
+    TT = (real)iSect + rT;
+  } else if (!us.fInDayYear) {
+    DD = iSect + 1;
+    TT = rT * 24.0;
+  } else if (us.nEphemYears <= 1) {
+    MM = iSect + 1;
+    rT *= (real)DayInMonth(MM, YY);
+    DD = (int)rT;
+    TT = RFract(rT) * 24.0;
+  } else {
+    YY = YY - dYea + iSect/12;
+    MM = (iSect % 12) + 1;
+    rT *= (real)DayInMonth(MM, YY);
+    DD = (int)rT;
+    TT = RFract(rT) * 24.0;
+  }
+}
+
+
 // Draw a chart graphing transits over time. This covers both transit to
 // transit (-B switch) and transit to natal (-V switch), when they're combined
 // with the -X switch. Each aspect present during the period has a row,
@@ -1078,14 +1108,18 @@ void XChartTransit(flag fTrans, flag fProg)
   word **ppw, *pw, *pw2;
   char sz[cchSzDef];
   int cYea, dYea, cAsp, cSect, cTot, ymin, x0, y0, x, y, asp, iw, iwFocus = -1,
-    nMax, n, obj, iy, yRow, cRow = 0, xWid, xo, yo, iSect, iFrac, xp, yp, yp2,
+    nMax, n, obj, iy, yRow, cRow = 0, xWid, xo, yo, xp, yp, yp2,
     dyp, et;
   flag fMonth = us.fInDayMonth, fYear = us.fInDayYear, fEclipse =
     us.fEclipse && !fTrans && !us.fParallel;
   CI ciT;
+  TSR tsr;
+  byte rgfIgnore[objMax];
   real rT, rPct;
+  flag fSeries = fFalse;
 
   // Initialize variables.
+  tsr.rgr = NULL;
   rgEph = (TransGraInfo *)PAllocate(sizeof(TransGraInfo),
     "transit graph grid");
   if (rgEph == NULL)
@@ -1138,42 +1172,40 @@ void XChartTransit(flag fTrans, flag fProg)
     if (iwFocus == 0 && ciT.tim <= 0.0)
       iwFocus = -1;
   }
+
+  // Each pixel column is a time slice, so there are usually far more slices
+  // than needed to interpolate the graphed objects. Sample them up front.
+  if (!fProg && !fEclipse && ciT.zon != zonLMT && ciT.zon != zonLAT) {
+    CopyRgb(fTrans ? ignore2 : ignore, rgfIgnore, sizeof(rgfIgnore));
+    for (obj = 0; obj <= is.nObj; obj++)
+      rgfIgnore[obj] |= !FProperGraph(obj);
+    SetTransitGraphSliceX(&ciT, 0, xWid, dYea);
+    rT = MdytszToJulian(MM, DD, YY, TT, SS, ZZ);
+    SetTransitGraphSliceX(&ciT, cTot-1, xWid, dYea);
+    fSeries = FEphemSeries(&tsr, rgfIgnore, rT,
+      MdytszToJulian(MM, DD, YY, TT, SS, ZZ), cTot*3/4);
+  }
+
   for (iw = 0; iw < cTot; iw++) {
-    iSect = iw / xWid; iFrac = iw % xWid;
 
     // Cast chart for current time slice.
-    ciCore = ciT;
-    rT = (real)iFrac / (real)xWid;
-    if (!fMonth) {
-      TT = (real)iSect + rT;
-    } else if (!fYear) {
-      DD = iSect + 1;
-      TT = rT * 24.0;
-    } else if (us.nEphemYears <= 1) {
-      MM = iSect + 1;
-      rT *= (real)DayInMonth(MM, YY);
-      DD = (int)rT;
-      TT = RFract(rT) * 24.0;
-    } else {
-      YY = YY - dYea + iSect/12;
-      MM = (iSect % 12) + 1;
-      rT *= (real)DayInMonth(MM, YY);
-      DD = (int)rT;
-      TT = RFract(rT) * 24.0;
-    }
-
-    if (fTrans)
-      for (obj = 0; obj <= oNorm; obj++)
-        SwapN(ignore[obj], ignore2[obj]);
-    us.fProgress = fProg;
-    if (fProg) {
-      is.JDp = MdytszToJulian(MM, DD, YY, TT, SS, ZZ);
-      ciCore = ciMain;
+    SetTransitGraphSliceX(&ciT, iw, xWid, dYea);
+    if (fSeries)
+      EphemSeriesCast(&tsr, MdytszToJulian(MM, DD, YY, TT, SS, ZZ));
+    else {
+      if (fTrans)
+        for (obj = 0; obj <= oNorm; obj++)
+          SwapN(ignore[obj], ignore2[obj]);
+      us.fProgress = fProg;
+      if (fProg) {
+        is.JDp = MdytszToJulian(MM, DD, YY, TT, SS, ZZ);
+        ciCore = ciMain;
+      }
+      CastChart(-1);
+      if (fTrans)
+        for (obj = 0; obj <= oNorm; obj++)
+          SwapN(ignore[obj], ignore2[obj]);
     }
-    CastChart(-1);
-    if (fTrans)
-      for (obj = 0; obj <= oNorm; obj++)
-        SwapN(ignore[obj], ignore2[obj]);
 
     // Compute aspects present for current time slice.
     if (!fTrans) {
@@ -1212,7 +1244,8 @@ void XChartTransit(flag fTrans, flag fProg)
 
         // Check for and add eclipse information to array too.
         if (fEclipse) {
-          et = NCheckEclipseAny(x, asp, y, &rPct);
+          et = FEclipseCatalogNone(x, asp, y, JulianDayFromTime(is.T)) ?
+            etNone : NCheckEclipseAny(x, asp, y, &rPct);
           if (et > etNone) {
             ppw = &(*rgEph)[y][x][asp];
             if (*ppw == NULL) {
@@ -1403,6 +1436,7 @@ LDone:
         }
       }
   DeallocatePIf(rgEph);
+  DeallocatePIf(tsr.rgr);
   ciCore = ciMain;
   us.fProgress = fFalse;
   CastChart(1);
@@ -70,16 +70,16 @@ GS gs = {
   fTrue, fTrue, fFalse, fFalse, fTrue, fTrue, 000000, 0, 0, 0, 0, 0, 0,
   fFalse, fTrue, fTrue, fFalse, fFalse, fFalse, fFalse, fFalse, fFalse,
   fFalse, fFalse, fFalse, fFalse, fFalse, fFalse, fTrue, fFalse, fFalse,
-  fFalse, fFalse, fFalse,
+  fFalse, fFalse, fFalse, fFalse,
   DEFAULTX, DEFAULTY,
 #ifdef WIN
   -10,
 #else
   0,
 #endif
-  200, 100, 0, 0, 0, 3, 1, 0, 0.0, 0.0, oMoo, BITMAPMODE, 25.0, 1, 0,
+  200, 100, 0, 0, 0, 3, 1, 0, 0.0, 0.0, oMoo, oSun, BITMAPMODE, 25.0, 1, 0,
   8.5, 11.0, NULL, 0, 25, 11, 1, NULL, oCore, 0.0, 1000, 0, 600,
-  1, 1, 1, 2, 2, 1, fFalse, fFalse, fTrue, 7, 0, NULL, NULL};
+  1, 1, 1, 2, 2, 1, fFalse, fFalse, fTrue, 7, 0, NULL, NULL, fFalse, 256};
 
 GI gi = {
   0, fFalse, -1,
@@ -95,7 +95,7 @@ GI gi = {
   kMagenta, fFalse, 1, DEFAULTX, DEFAULTY,
 #endif
 #ifdef X11
-  NULL, 0, 0, 0, 0, 0, 0, 0, 0,
+  NULL, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 #endif
 #ifdef PS
   fFalse, 0, fFalse, 0, -1, 1.0,
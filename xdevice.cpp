@@ -1118,7 +1118,8 @@ void EndFileX()
   if (gi.file == NULL)
     return;
   if (gs.ft == ftBmp) {
-    PrintProgress("Writing chart bitmap to file.");
+    if (gs.nAnimFrame <= 0)
+      PrintProgress("Writing chart bitmap to file.");
     if (gs.chBmpMode == 'B') {
       if (!gi.fBmp)
         WriteBmp(gi.file);
@@ -1165,6 +1166,46 @@ void EndFileX()
 }
 
 
+// Copy the bitmap in memory to a buffer of raw 24 bit RGB pixels, in which
+// form animation frames are streamed out. The buffer should be large enough
+// to contain xWin * yWin * 3 bytes.
+
+void FrameToRgb(pbyte pb)
+{
+  int x, y;
+  KV kv;
+
+  for (y = 0; y < gs.yWin; y++)
+    for (x = 0; x < gs.xWin; x++) {
+      kv = !gi.fBmp ? rgbbmp[FBmGet(gi.bm, x, y)] : _GetXY(&gi.bmp, x, y);
+      *pb++ = RgbR(kv);
+      *pb++ = RgbG(kv);
+      *pb++ = RgbB(kv);
+    }
+}
+
+
+// Given a filename, compose the filename for a particular animation frame,
+// by inserting the frame number (padded to at least four digits) before the
+// file extension, e.g. "chart.bmp" becomes "chart0001.bmp".
+
+void FrameFilename(CONST char *szFile, int ifr, char *sz)
+{
+  CONST char *pchExt = NULL, *pch;
+  int cch;
+
+  for (pch = szFile; *pch; pch++)
+    if (*pch == '.')
+      pchExt = pch;
+    else if (*pch == '/' || *pch == '\\')
+      pchExt = NULL;
+  if (pchExt == NULL)
+    pchExt = pch;
+  cch = Min((int)(pchExt - szFile), cchSzMax - 32);
+  sprintf(sz, "%.*s%04d%.20s", cch, szFile, ifr, pchExt);
+}
+
+
 #ifdef PS
 /*
 ******************************************************************************
@@ -1788,6 +1829,7 @@ void WireDrawGlobe(flag fSky, real deg)
     x, y, z, xold, yold, zold, m, n, o, u, v, w, i, j, k, l;
   real planet1[objMax], planet2[objMax], x1, y1, rT;
   ES es;
+  LE le;
 
   // Set up some variables.
   rz = Min(gs.xWin/2, gs.yWin/2);
@@ -1799,15 +1841,15 @@ void WireDrawGlobe(flag fSky, real deg)
   rT = fSky ? rDegMax - deg : deg;
 #ifdef CONSTEL
   if (fSky)
-    EnumConstelLines(NULL, NULL, NULL, NULL, NULL);
+    EnumConstelLines(&le, NULL, NULL, NULL, NULL, NULL);
   else
 #endif
-    EnumWorldLines(NULL, NULL, NULL, NULL, NULL);
+    EnumWorldLines(&le, NULL, NULL, NULL, NULL, NULL);
   while (
 #ifdef CONSTEL
-    fSky ? EnumConstelLines(&xold, &yold, &x, &y, &i) :
+    fSky ? EnumConstelLines(&le, &xold, &yold, &x, &y, &i) :
 #endif
-    EnumWorldLines(&xold, &yold, &x, &y, &i)) {
+    EnumWorldLines(&le, &xold, &yold, &x, &y, &i)) {
     if (fSky) {
       if (i > 0)
         DrawColor(gi.nMode == gSphere || !gs.fAlt ? gi.kiGray : kDkGreenB);
@@ -61,6 +61,59 @@
 ******************************************************************************
 */
 
+#ifdef X11
+// Points and lines drawn on an X11 window are queued up here, and sent to the
+// server a batch at a time with one request, instead of one request for each
+// pixel or line. The queue is flushed whenever the drawing color changes, and
+// when a chart is finished and about to be displayed.
+
+XPoint rgxpt[BATCHX];
+XSegment rgxseg[BATCHX];
+
+// Send any points and line segments queued up to the X11 server.
+
+void FlushDrawX()
+{
+  if (gi.cxpt > 0) {
+    XDrawPoints(gi.disp, gi.pmap, gi.gc, rgxpt, gi.cxpt, CoordModeOrigin);
+    gi.cxpt = 0;
+    gi.cxReq++;
+  }
+  if (gi.cxseg > 0) {
+    XDrawSegments(gi.disp, gi.pmap, gi.gc, rgxseg, gi.cxseg);
+    gi.cxseg = 0;
+    gi.cxReq++;
+  }
+}
+
+
+// Queue a single point to be drawn on the X11 window in the current color.
+
+void BatchPointX(int x, int y)
+{
+  if (gi.cxpt >= BATCHX)
+    FlushDrawX();
+  rgxpt[gi.cxpt].x = x;
+  rgxpt[gi.cxpt].y = y;
+  gi.cxpt++;
+  gi.cxPrim++;
+}
+
+
+// Queue a line segment to be drawn on the X11 window in the current color.
+
+void BatchLineX(int x1, int y1, int x2, int y2)
+{
+  if (gi.cxseg >= BATCHX)
+    FlushDrawX();
+  rgxseg[gi.cxseg].x1 = x1; rgxseg[gi.cxseg].y1 = y1;
+  rgxseg[gi.cxseg].x2 = x2; rgxseg[gi.cxseg].y2 = y2;
+  gi.cxseg++;
+  gi.cxPrim++;
+}
+#endif
+
+
 // Set the current color to use in drawing on the screen or bitmap array.
 
 void DrawColor(KI col)
@@ -90,8 +143,12 @@ void DrawColor(KI col)
 #endif
   }
 #ifdef X11
-  else
+  else {
+    // Anything queued must be drawn in the old color before switching.
+    if (gi.kiCur != col)
+      FlushDrawX();
     XSetForeground(gi.disp, gi.gc, rgbind[col]);
+  }
 #endif
 #ifdef WINANY
   else {
@@ -200,11 +257,11 @@ void DrawPoint(int x, int y)
   }
 #ifdef X11
   else {
-    XDrawPoint(gi.disp, gi.pmap, gi.gc, x, y);
+    BatchPointX(x, y);
     if (gs.fThick) {
-      XDrawPoint(gi.disp, gi.pmap, gi.gc, x+1, y);
-      XDrawPoint(gi.disp, gi.pmap, gi.gc, x, y+1);
-      XDrawPoint(gi.disp, gi.pmap, gi.gc, x+1, y+1);
+      BatchPointX(x+1, y);
+      BatchPointX(x, y+1);
+      BatchPointX(x+1, y+1);
     }
   }
 #endif
@@ -327,8 +384,10 @@ void DrawBlock(int x1, int y1, int x2, int y2)
 #endif
   }
 #ifdef X11
-  else
+  else {
     XFillRectangle(gi.disp, gi.pmap, gi.gc, x1, y1, x2-x1+1, y2-y1+1);
+    gi.cxReq++; gi.cxPrim++;
+  }
 #endif
 #ifdef WINANY
   else {
@@ -537,17 +596,17 @@ void DrawDash(int x1, int y1, int x2, int y2, int skip)
 #ifdef X11
       // For non-dashed X window lines, have the Xlib do it.
 
-      XDrawLine(gi.disp, gi.pmap, gi.gc, x1, y1, x2, y2);
+      BatchLineX(x1, y1, x2, y2);
       // Some XDrawLine implementations don't draw the last pixel.
-      XDrawPoint(gi.disp, gi.pmap, gi.gc, x2, y2);
+      BatchPointX(x2, y2);
       if (gs.fThick) {
         // Make the line thicker by drawing it four times.
-        XDrawLine(gi.disp, gi.pmap, gi.gc, x1+1, y1, x2+1, y2);
-        XDrawLine(gi.disp, gi.pmap, gi.gc, x1, y1+1, x2, y2+1);
-        XDrawLine(gi.disp, gi.pmap, gi.gc, x1+1, y1+1, x2+1, y2+1);
-        XDrawPoint(gi.disp, gi.pmap, gi.gc, x2+1, y2);
-        XDrawPoint(gi.disp, gi.pmap, gi.gc, x2, y2+1);
-        XDrawPoint(gi.disp, gi.pmap, gi.gc, x2+1, y2+1);
+        BatchLineX(x1+1, y1, x2+1, y2);
+        BatchLineX(x1, y1+1, x2, y2+1);
+        BatchLineX(x1+1, y1+1, x2+1, y2+1);
+        BatchPointX(x2+1, y2);
+        BatchPointX(x2, y2+1);
+        BatchPointX(x2+1, y2+1);
       }
 #endif
 #ifdef WINANY
@@ -839,6 +898,8 @@ void DrawArc(int x1, int y1, int x2, int y2, real rRotate, real t1, real t2)
       XDrawArc(gi.disp, gi.pmap, gi.gc, x1, y1+1, x2-x1, y2-y1, 0, i);
       XDrawArc(gi.disp, gi.pmap, gi.gc, x1+1, y1+1, x2-x1, y2-y1, 0, i);
     }
+    i = 1 + (gs.fThick ? 3 : 0);
+    gi.cxReq += i; gi.cxPrim += i;
   }
 #endif
 #ifdef WINANY
@@ -911,8 +972,10 @@ void DrawEllipse2(int x1, int y1, int x2, int y2)
 #endif
   }
 #ifdef X11
-  else
+  else {
     XFillArc(gi.disp, gi.pmap, gi.gc, x1, y1, x2-x1, y2-y1, 0, nDegMax*64);
+    gi.cxReq++; gi.cxPrim++;
+  }
 #endif
 #ifdef WINANY
   else {
@@ -1763,6 +1826,139 @@ int NFromPch(CONST char **str)
 }
 
 
+// Free all decoded turtle glyphs stored in the glyph cache.
+
+void ClearTurtleCache()
+{
+  TG *ptg, *ptgNext;
+  int i;
+
+  if (gi.rgptg == NULL)
+    return;
+  for (i = 0; i < TURTLEHASH; i++)
+    for (ptg = gi.rgptg[i]; ptg != NULL; ptg = ptgNext) {
+      ptgNext = ptg->ptgNext;
+      DeallocateP(ptg);
+    }
+  DeallocateP(gi.rgptg);
+  gi.rgptg = NULL;
+  gi.cbTurtle = 0;
+}
+
+
+// Look up a turtle draw string in the glyph cache. If it's not there yet,
+// decode it into a list of line segments at the current scale, and add it to
+// the cache, staying within the cache's memory limit. Returns NULL if the
+// string can't be cached, in which case it should be interpreted directly.
+// Strings that can't be decoded are cached too, so they're only decoded once.
+
+TG *PtgTurtle(CONST char *sz)
+{
+  int rgseg[TURTLESEG*4], cseg = 0, cch, i, x = 0, y = 0, x2, y2,
+    deltax, deltay;
+  dword lHash = 0;
+  long cb, cbMax;
+  flag fBlank, fNoupdate;
+  char chCmd;
+  CONST char *pch;
+  TG *ptg, **pptg;
+
+  // Don't bother hashing if the cache is too small to hold anything.
+  cbMax = (long)gs.nGlyphCache << 10;
+  if ((long)(TURTLEHASH*sizeof(TG *) + sizeof(TG)) > cbMax)
+    return NULL;
+
+  // Hash the string, and return the glyph if it's been decoded before.
+  for (pch = sz; *pch; pch++)
+    lHash = lHash*31 + (byte)*pch;
+  cch = (int)(pch - sz);
+  i = (int)((lHash ^ (dword)gi.nScale) % TURTLEHASH);
+  if (gi.rgptg != NULL) {
+    for (ptg = gi.rgptg[i]; ptg != NULL; ptg = ptg->ptgNext)
+      if (ptg->lHash == lHash && ptg->nScale == gi.nScale &&
+        FEqSz(ptg->sz, sz)) {
+        gi.cTurtleHit++;
+        return ptg->cseg >= 0 ? ptg : NULL;
+      }
+  }
+  gi.cTurtleMiss++;
+
+  // Decode the string into line segments the same way DrawTurtle() would.
+  pch = sz;
+  while ((chCmd = ChCap(*pch))) {
+    pch++;
+    if ((fBlank = (chCmd == 'B'))) {
+      chCmd = ChCap(*pch);
+      pch++;
+    }
+    if ((fNoupdate = (chCmd == 'N'))) {
+      chCmd = ChCap(*pch);
+      pch++;
+    }
+    switch (chCmd) {
+    case 'U': deltax =  0; deltay = -1; break;
+    case 'D': deltax =  0; deltay =  1; break;
+    case 'L': deltax = -1; deltay =  0; break;
+    case 'R': deltax =  1; deltay =  0; break;
+    case 'E': deltax =  1; deltay = -1; break;
+    case 'F': deltax =  1; deltay =  1; break;
+    case 'G': deltax = -1; deltay =  1; break;
+    case 'H': deltax = -1; deltay = -1; break;
+    default:
+      cseg = -1;    // Let DrawTurtle() report the bad character.
+    }
+    if (cseg < 0)
+      break;
+    i = NFromPch(&pch)*gi.nScale;
+    x2 = x + deltax*i;
+    y2 = y + deltay*i;
+    if (!fBlank) {
+      if (cseg >= TURTLESEG) {
+        cseg = -1;
+        break;
+      }
+      rgseg[cseg*4]   = x;  rgseg[cseg*4+1] = y;
+      rgseg[cseg*4+2] = x2; rgseg[cseg*4+3] = y2;
+      cseg++;
+      if (fNoupdate)
+        continue;
+    }
+    x = x2; y = y2;
+  }
+
+  // Make room in the cache, flushing it entirely if it would be too big.
+  cb = sizeof(TG) + Max(cseg, 0)*4*sizeof(int) + cch+1;
+  if (gi.cbTurtle + cb > cbMax)
+    ClearTurtleCache();
+  if (gi.rgptg == NULL) {
+    if ((long)(TURTLEHASH*sizeof(TG *)) + cb > cbMax)
+      return NULL;
+    pptg = RgAllocate(TURTLEHASH, TG *, "glyph cache");
+    if (pptg == NULL)
+      return NULL;
+    ClearB((pbyte)pptg, TURTLEHASH*sizeof(TG *));
+    gi.rgptg = pptg;
+    gi.cbTurtle = TURTLEHASH*sizeof(TG *);
+  }
+  ptg = (TG *)PAllocate(cb, "glyph");
+  if (ptg == NULL)
+    return NULL;
+  ptg->lHash = lHash;
+  ptg->nScale = gi.nScale;
+  ptg->cseg = cseg;
+  ptg->xEnd = x; ptg->yEnd = y;
+  ptg->rgseg = (int *)(ptg + 1);
+  CopyRgb((pbyte)rgseg, (pbyte)ptg->rgseg, Max(cseg, 0)*4*sizeof(int));
+  ptg->sz = (char *)(ptg->rgseg + Max(cseg, 0)*4);
+  CopyRgb((pbyte)sz, (pbyte)ptg->sz, cch+1);
+  i = (int)((lHash ^ (dword)gi.nScale) % TURTLEHASH);
+  ptg->ptgNext = gi.rgptg[i];
+  gi.rgptg[i] = ptg;
+  gi.cbTurtle += cb;
+  return cseg >= 0 ? ptg : NULL;
+}
+
+
 // This routine is used to draw complicated objects composed of lots of line
 // segments on the screen, such as all the glyphs and coastline pieces. It
 // is passed in a string of commands defining what to draw in relative
@@ -1772,9 +1968,18 @@ int NFromPch(CONST char **str)
 
 void DrawTurtle(CONST char *sz, int x0, int y0)
 {
-  int i, x, y, deltax, deltay;
+  int i, x, y, deltax, deltay, *pi;
   flag fBlank, fNoupdate;
   char szErr[cchSzDef], chCmd;
+  TG *ptg;
+
+  // If the glyph has been decoded before, just replay its line segments.
+  if (gs.nGlyphCache > 0 && (ptg = PtgTurtle(sz)) != NULL) {
+    for (i = 0, pi = ptg->rgseg; i < ptg->cseg; i++, pi += 4)
+      DrawLine(x0 + pi[0], y0 + pi[1], x0 + pi[2], y0 + pi[3]);
+    gi.xTurtle = x0 + ptg->xEnd; gi.yTurtle = y0 + ptg->yEnd;
+    return;
+  }
 
   gi.xTurtle = x0; gi.yTurtle = y0;
   while (chCmd = ChCap(*sz)) {
@@ -146,6 +146,7 @@ void InitColorsX()
     }
   }
   if (!gi.fFile) {
+    FlushDrawX();
     XSetBackground(gi.disp, gi.gc,   rgbind[gi.kiOff]);
     XSetForeground(gi.disp, gi.pmgc, rgbind[gi.kiOff]);
   }
@@ -766,6 +767,7 @@ void InteractX()
 
       // Make the drawn chart visible in the current screen buffer.
 #ifdef X11
+      FlushDrawX();
       XSync(gi.disp, 0);
       XCopyArea(gi.disp, gi.pmap, gi.wind, gi.gc,
         0, 0, gs.xWin, gs.yWin, 0, 0);
@@ -794,6 +796,7 @@ void InteractX()
 
       // Restore what's on window if a part of it gets uncovered.
       if (xevent.type == Expose && xevent.xexpose.count == 0) {
+        FlushDrawX();
         XSync(gi.disp, 0);
         XCopyArea(gi.disp, gi.pmap, gi.wind, gi.gc,
           0, 0, gs.xWin, gs.yWin, 0, 0);
@@ -818,6 +821,7 @@ void InteractX()
         if (xevent.xbutton.button == Button1) {
           DrawColor(gi.kiLite);
           DrawPoint(mousex, mousey);
+          FlushDrawX();
           XSync(gi.disp, 0);
           XCopyArea(gi.disp, gi.pmap, gi.wind, gi.gc,
             0, 0, gs.xWin, gs.yWin, 0, 0);
@@ -837,6 +841,7 @@ void InteractX()
       case MotionNotify:
         DrawColor(gi.kiPen);
         DrawLine(mousex, mousey, xevent.xbutton.x, xevent.xbutton.y);
+        FlushDrawX();
         XSync(gi.disp, 0);
         XCopyArea(gi.disp, gi.pmap, gi.wind, gi.gc,
           0, 0, gs.xWin, gs.yWin, 0, 0);
@@ -1572,6 +1577,18 @@ int NProcessSwitchesX(int argc, char **argv, int pos,
     SwitchF(gs.fHouseExtra);
     break;
 
+  case 'H':
+    if (argc > 1 && (i = NParseSz(argv[1], pmObject)) != -1) {
+      darg++;
+      if (FErrorValN("XH", !FValidObj(i), i, 0))
+        return tcError;
+      gs.objReloc = i;
+    }
+    SwitchF(gs.fReloc);
+    if (gs.fReloc)
+      us.fAstroGraph = fTrue;
+    break;
+
   case '1':
     if (fAnd) {
       gs.objLeft = 0;
@@ -2091,6 +2108,32 @@ int NProcessSwitchesRareX(int argc, char **argv, int pos,
     break;
 #endif
 
+  case 's':
+    SwitchF(gs.fDrawStats);
+    break;
+
+  case 'c':
+    if (FErrorArgc("YXc", argc, 1))
+      return tcError;
+    i = NFromSz(argv[1]);
+    if (FErrorValN("YXc", i < 0, i, 0))
+      return tcError;
+    gs.nGlyphCache = i;
+    ClearTurtleCache();
+    darg++;
+    break;
+
+  case 'n':
+    if (FErrorArgc("YXn", argc, 1))
+      return tcError;
+    i = NFromSz(argv[1]);
+    if (FErrorValN("YXn", i < 0, i, 0))
+      return tcError;
+    gs.nAnimFrame = i;
+    gs.fAnimRaw = (ch1 == '0');
+    darg++;
+    break;
+
   default:
     ErrorSwitch(argv[0]);
     return tcError;
@@ -2131,6 +2174,136 @@ int DetectGraphicsChartMode()
 }
 
 
+#ifdef ISG
+// Render the frames of a graphics animation headlessly, for -YXn. Starting
+// with the current chart, each frame steps forward just as each update of a
+// -Xn animation does. Frames are either written to numbered bitmap files, or
+// else for -YXn0 streamed as raw 24 bit RGB to one file, or to stdout if the
+// filename is "-". On Unix the frames are divided among worker processes,
+// with this process writing the raw stream back out in frame order.
+
+flag FAnimateFramesX()
+{
+  char sz[cchSzMax], szFile[cchSzMax], *szSav = gi.szFileOut;
+  int cfr = gs.nAnimFrame, cw, iw, ifr, mode, rgfd[cWorkerMax];
+  long cb;
+  pbyte pbFrame = NULL;
+  FILE *fileRaw = NULL;
+  real rTime = RTimer();
+  byte bAck = fTrue;
+  flag fRet = fTrue;
+
+  if (gs.ft != ftBmp || gi.szFileOut == NULL) {
+    PrintError("Animation frames can only be rendered to a bitmap file.");
+    return fFalse;
+  }
+  if (us.fNoWrite && !(gs.fAnimRaw && FEqSz(gi.szFileOut, "-")))
+    return fFalse;
+  mode = NAbs(gs.nAnim) == iAnimNow ? iAnimDay : NAbs(gs.nAnim);
+  cb = (long)gs.xWin * gs.yWin * 3;
+  if (gs.fAnimRaw) {
+    if ((pbFrame = PAllocate(cb, "frame")) == NULL)
+      return fFalse;
+    if (FEqSz(gi.szFileOut, "-"))
+      fileRaw = stdout;
+    else
+      fileRaw = fopen(gi.szFileOut, "wb");
+    if (fileRaw == NULL) {
+      PrintWarning("Couldn't open file for animation frames.");
+      DeallocateP(pbFrame);
+      return fFalse;
+    }
+  }
+  cw = NWorkerCount(cfr);
+  iw = 0;
+#ifndef PC
+  if (cw > 1 && (iw = IForkWorkers(&cw, rgfd)) < 0 && cw <= 0) {
+    cw = 1;
+    iw = 0;
+  }
+#else
+  cw = 1;
+#endif
+
+  // Each process steps through all the frames, since each time step depends
+  // on the previous one, but only draws the frames assigned to it.
+  if (iw >= 0) {
+    for (ifr = 0; ifr < cfr; ifr++) {
+      if (ifr > 0)
+        Animate(mode, gi.nDir);
+      if (ifr % cw != iw)
+        continue;
+      DrawChartX();
+      bAck = fTrue;
+      if (gs.fAnimRaw) {
+        FrameToRgb(pbFrame);
+        if (cw <= 1)
+          bAck = (fwrite(pbFrame, 1, cb, fileRaw) == (size_t)cb);
+#ifndef PC
+        else if (!FWriteWorker(rgfd[0], pbFrame, cb))
+          break;
+#endif
+      } else {
+        FrameFilename(szSav, ifr + 1, szFile);
+        gi.szFileOut = szFile;
+        gi.file = fopen(szFile, gs.chBmpMode != 'B' ? "w" : "wb");
+        if (gi.file == NULL)
+          bAck = fFalse;
+        else
+          EndFileX();
+#ifndef PC
+        if (cw > 1 && !FWriteWorker(rgfd[0], &bAck, 1))
+          break;
+#endif
+      }
+      if (!bAck)
+        break;
+    }
+#ifndef PC
+    if (cw > 1)
+      EndWorker(rgfd[0]);
+#endif
+    fRet = bAck;
+  }
+#ifndef PC
+  else {
+    // Collect the frames from the workers in order. Frame files have already
+    // been written by the workers, which just acknowledge each one.
+    for (ifr = 0; ifr < cfr; ifr++) {
+      iw = ifr % cw;
+      if (gs.fAnimRaw) {
+        if (!FReadWorker(rgfd[iw], pbFrame, cb) ||
+          fwrite(pbFrame, 1, cb, fileRaw) != (size_t)cb)
+          break;
+      } else if (!FReadWorker(rgfd[iw], &bAck, 1) || !bAck)
+        break;
+    }
+    WaitWorkers(cw, rgfd);
+    fRet = (ifr >= cfr);
+  }
+#endif
+  gi.szFileOut = szSav;
+  if (gs.fAnimRaw) {
+    if (fileRaw != stdout)
+      fclose(fileRaw);
+    else
+      fflush(stdout);
+    DeallocateP(pbFrame);
+  }
+  if (!fRet) {
+    PrintWarning("Couldn't write all animation frames.");
+    return fFalse;
+  }
+  rTime = RTimer() - rTime;
+  sprintf(sz, "Rendered %d frames in %.2f seconds (%.2f frames per second) "
+    "using %d worker%s.", cfr, rTime, (real)cfr / Max(rTime, 0.001), cw,
+    cw != 1 ? "s" : "");
+  PrintProgress(sz);
+  return fTrue;
+}
+#endif // ISG
+
+
 // This is the main interface to all the graphics features. This routine is
 // called from the main program if any of the -X switches were specified,
 // and it sets up for and goes and generates the appropriate graphics chart.
@@ -2193,7 +2366,9 @@ flag FActionX()
 #endif
 
   if (gi.fFile) {
-    if (!BeginFileX())
+    if (gs.nAnimFrame > 0 && gs.ft == ftBmp)
+      gi.file = NULL;    // Frame files are opened later as each is written.
+    else if (!BeginFileX())
       if (gs.ft == ftPS) {
         gs.ft = ftNone; gi.fFile = fFalse;
         return fFalse;
@@ -2267,10 +2442,17 @@ flag FActionX()
   }
 #endif // ISG
 
+#ifdef ISG
+  if (gi.fFile && gs.nAnimFrame > 0) {    // Render animation frames.
+    if (!FAnimateFramesX())
+      return fFalse;
+  } else
+#endif
   if (gi.fFile || gs.fRoot)    // Go draw the graphic chart.
     DrawChartX();
   if (gi.fFile) {    // Write bitmap to file if in that mode.
-    EndFileX();
+    if (gs.nAnimFrame <= 0)
+      EndFileX();
     if ((gs.ft == ftBmp && !gi.fBmp) || gs.ft == ftWmf || gs.ft == ftWire) {
       DeallocateP(gi.bm);
       gi.bm = NULL;